@@ -0,0 +1,62 @@
+# the benchmark runs on any linux system, it needs neither libpigpiod_if2 nor libmosquitto (only their headers)
+include("${CMAKE_CURRENT_SOURCE_DIR}/cmake/daemon_sources.cmake")
+
+find_library(CRYPTOPP crypto++)
+find_library(CONFIGPP config++)
+find_library(RT rt)
+# find_library(... REQUIRED) needs CMake 3.18
+foreach(library CRYPTOPP CONFIGPP RT)
+    if(NOT ${library})
+        message(FATAL_ERROR "${library} library not found")
+    endif()
+endforeach()
+
+find_package(Qt5 COMPONENTS Network SerialPort REQUIRED)
+
+set(MUONDETECTOR_BENCHMARK_SOURCE_FILES
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/benchmark/main.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/benchmark/allocationcounter.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/benchmark/eventsource.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/benchmark/gpioticksource.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/benchmark/pipelineprobe.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/benchmark/simulatedbroker.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/benchmark/simulatedpigpiod.cpp"
+    "${MUONDETECTOR_DAEMON_SRC_DIR}/benchmark/ubxstreamsource.cpp"
+    )
+
+set(MUONDETECTOR_BENCHMARK_HEADER_FILES
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/benchmark/allocationcounter.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/benchmark/eventsource.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/benchmark/gpioticksource.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/benchmark/pipelineprobe.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/benchmark/simulatedbroker.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/benchmark/simulatedpigpiod.h"
+    "${MUONDETECTOR_DAEMON_HEADER_DIR}/benchmark/ubxstreamsource.h"
+    )
+
+# the daemon without its main, running against the simulated pigpio daemon instead of libpigpiod_if2
+# and the simulated broker instead of libmosquitto
+set(MUONDETECTOR_BENCHMARK_DAEMON_SOURCE_FILES ${MUONDETECTOR_DAEMON_SOURCE_FILES})
+list(REMOVE_ITEM MUONDETECTOR_BENCHMARK_DAEMON_SOURCE_FILES "${MUONDETECTOR_DAEMON_SRC_DIR}/main.cpp")
+
+add_executable(muondetector-daemon-benchmark
+    ${MUONDETECTOR_BENCHMARK_SOURCE_FILES}
+    ${MUONDETECTOR_BENCHMARK_HEADER_FILES}
+    ${MUONDETECTOR_BENCHMARK_DAEMON_SOURCE_FILES}
+    ${MUONDETECTOR_DAEMON_HEADER_FILES})
+
+set_target_properties(muondetector-daemon-benchmark PROPERTIES POSITION_INDEPENDENT_CODE 1)
+
+target_include_directories(muondetector-daemon-benchmark PUBLIC
+    $<BUILD_INTERFACE:${MUONDETECTOR_DAEMON_HEADER_DIR}>
+    $<BUILD_INTERFACE:${LIBRARY_INCLUDE_DIR}>)
+
+target_link_libraries(muondetector-daemon-benchmark
+    Qt5::Network Qt5::SerialPort
+    crypto++
+    rt
+    config++
+    muondetector-shared
+    muondetector-shared-mqtt
+    pthread
+    )
@@ -1,112 +1,27 @@
-set(MUONDETECTOR_DAEMON_SRC_DIR "${CMAKE_CURRENT_SOURCE_DIR}/daemon/src")
-set(MUONDETECTOR_DAEMON_HEADER_DIR "${CMAKE_CURRENT_SOURCE_DIR}/daemon/include")
-set(MUONDETECTOR_DAEMON_CONFIG_DIR "${CMAKE_CURRENT_SOURCE_DIR}/daemon/config")
+include("${CMAKE_CURRENT_SOURCE_DIR}/cmake/daemon_sources.cmake")
 
 if(NOT WIN32) # added to make program editable in qt-creator on windows
 
-find_library(CRYPTOPP crypto++ REQUIRED)
-find_library(CONFIGPP config++ REQUIRED)
+find_library(CRYPTOPP crypto++)
+find_library(CONFIGPP config++)
+set(MUONDETECTOR_DAEMON_LIBRARIES CRYPTOPP CONFIGPP RT MOSQUITTO)
 if (${MUONDETECTOR_ON_RASPBERRY})
-find_library(PIGPIOD_IF2 pigpiod_if2 REQUIRED)
+find_library(PIGPIOD_IF2 pigpiod_if2)
+list(APPEND MUONDETECTOR_DAEMON_LIBRARIES PIGPIOD_IF2)
 endif ()
-find_library(RT rt REQUIRED)
-find_library(MOSQUITTO mosquitto REQUIRED)
+find_library(RT rt)
+find_library(MOSQUITTO mosquitto)
+# find_library(... REQUIRED) needs CMake 3.18
+foreach(library ${MUONDETECTOR_DAEMON_LIBRARIES})
+    if(NOT ${library})
+        message(FATAL_ERROR "${library} library not found")
+    endif()
+endforeach()
 
 endif()
 
 find_package(Qt5 COMPONENTS Network SerialPort REQUIRED)
 
-
-set(MUONDETECTOR_SPI_SOURCE_FILES
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/spi/tdc7200.cpp"
-    )
-
-set(MUONDETECTOR_I2C_SOURCE_FILES
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/Adafruit_GFX.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/adafruit_ssd1306.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/ads1115.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/bme280.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/bmp180.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/eeprom24aa02.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/hmc5883.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/lm75.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/mcp4728.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/pca9536.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/sht21.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/sht31.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/tca9546a.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/ubloxi2c.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/x9119.cpp"
-
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/hardware/i2c/i2cdevice.cpp"
-    )
-
-set(MUONDETECTOR_DAEMON_SOURCE_FILES
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/main.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/qtserialublox.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/qtserialublox_processmessages.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/pigpiodhandler.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/daemon.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/custom_io_operators.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/filehandler.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/calibration.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/gpio_mapping.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/logengine.cpp"
-    "${MUONDETECTOR_DAEMON_SRC_DIR}/utility/geohash.cpp"
-
-    "${MUONDETECTOR_I2C_SOURCE_FILES}"
-    "${MUONDETECTOR_SPI_SOURCE_FILES}"
-    )
-
-
-set(MUONDETECTOR_I2C_HEADER_FILES
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/Adafruit_GFX.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/adafruit_ssd1306.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/ads1015.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/ads1115.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/bme280.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/bmp180.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/eeprom24aa02.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/glcdfont.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/hmc5883.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/lm75.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/mcp4728.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/pca9536.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/sht21.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/sht31.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/tca9546a.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/ubloxi2c.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/x9119.h"
-
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/i2cdevice.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2c/addresses.h"
-
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/i2cdevices.h"
-    )
-
-set(MUONDETECTOR_SPI_HEADER_FILES
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/spi/tdc7200.h"
-
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/hardware/spidevices.h"
-    )
-
-set(MUONDETECTOR_DAEMON_HEADER_FILES
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/qtserialublox.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/daemon.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/pigpiodhandler.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/custom_io_operators.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/unixtime_from_gps.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/filehandler.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/calibration.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/logparameter.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/gpio_mapping.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/logengine.h"
-    "${MUONDETECTOR_DAEMON_HEADER_DIR}/utility/geohash.h"
-
-    "${MUONDETECTOR_I2C_HEADER_FILES}"
-    "${MUONDETECTOR_SPI_HEADER_FILES}"
-    )
-
 set(MUONDETECTOR_LOGIN_SOURCE_FILES
     "${MUONDETECTOR_DAEMON_SRC_DIR}/muondetector-login.cpp"
     )
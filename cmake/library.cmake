@@ -31,14 +31,17 @@ set(MUONDETECTOR_LIBRARY_HEADER_FILES
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/ublox_structs.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/muondetector_structs.h"
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/config.h"
+    "${MUONDETECTOR_LIBRARY_HEADER_DIR}/event_record.h"
     )
 
 if (MUONDETECTOR_BUILD_DAEMON)
 set(MUONDETECTOR_LIBRARY_MQTT_SOURCE_FILES
     "${MUONDETECTOR_LIBRARY_SRC_DIR}/mqtthandler.cpp"
+    "${MUONDETECTOR_LIBRARY_SRC_DIR}/mqttjournal.cpp"
     )
 set(MUONDETECTOR_LIBRARY_MQTT_HEADER_FILES
     "${MUONDETECTOR_LIBRARY_HEADER_DIR}/mqtthandler.h"
+    "${MUONDETECTOR_LIBRARY_HEADER_DIR}/mqttjournal.h"
     )
 
 add_library(muondetector-shared-mqtt OBJECT ${MUONDETECTOR_LIBRARY_MQTT_SOURCE_FILES} ${MUONDETECTOR_LIBRARY_MQTT_HEADER_FILES})
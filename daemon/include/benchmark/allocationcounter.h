@@ -0,0 +1,26 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+namespace MuonPi::Benchmark::Allocations {
+
+/**
+ * @brief Heap allocation counters of the benchmark
+ * malloc, calloc, realloc and the aligned allocation functions are interposed in the benchmark executable
+ * and forwarded to the glibc allocator,
+ * so allocations of Qt containers are counted as well as those of operator new.
+ * Threads of the benchmark itself (load generators, probe client) exclude themselves,
+ * so the counters reflect the daemon threads only.
+ */
+struct Snapshot {
+    std::uint64_t allocations { 0 };
+    std::uint64_t bytes { 0 };
+};
+
+[[nodiscard]] Snapshot snapshot();
+void excludeCurrentThread();
+
+} // namespace MuonPi::Benchmark::Allocations
+
+#endif // ALLOCATIONCOUNTER_H
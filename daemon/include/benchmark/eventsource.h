@@ -0,0 +1,53 @@
+#ifndef EVENTSOURCE_H
+#define EVENTSOURCE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace MuonPi::Benchmark {
+
+/**
+ * @brief Simulated hardware input of the benchmark
+ * A source feeds the daemon from its own thread through one of the hardware interfaces
+ * (the pigpio callback or the serial port of the u-blox module) once start() was called.
+ * The counters may be read from any thread while the source is running.
+ * Derived classes have to call stop() in their destructor, before their members are destroyed.
+ */
+class EventSource {
+public:
+    virtual ~EventSource();
+
+    [[nodiscard]] virtual std::string name() const = 0;
+
+    void start();
+    void stop();
+    [[nodiscard]] bool running() const { return m_running.load(std::memory_order_acquire); }
+
+    /**
+     * @brief injectedEvents Number of events handed to the hardware interface
+     */
+    [[nodiscard]] std::uint64_t injectedEvents() const { return m_injectedEvents.load(std::memory_order_relaxed); }
+    /**
+     * @brief injectedBytes Number of bytes handed to the hardware interface, 0 for sources which are not byte streams
+     */
+    [[nodiscard]] std::uint64_t injectedBytes() const { return m_injectedBytes.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * @brief run The body of the source thread, has to return as soon as running() is false
+     */
+    virtual void run() = 0;
+
+    std::atomic<std::uint64_t> m_injectedEvents { 0 };
+    std::atomic<std::uint64_t> m_injectedBytes { 0 };
+
+private:
+    std::atomic<bool> m_running { false };
+    std::thread m_thread {};
+};
+
+} // namespace MuonPi::Benchmark
+
+#endif // EVENTSOURCE_H
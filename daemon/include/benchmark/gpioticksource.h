@@ -0,0 +1,41 @@
+#ifndef GPIOTICKSOURCE_H
+#define GPIOTICKSOURCE_H
+
+#include "benchmark/eventsource.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace MuonPi::Benchmark {
+
+/**
+ * @brief Synthetic sequence of rising edges on the gpio inputs
+ * Every channel generates edges on one gpio pin, either with exponentially distributed intervals (a random
+ * detector signal) or at a fixed rate (e.g. the time pulse). The edges are injected into the SimulatedPigpiod
+ * at their scheduled tick. If the source falls behind, the overdue edges are injected immediately with their
+ * original ticks, so the measured latency includes the delay of the source.
+ */
+class GpioTickSource : public EventSource {
+public:
+    struct Channel {
+        unsigned int gpio;
+        double rate; // in Hz
+        bool periodic { false };
+    };
+
+    explicit GpioTickSource(std::vector<Channel> channels, std::uint64_t seed = 1);
+    ~GpioTickSource() override;
+
+    [[nodiscard]] std::string name() const override { return "gpio"; }
+
+protected:
+    void run() override;
+
+private:
+    std::vector<Channel> m_channels;
+    std::uint64_t m_seed;
+};
+
+} // namespace MuonPi::Benchmark
+
+#endif // GPIOTICKSOURCE_H
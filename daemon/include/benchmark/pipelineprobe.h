@@ -0,0 +1,61 @@
+#ifndef PIPELINEPROBE_H
+#define PIPELINEPROBE_H
+
+#include <tcpmessage.h>
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class TcpConnection;
+
+namespace MuonPi::Benchmark {
+
+/**
+ * @brief Client at the end of the daemon pipeline
+ * Connects to the tcp server of the daemon like the gui does and accounts for the received messages.
+ * For every gpio event the latency between its tick and the arrival is recorded, using the tick counter
+ * of the SimulatedPigpiod. The probe lives in its own thread, take() may be called from any thread.
+ */
+class PipelineProbe : public QObject {
+    Q_OBJECT
+public:
+    struct Result {
+        std::uint64_t messages { 0 };
+        std::uint64_t gpioEvents { 0 };
+        std::uint64_t timemarks { 0 };
+        std::vector<std::uint32_t> latencies {}; // in us
+    };
+
+    PipelineProbe(QString hostName, quint16 port, QObject* parent = nullptr);
+
+    /**
+     * @brief take Return the accounting since the last call and start over
+     */
+    Result take();
+
+signals:
+    void connected();
+    void error(const QString& message);
+
+public slots:
+    void start();
+
+private slots:
+    void onTcpMessage(TcpMessage tcpMessage);
+
+private:
+    QString m_hostName;
+    quint16 m_port;
+    QPointer<TcpConnection> m_connection {};
+    std::mutex m_mutex {};
+    Result m_result {};
+};
+
+} // namespace MuonPi::Benchmark
+
+#endif // PIPELINEPROBE_H
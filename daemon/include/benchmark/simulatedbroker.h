@@ -0,0 +1,39 @@
+#ifndef SIMULATEDBROKER_H
+#define SIMULATEDBROKER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace MuonPi::Benchmark {
+
+/**
+ * @brief Stand-in for the MQTT broker
+ * The benchmark links an implementation of the libmosquitto client functions used by the MqttHandler against
+ * this class instead of libmosquitto, so the handler runs unmodified and no network connection is made.
+ * Every connection attempt succeeds, the connect callback is invoked from the thread of the caller.
+ * Published messages are counted and discarded, subscriptions are accepted and no messages are delivered.
+ */
+class SimulatedBroker {
+public:
+    struct Snapshot {
+        std::uint64_t messages { 0 };
+        std::uint64_t bytes { 0 };
+    };
+
+    static SimulatedBroker& instance();
+
+    [[nodiscard]] Snapshot published() const;
+
+    // backend of the libmosquitto functions
+    void publish(int payloadLength);
+
+private:
+    SimulatedBroker() = default;
+
+    std::atomic<std::uint64_t> m_messages { 0 };
+    std::atomic<std::uint64_t> m_bytes { 0 };
+};
+
+} // namespace MuonPi::Benchmark
+
+#endif // SIMULATEDBROKER_H
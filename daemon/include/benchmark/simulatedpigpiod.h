@@ -0,0 +1,69 @@
+#ifndef SIMULATEDPIGPIOD_H
+#define SIMULATEDPIGPIOD_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace MuonPi::Benchmark {
+
+/**
+ * @brief Stand-in for the pigpio daemon
+ * The benchmark links an implementation of the pigpiod_if2 client functions used by the PigpiodHandler against
+ * this class instead of libpigpiod_if2, so the handler runs unmodified. Callbacks registered by the handler are
+ * invoked by inject() from the thread of the caller, just as pigpio invokes them from its notification thread.
+ * Ticks are microseconds of the steady clock since the first use and wrap around after 71 minutes.
+ * Outputs and the spi bus are accepted and ignored, spi reads return zeros (no TDC7200 present).
+ */
+class SimulatedPigpiod {
+public:
+    using Callback = void (*)(int, unsigned int, unsigned int, std::uint32_t);
+
+    static SimulatedPigpiod& instance();
+
+    /**
+     * @brief now Microseconds since the epoch of the simulated tick counter, not wrapped
+     */
+    [[nodiscard]] std::uint64_t now() const;
+    [[nodiscard]] std::chrono::steady_clock::time_point epoch() const { return m_epoch; }
+    [[nodiscard]] std::uint32_t currentTick() const { return static_cast<std::uint32_t>(now()); }
+
+    /**
+     * @brief inject Report an edge on a gpio pin to the callbacks registered for it
+     * @param level 1 for a rising, 0 for a falling edge
+     * @return false if no callback is registered for the pin and edge
+     */
+    bool inject(unsigned int gpio, unsigned int level, std::uint32_t tick);
+    [[nodiscard]] bool isRegistered(unsigned int gpio) const;
+
+    // backend of the pigpiod_if2 functions
+    int start();
+    void stop();
+    int addCallback(unsigned int gpio, unsigned int edge, Callback callback);
+    int cancelCallback(unsigned int id);
+
+    static constexpr int handle { 0 };
+    static constexpr std::size_t max_callbacks_per_gpio { 4 };
+
+private:
+    SimulatedPigpiod();
+
+    struct Registration {
+        unsigned int id;
+        unsigned int gpio;
+        unsigned int edge;
+        Callback callback;
+    };
+
+    const std::chrono::steady_clock::time_point m_epoch;
+    mutable std::mutex m_mutex {};
+    std::vector<Registration> m_callbacks {};
+    unsigned int m_nextId { 0 };
+    bool m_running { false };
+};
+
+} // namespace MuonPi::Benchmark
+
+#endif // SIMULATEDPIGPIOD_H
@@ -0,0 +1,59 @@
+#ifndef UBXSTREAMSOURCE_H
+#define UBXSTREAMSOURCE_H
+
+#include "benchmark/eventsource.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace MuonPi::Benchmark {
+
+/**
+ * @brief Replay of a recorded UBX byte stream through a pseudo terminal
+ * The daemon opens the slave side of the pty as serial port of the u-blox module, so the whole serial path
+ * (QSerialPort, framing, message decoding) is exercised. The recording is written to the master side
+ * at the given byte rate or, with a rate of 0, as fast as the daemon takes it. Bytes sent by the daemon
+ * (configuration and poll requests) are read and discarded.
+ * Injected events are the TIM-TM2 (time mark) messages of the recording which were completely written.
+ */
+class UbxStreamSource : public EventSource {
+public:
+    /**
+     * @param recording the raw bytes as received from the u-blox module
+     * @param bytesPerSecond replay rate, 0 for as fast as possible
+     * @param loop start over at the end of the recording instead of stopping
+     */
+    UbxStreamSource(std::string recording, double bytesPerSecond, bool loop = true);
+    ~UbxStreamSource() override;
+
+    /**
+     * @brief open Create the pseudo terminal
+     * @return false if the pty could not be created
+     */
+    bool open();
+    /**
+     * @brief portName The device name of the slave side, to be used as serial port of the daemon
+     */
+    [[nodiscard]] std::string portName() const { return m_portName; }
+    [[nodiscard]] std::size_t timemarksPerPass() const { return m_timemarkEnds.size(); }
+
+    [[nodiscard]] std::string name() const override { return "ubx"; }
+
+protected:
+    void run() override;
+
+private:
+    void drain();
+
+    std::string m_recording;
+    double m_bytesPerSecond;
+    bool m_loop;
+    std::vector<std::size_t> m_timemarkEnds {}; // offsets after the end of each TIM-TM2 frame in the recording
+    int m_master { -1 };
+    std::string m_portName {};
+};
+
+} // namespace MuonPi::Benchmark
+
+#endif // UBXSTREAMSOURCE_H
@@ -1,6 +1,7 @@
 #ifndef DAEMON_H
 #define DAEMON_H
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QPointF>
 #include <QPointer>
@@ -16,8 +17,14 @@
 #include "calibration.h"
 // clang-format on
 
+#include "utility/connectionmanager.h"
 #include "utility/custom_io_operators.h"
+#include "utility/name_registry.h"
+#include "utility/ratecounter.h"
 #include "histogram.h"
+#include "hardware/adcsampler.h"
+#include "hardware/adctraceengine.h"
+#include "hardware/i2cscheduler.h"
 #include "hardware/i2cdevices.h"
 #include "logengine.h"
 #include "logparameter.h"
@@ -161,6 +168,12 @@ public:
         std::array<bool, 2> polarity { true, true };
         int maxGeohashLength { MuonPi::Settings::log.max_geohash_length };
         bool storeLocal { false };
+        int gpioEventFlushWindow { MuonPi::Config::Hardware::GPIO::EventBatch::flush_window };
+        int gpioEventBatchSize { MuonPi::Config::Hardware::GPIO::EventBatch::max_events };
+        MuonPi::MqttOptions mqtt {};
+        QString ubxCaptureFile { "" }; // raw serial input of the u-blox module is written to this file if set
+        QString ubxReplayFile { "" }; // the u-blox input is replayed from this capture file instead of the serial port if set
+        bool ubxReplayUnpaced { false };
     };
 
     Daemon(configuration cfg, QObject* parent = nullptr);
@@ -202,21 +215,29 @@ public slots:
     void onGpsMonHW2Updated(const GnssMonHw2Struct& hw2);
     void receivedTcpMessage(TcpMessage tcpMessage);
     void pollAllUbxMsgRate();
-    void sendGpioPinEvent(uint8_t gpio_pin);
+    void sendGpioPinEvent(GPIO_PIN signal);
+    void onGpioEventsAvailable();
     void onGpsPropertyUpdatedGeodeticPos(const GeodeticPos& pos);
     void UBXReceivedVersion(const QString& swString, const QString& hwString, const QString& protString);
     void sampleAdc0Event();
-    void sampleAdc0TraceEvent();
     void sampleAdcEvent(uint8_t channel);
+    void onAdcPeakSampled(float value, double conversionTime);
+    void onAdcChannelSampled(quint8 channel, float value);
+    void onAdcTraceCaptured(QByteArray trace, float peak);
     void getTemperature();
     void scanI2cBus();
     void onUBXReceivedTimeTM2(const UbxTimeMarkStruct& tm);
     void onLogParameterPolled();
     void sendMqttStatus(bool connected);
+    void onMqttQueueStatus(quint32 batchedEvents, quint32 journalBatches, qint64 journalBytes, double replayRate, quint32 droppedBatches);
+    void onHistogramsSubscribed();
+    void onHistogramResyncRequired(const QString& name);
 
 signals:
     void sendTcpMessage(TcpMessage tcpMessage);
-    void closeConnection(QString closeAddress);
+    void sendHistogramMessage(TcpMessage tcpMessage, QString name, quint32 version);
+    void sendHistogramDeltaMessage(TcpMessage tcpMessage, QString name, quint32 baseVersion, quint32 version);
+    void acceptConnection(qintptr socketDescriptor);
     void logParameter(const LogParameter& log);
     void aboutToQuit();
     void sendPollUbxMsgRate(uint16_t msgID);
@@ -230,6 +251,7 @@ signals:
     void UBXSetCfgPrt(uint8_t gpsPort, uint8_t outProtocolMask);
     void UBXSetDynModel(uint8_t model);
     void resetUbxDevice(uint32_t flags);
+    void requestUbxMessageStatistics();
     void setGnssConfig(const std::vector<GnssConfigStruct>& gnssConfigs);
     void UBXSetMinMaxSVs(uint8_t minSVs, uint8_t maxSVs);
     void UBXSetMinCNO(uint8_t minCNO);
@@ -245,7 +267,13 @@ signals:
     void setSamplingTriggerSignal(GPIO_PIN signalName);
     void timeMarkIntervalCountUpdate(uint16_t newCounts, double lastInterval);
     void requestMqttConnectionStatus();
+    void requestMqttQueueStatus();
     void eventMessage(const QString& messageString);
+    void eventRecord(const MuonPi::EventRecord& record);
+    void tdcInterrupt(uint8_t gpio_pin);
+    void requestAdcPeakSample();
+    void requestAdcChannelSample(quint8 channel);
+    void startAdcTrace(quint32 generation);
 
 private slots:
     void onRateBufferReminder();
@@ -256,6 +284,7 @@ private slots:
 private:
     void incomingConnection(qintptr socketDescriptor) override;
     void setPcaChannel(uint8_t channel); // channel 0 to 3
+    void processBiasMonitoring(double v1, double v2);
         // 0: coincidence ; 1: xor ; 2: discr 1 ; 3: discr 2
     void setEventTriggerSelection(GPIO_PIN signal);
     void sendPcaChannel();
@@ -277,11 +306,12 @@ private:
     void sendI2cStats();
     void sendSpiStats();
     void sendCalib();
-    void sendHistogram(const Histogram& hist);
+    void sendHistogram(Histogram& hist);
     void sendLogInfo();
     bool readEeprom();
     void receivedCalibItems(const std::vector<CalibStruct>& newCalibs);
     void setupHistos();
+    void setupProperties();
     void rescaleHisto(Histogram& hist, double center, double width);
     void rescaleHisto(Histogram& hist, double center);
     void checkRescaleHisto(Histogram& hist, double newValue);
@@ -291,8 +321,11 @@ private:
     void printTimestamp();
     void delay(int millisecondsWait);
 
-    void rateCounterIntervalActualisation();
-    qreal getRateFromCounts(quint8 which_rate);
+    void processGpioEvent(const GpioEvent& event);
+    void queueGpioPinEvent(GPIO_PIN signal, quint64 tick, qint64 utc_ns);
+    void flushGpioEventBatch();
+    quint64 currentGpioTick() const;
+    qreal getRateFromCounts(quint8 which_rate, std::size_t window = RATE_WINDOW_DEFAULT);
     void clearRates();
 
     MCP4728* dac = nullptr;
@@ -302,6 +335,9 @@ private:
     EEPROM24AA02* eep = nullptr;
     UbloxI2c* ubloxI2c = nullptr;
     Adafruit_SSD1306* oled = nullptr;
+    // all transactions on the i2c devices above, except the adc traces, run on the bus thread of the scheduler
+    MuonPi::I2cScheduler i2cScheduler;
+    float lastTemperature = 0.;
     float biasVoltage = 0.;
     bool biasON = false;
     GPIO_PIN eventTrigger;
@@ -312,7 +348,7 @@ private:
     QPointer<PigpiodHandler> pigHandler;
     QPointer<TDC7200> tdc7200;
     bool spiDevicePresent = false;
-    QPointer<TcpConnection> tcpConnection;
+    QPointer<ConnectionManager> connectionManager;
     QMap<uint16_t, int> msgRateCfgs;
     int waitingForAppliedMsgRate = 0;
     QPointer<QtSerialUblox> qtGps;
@@ -346,28 +382,78 @@ private:
     // calibration
     ShowerDetectorCalib* calib = nullptr;
 
-    // histograms
-    QMap<QString, Histogram> histoMap;
+    // histograms, the handles are resolved once in setupHistos()
+    using HistoRegistry = MuonPi::NameRegistry<Histogram>;
+    HistoRegistry histoMap;
+    struct {
+        HistoRegistry::Handle geoHeight { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle geoLongitude { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle geoLatitude { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle weightedGeoHeight { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle pulseHeight { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle adcSampleTime { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle ubxEventLength { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle gpioEventInterval { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle gpioEventIntervalShort { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle ubxEventInterval { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle tpTimeDiff { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle tdcTimeDiff { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle biasVoltage { HistoRegistry::invalid_handle };
+        HistoRegistry::Handle biasCurrent { HistoRegistry::invalid_handle };
+    } histoHandle;
+    // transfer state of each histogram, the changed bins are tracked by the histogram itself
+    // and the version each client holds by the ConnectionManager
+    struct HistogramTransport {
+        quint32 version = 0;
+        bool fullUpdate = true; // the content differs from the last version sent without a delta
+        bool resync = false; // some clients do not hold the current version
+    };
+    QMap<QString, HistogramTransport> histoTransport;
 
     // others
     QVector<QPointF> xorRatePoints, andRatePoints;
-    timespec startOfProgram, lastRateInterval;
-    quint32 rateBufferTime = 60; // in s: 60 seconds
+    timespec startOfProgram;
     quint32 rateBufferInterval = 2000; // in ms: 2 seconds
     quint32 rateMaxShowInterval = 60 * 60 * 1000; // in ms: 1 hour
     QTimer rateBufferReminder;
     QTimer oledUpdateTimer;
-    QList<quint64> andCounts, xorCounts;
+    enum RateWindow : std::size_t {
+        RATE_WINDOW_SHORT = 0,
+        RATE_WINDOW_DEFAULT,
+        RATE_WINDOW_LONG,
+        RATE_WINDOW_COUNT
+    };
+    // the averaging windows of the rate counters, indexed by RateWindow
+    static std::vector<std::size_t> rateWindows();
+    MuonPi::RateCounter andRateCounter { rateWindows() };
+    MuonPi::RateCounter xorRateCounter { rateWindows() };
+    // extended tick of the latest gpio event and the time since it was processed,
+    // used to extrapolate the current tick when querying rates
+    quint64 lastGpioEventTick = 0;
+    QElapsedTimer lastGpioEventTimer;
+    quint64 lastTriggerTick = 0;
+    std::vector<GpioEventStruct> gpioEventBatch;
+    QTimer gpioEventFlushTimer;
     UbxDopStruct currentDOP;
     Property nrSats, nrVisibleSats, fixStatus;
     QVector<QTcpSocket*> peerList;
-    QList<float> adcSamplesBuffer;
     uint8_t adcSamplingMode = ADC_MODE_PEAK;
-    qint16 currentAdcSampleIndex = -1;
-    QTimer samplingTimer;
+    AdcTraceEngine* adcTraceEngine { nullptr };
     QTimer parameterMonitorTimer;
     QTimer rateScanTimer;
-    QMap<QString, Property> propertyMap;
+    // properties, the handles are resolved once in setupProperties()
+    using PropertyRegistry = MuonPi::NameRegistry<Property>;
+    PropertyRegistry propertyMap;
+    struct {
+        PropertyRegistry::Handle nrSats { PropertyRegistry::invalid_handle };
+        PropertyRegistry::Handle visSats { PropertyRegistry::invalid_handle };
+        PropertyRegistry::Handle usedSats { PropertyRegistry::invalid_handle };
+        PropertyRegistry::Handle maxCNR { PropertyRegistry::invalid_handle };
+        PropertyRegistry::Handle fixStatus { PropertyRegistry::invalid_handle };
+        PropertyRegistry::Handle events { PropertyRegistry::invalid_handle };
+        PropertyRegistry::Handle clkDrift { PropertyRegistry::invalid_handle };
+        PropertyRegistry::Handle clkBias { PropertyRegistry::invalid_handle };
+    } propertyHandle;
     LogEngine logEngine;
 
     // threads
@@ -376,6 +462,7 @@ private:
     QPointer<QThread> pigThread;
     QPointer<QThread> gpsThread;
     QPointer<QThread> tcpThread;
+    QPointer<QThread> adcTraceThread;
 
     configuration config;
 };
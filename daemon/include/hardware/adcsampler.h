@@ -0,0 +1,36 @@
+#ifndef ADCSAMPLER_H
+#define ADCSAMPLER_H
+
+#include <QObject>
+
+class ADS1115;
+
+namespace MuonPi {
+class I2cScheduler;
+}
+
+/**
+ * @brief Runs the ADC conversions of the daemon as high priority transactions of the i2c scheduler
+ * The daemon requests samples through the slots and receives the results through the signals, so that
+ * it does not block while the conversion is in progress. With the ready interrupt of the ADS1115 enabled,
+ * the bus thread sleeps until the ALERT/RDY pin signals the end of the conversion.
+ */
+class AdcSampler : public QObject {
+    Q_OBJECT
+public:
+    AdcSampler(ADS1115* adc, MuonPi::I2cScheduler* scheduler, QObject* parent = nullptr);
+
+signals:
+    void peakSampled(float voltage, double conversionTime); // conversionTime in ms
+    void channelSampled(quint8 channel, float voltage);
+
+public slots:
+    void samplePeak();
+    void sampleChannel(quint8 channel);
+
+private:
+    ADS1115* m_adc { nullptr };
+    MuonPi::I2cScheduler* m_scheduler { nullptr };
+};
+
+#endif // ADCSAMPLER_H
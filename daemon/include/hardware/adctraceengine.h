@@ -0,0 +1,60 @@
+#ifndef ADCTRACEENGINE_H
+#define ADCTRACEENGINE_H
+
+#include <QByteArray>
+#include <QObject>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class ADS1115;
+
+/**
+ * @brief Records pulse traces with the ADS1115 in continuous conversion mode
+ * run() blocks its thread and reads every conversion into a preallocated circular buffer until stop() is called.
+ * A trigger captures Config::Hardware::ADC::pretrigger samples before and the rest of the
+ * Config::Hardware::ADC::buffer_size samples after it. The complete trace is serialized once in this thread,
+ * ready to be appended to a MSG_ADC_TRACE message.
+ * Every start and stop request increments a generation counter, a queued run() which belongs to an older
+ * request than the latest one does nothing.
+ */
+class AdcTraceEngine : public QObject {
+    Q_OBJECT
+public:
+    explicit AdcTraceEngine(ADS1115* adc, QObject* parent = nullptr);
+
+    // thread safe, may be called from the pigpio callback
+    void trigger() { m_triggered.store(true); }
+    // thread safe, returns the generation to be passed to run()
+    [[nodiscard]] quint32 requestRun() { return ++m_generation; }
+    // thread safe, returns immediately, run() leaves the continuous mode on its own
+    void stop()
+    {
+        ++m_generation;
+        m_running.store(false);
+    }
+    [[nodiscard]] bool isRunning() const { return m_running.load(); }
+
+signals:
+    /**
+     * @brief traceCaptured
+     * @param trace number of samples (quint16) followed by the voltages (float), as written by QDataStream
+     * @param peak the maximum voltage after the trigger
+     */
+    void traceCaptured(QByteArray trace, float peak);
+
+public slots:
+    void run(quint32 generation);
+
+private:
+    void capture(std::uint64_t end);
+
+    ADS1115* m_adc { nullptr };
+    std::vector<std::int16_t> m_buffer;
+    std::atomic<bool> m_running { false };
+    std::atomic<bool> m_triggered { false };
+    std::atomic<quint32> m_generation { 0 };
+};
+
+#endif // ADCTRACEENGINE_H
@@ -3,6 +3,11 @@
 
 #include "hardware/i2c/i2cdevice.h"
 
+#include <array>
+#include <string>
+#include <vector>
+
+// the swap macro of Adafruit_GFX.h breaks standard headers included after it
 #include "hardware/i2c/Adafruit_GFX.h"
 // OLED defines
 #define OLED_I2C_RESET RPI_V2_GPIO_P1_22 /* GPIO 25 pin 12  */
@@ -80,8 +85,15 @@ public:
 
     void clearDisplay(void);
     void invertDisplay(bool inv);
+    // transfers the changed part of the buffer, the first call after begin() transfers all of it
     void display();
 
+    // text layout with cached lines: a line is given by its row below the origin and only
+    // the character cells which differ from the previously printed text are redrawn
+    // uses the current text size and color, clearDisplay() empties the cache
+    void setLineOrigin(int16_t x, int16_t y);
+    void printLine(uint8_t line, const std::string& text);
+
     void startscrollright(uint8_t start, uint8_t stop);
     void startscrollleft(uint8_t start, uint8_t stop);
 
@@ -93,11 +105,22 @@ public:
 
 private:
     uint8_t* poledbuff = nullptr; // Pointer to OLED data buffer in memory
+    uint8_t* poledshadow = nullptr; // copy of the buffer as last transferred to the display
+    std::vector<int16_t> dirtyFirst, dirtyLast; // range of columns touched since the last transfer, per page
+    bool fullRefresh = true;
+    int16_t line_origin_x = 0, line_origin_y = 0;
+    struct TextLine {
+        std::string text;
+        bool valid = false;
+    };
+    std::vector<TextLine> textLines;
     int8_t rst;
     int16_t ssd1306_lcdwidth, ssd1306_lcdheight;
+    static constexpr int16_t max_lcdwidth = 128; // widest of the supported displays
     uint8_t vcc_type;
 
     void fastI2Cwrite(uint8_t c);
-    void fastI2Cwrite(char* tbuf, uint32_t len);
+    bool fastI2Cwrite(char* tbuf, uint32_t len);
+    void markDirty(int16_t page, int16_t first, int16_t last);
 };
 #endif // !_ADAFRUIT_SSD1306_H_
@@ -3,6 +3,11 @@
 
 #include "hardware/i2c/i2cdevice.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
 // ADC ADS1x13/4/5 sampling readout delay
 #define READ_WAIT_DELAY_INIT 10
 
@@ -25,9 +30,10 @@ public:
         PGA512MV = 4,
         PGA256MV = 5 };
     static const double PGAGAINS[6];
+    static const unsigned int RATES[8]; // in samples per second
 
     ADS1115()
-        : i2cDevice("/dev/i2c-1", 0x48)
+        : i2cDevice(0x48)
     {
         init();
     }
@@ -60,7 +66,8 @@ public:
     CFG_PGA getPga(int ch) const { return fPga[ch]; }
     void setAGC(bool state) { fAGC = state; }
     bool getAGC() const { return fAGC; }
-    void setRate(unsigned int rate) { fRate = rate & 0x07; }
+    // thread safe, waits for a running conversion
+    void setRate(unsigned int rate);
     unsigned int getRate() const { return fRate; }
     bool setLowThreshold(int16_t thr);
     bool setHighThreshold(int16_t thr);
@@ -74,9 +81,25 @@ public:
     unsigned int getReadWaitDelay() const { return fReadWaitDelay; }
     double getLastConvTime() const { return fLastConvTime; }
 
+    // wait for the end of a conversion to be reported with conversionReady() instead of polling the config register
+    // requires setDataReadyPinMode() and the ALERT/RDY pin connected to an interrupt
+    void setReadyInterrupt(bool enable);
+    bool getReadyInterrupt() const { return fReadyInterrupt; }
+    // to be called from the interrupt handler of the ALERT/RDY pin, thread safe
+    void conversionReady();
+    unsigned int getNrReadyTimeouts() const { return fReadyTimeouts; }
+
+    // continuous conversion mode, single shot conversions with readADC interrupt it and resume it afterwards
+    bool startContinuous(unsigned int channel);
+    void stopContinuous();
+    bool isContinuous() const { return fContinuous; }
+    // wait for the next conversion in continuous mode and read it
+    bool readContinuous(int16_t& adc);
+    double toVoltage(unsigned int channel, int16_t adc) const { return PGAGAINS[fPga[channel & 0x03]] * adc / 32767.0; }
+
 protected:
     CFG_PGA fPga[4];
-    unsigned int fRate;
+    std::atomic<unsigned int> fRate { 0 };
     double fLastConvTime;
     unsigned int fLastADCValue;
     double fLastVoltage;
@@ -84,6 +107,22 @@ protected:
     bool fAGC; // software agc which switches over to a better pga setting if voltage too low/high
     bool fDiffMode = false; // measure differential input signals (true) or single ended (false=default)
 
+    std::mutex fConversionMutex; // serializes conversions, readADC may be called from several threads
+    std::mutex fReadyMutex;
+    std::condition_variable fReadyCondition;
+    bool fReady = false;
+    // read outside of fConversionMutex by the trace and the scheduler thread
+    std::atomic<bool> fReadyInterrupt { false };
+    std::atomic<unsigned int> fReadyTimeouts { 0 }; // total number of conversions where the ready interrupt did not arrive in time
+    std::atomic<unsigned int> fConsecutiveReadyTimeouts { 0 };
+
+    bool fContinuous = false;
+    uint8_t fContinuousConfig[3] = { 0x01, 0x00, 0x00 };
+
+    bool waitForConversion();
+    std::chrono::microseconds conversionTimeout() const;
+    void configBytes(unsigned int channel, bool singleShot, uint8_t* buf) const;
+
     inline virtual void init()
     {
         fPga[0] = fPga[1] = fPga[2] = fPga[3] = PGA4V;
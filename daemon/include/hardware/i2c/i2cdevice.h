@@ -1,6 +1,8 @@
+#include <atomic>
 #include <fcntl.h> // open
 #include <inttypes.h> // uint8_t, etc
 #include <iostream>
+#include <mutex>
 #include <stdio.h>
 #include <string>
 #include <sys/ioctl.h> // ioctl
@@ -11,6 +13,8 @@
 #ifndef _I2CDEVICE_H_
 #define _I2CDEVICE_H_
 
+#include "histogram.h"
+
 #define DEFAULT_DEBUG_LEVEL 0
 
 //We define a class named i2cDevices to outsource the hardware dependent program parts. We want to
@@ -23,6 +27,19 @@
 class i2cDevice {
 
 public:
+    // one segment of a combined transaction, consecutive segments are separated by a repeated start
+    struct Message {
+        uint8_t* buf;
+        uint16_t length;
+        bool read;
+    };
+    // a block of consecutive registers for the batched register access
+    struct RegisterBlock {
+        uint8_t reg;
+        uint16_t length;
+        uint8_t* data;
+    };
+
     enum MODE { MODE_NONE = 0,
         MODE_NORMAL = 0x01,
         MODE_FORCE = 0x02,
@@ -42,20 +59,28 @@ public:
     unsigned int getNrBytesRead() const { return fNrBytesRead; }
     unsigned int getNrBytesWritten() const { return fNrBytesWritten; }
     unsigned int getNrIOErrors() const { return fIOErrors; }
+    unsigned int getNrSyscalls() const { return fNrSyscalls; }
     static unsigned int getGlobalNrBytesRead() { return fGlobalNrBytesRead; }
     static unsigned int getGlobalNrBytesWritten() { return fGlobalNrBytesWritten; }
+    static unsigned int getGlobalNrSyscalls() { return fGlobalNrSyscalls; }
     static std::vector<i2cDevice*>& getGlobalDeviceList() { return fGlobalDeviceList; }
+    // bus of the devices constructed without one, with an empty bus no device can be opened
+    static void setDefaultBus(const std::string& busAddress) { fDefaultBus = busAddress; }
     virtual bool devicePresent();
     uint8_t getStatus() const { return fMode; }
     void lock(bool locked = true)
     {
         if (locked)
-            fMode |= MODE_LOCKED;
+            fMode.fetch_or(MODE_LOCKED);
         else
-            fMode &= ~MODE_LOCKED;
+            fMode.fetch_and(static_cast<uint8_t>(~MODE_LOCKED));
     }
 
     double getLastTimeInterval() const { return fLastTimeInterval; }
+    // distribution of the timed transactions' durations in ms, may be called from any thread
+    Histogram getLatencyHistogram() const;
+    // as above, but resets the change tracking of the histogram, so that the next call only reports the bins changed since
+    Histogram pollLatencyHistogram();
 
     void setDebugLevel(int level) { fDebugLevel = level; }
     int getDebugLevel() const { return fDebugLevel; }
@@ -75,6 +100,14 @@ public:
     //	-1 on error
     int write(uint8_t* buf, int nBytes);
 
+    // execute nMessages segments as one combined transaction (I2C_RDWR) in a single syscall
+    // return value:
+    // 	the number of segments transferred if successful
+    //	-1 on error
+    // note: adapters without support for plain i2c transfers get the segments
+    // one by one, i.e. with a stop condition in between
+    int transfer(Message* messages, int nMessages);
+
     // write nBytes bytes from buffer buf in register reg
     // return value:
     // 	the number of bytes actually written if successful
@@ -93,6 +126,11 @@ public:
     // refer to the device's datasheet
     int readReg(uint8_t reg, uint8_t* buf, int nBytes);
 
+    // batched variants of readBytes/writeBytes, all blocks are transferred in one combined transaction
+    // return value: true if all blocks were transferred completely
+    bool readBytes(RegisterBlock* blocks, int nBlocks);
+    bool writeBytes(const RegisterBlock* blocks, int nBlocks);
+
     int8_t readBit(uint8_t regAddr, uint8_t bitNum, uint8_t* data);
     int8_t readBits(uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t* data);
     bool readByte(uint8_t regAddr, uint8_t* data);
@@ -110,21 +148,37 @@ protected:
     int fHandle;
     uint8_t fAddress;
     static unsigned int fNrDevices;
-    unsigned long int fNrBytesWritten;
-    unsigned long int fNrBytesRead;
-    static unsigned long int fGlobalNrBytesRead;
-    static unsigned long int fGlobalNrBytesWritten;
+    std::atomic<unsigned long int> fNrBytesWritten { 0 };
+    std::atomic<unsigned long int> fNrBytesRead { 0 };
+    std::atomic<unsigned long int> fNrSyscalls { 0 }; // bus accesses (read, write and I2C_RDWR) issued to the kernel
+    // devices are accessed from several threads
+    static std::atomic<unsigned long int> fGlobalNrBytesRead;
+    static std::atomic<unsigned long int> fGlobalNrBytesWritten;
+    static std::atomic<unsigned long int> fGlobalNrSyscalls;
     double fLastTimeInterval; // the last time measurement's result is stored here
     struct timeval fT1, fT2;
     int fDebugLevel;
     static std::vector<i2cDevice*> fGlobalDeviceList;
+    static std::string fDefaultBus;
     std::string fTitle = "I2C device";
-    uint8_t fMode = MODE_NONE;
-    unsigned int fIOErrors = 0;
+    // not all devices are accessed through the I2cScheduler, the mode bits may be changed from several threads
+    std::atomic<uint8_t> fMode { MODE_NONE };
+    std::atomic<unsigned int> fIOErrors { 0 };
+    mutable std::mutex fLatencyMutex;
+    Histogram fLatencyHistogram;
 
     // fuctions for measuring time intervals
     void startTimer();
     void stopTimer();
+
+private:
+    enum class CombinedSupport : uint8_t { Unknown,
+        Supported,
+        Unsupported };
+    CombinedSupport fCombinedSupport = CombinedSupport::Unknown;
+
+    void initLatencyHistogram();
+    bool combinedTransfersSupported();
 };
 
 #endif // _I2CDEVICE_H_
@@ -49,11 +49,18 @@ public:
     bool setValue(uint8_t channel, uint16_t value, uint8_t gain = GAIN1, bool toEEPROM = false);
     bool writeChannel(uint8_t channel, const DacChannel& channelData);
     bool readChannel(uint8_t channel, DacChannel& channelData);
+    // read the output and eeprom registers of all four channels in one transfer
+    // eepromChannels may be nullptr if only the output registers are needed
+    bool readChannels(DacChannel* dacChannels, DacChannel* eepromChannels = nullptr);
+    // write all four channels to the output and eeprom registers with one sequential write command
+    bool storeChannels(const DacChannel* channels);
 
     static float code2voltage(const DacChannel& channelData);
 
 private:
     unsigned int fLastConvTime;
+
+    static void decodeChannel(const uint8_t* buf, DacChannel& channelData);
 };
 
 #endif //!_MCP4728_H_
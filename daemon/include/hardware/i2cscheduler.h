@@ -0,0 +1,149 @@
+#ifndef I2CSCHEDULER_H
+#define I2CSCHEDULER_H
+
+#include <QMetaObject>
+#include <QObject>
+#include <QPointer>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace MuonPi {
+
+/**
+ * @brief Owner of the i2c bus, runs device transactions in its own thread
+ * Transactions are closures which access one or more i2cDevices. They are executed one at a time,
+ * the one with the highest priority first and in submission order within a priority.
+ * A running transaction is not interrupted, so transactions should be kept short.
+ */
+class I2cScheduler {
+public:
+    enum class Priority : std::uint8_t {
+        Low, // display updates
+        Normal, // monitoring and configuration
+        High // pulse sampling
+    };
+
+    I2cScheduler();
+    ~I2cScheduler();
+
+    I2cScheduler(const I2cScheduler&) = delete;
+    I2cScheduler& operator=(const I2cScheduler&) = delete;
+
+    /**
+     * @brief submit Queue a transaction
+     * @return a future holding the result of the transaction
+     */
+    template <typename F>
+    auto submit(Priority priority, F&& work) -> std::future<std::invoke_result_t<F>>;
+
+    /**
+     * @brief post Queue a transaction and call completion with its result in the thread of context
+     * The completion is dropped if context is destroyed before.
+     */
+    template <typename F, typename C>
+    void post(Priority priority, F&& work, QObject* context, C&& completion);
+
+    /**
+     * @brief post Queue a transaction whose result is not needed
+     * The transaction must not throw.
+     */
+    template <typename F>
+    void post(Priority priority, F&& work);
+
+    /**
+     * @brief stop Finish the running transaction and stop the bus thread, pending transactions are discarded
+     */
+    void stop();
+
+    [[nodiscard]] std::size_t pending() const;
+
+private:
+    struct Transaction {
+        Priority priority;
+        std::uint64_t sequence;
+        std::function<void()> work;
+    };
+    struct Later {
+        bool operator()(const Transaction& lhs, const Transaction& rhs) const
+        {
+            if (lhs.priority != rhs.priority) {
+                return lhs.priority < rhs.priority;
+            }
+            return lhs.sequence > rhs.sequence;
+        }
+    };
+
+    void enqueue(Priority priority, std::function<void()> work);
+    void run();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::priority_queue<Transaction, std::vector<Transaction>, Later> m_queue;
+    std::uint64_t m_sequence { 0 };
+    bool m_quit { false };
+    std::thread m_thread;
+};
+
+template <typename F>
+auto I2cScheduler::submit(Priority priority, F&& work) -> std::future<std::invoke_result_t<F>>
+{
+    using Result = std::invoke_result_t<F>;
+    // std::function needs a copyable target
+    auto task { std::make_shared<std::packaged_task<Result()>>(std::forward<F>(work)) };
+    std::future<Result> result { task->get_future() };
+    enqueue(priority, [task]() { (*task)(); });
+    return result;
+}
+
+template <typename F, typename C>
+void I2cScheduler::post(Priority priority, F&& work, QObject* context, C&& completion)
+{
+    using Result = std::invoke_result_t<F>;
+    enqueue(priority, [work = std::forward<F>(work), context = QPointer<QObject> { context }, completion = std::forward<C>(completion)]() mutable {
+        if constexpr (std::is_void_v<Result>) {
+            work();
+            if (context.isNull()) {
+                return;
+            }
+            // checked again in the thread of context, where it can not be destroyed meanwhile
+            QMetaObject::invokeMethod(
+                context.data(), [context, completion]() mutable {
+                    if (!context.isNull()) {
+                        completion();
+                    }
+                },
+                Qt::QueuedConnection);
+        } else {
+            Result result { work() };
+            if (context.isNull()) {
+                return;
+            }
+            QMetaObject::invokeMethod(
+                context.data(), [context, completion, result = std::move(result)]() mutable {
+                    if (!context.isNull()) {
+                        completion(result);
+                    }
+                },
+                Qt::QueuedConnection);
+        }
+    });
+}
+
+template <typename F>
+void I2cScheduler::post(Priority priority, F&& work)
+{
+    enqueue(priority, [work = std::forward<F>(work)]() mutable { work(); });
+}
+
+} // namespace MuonPi
+
+#endif // I2CSCHEDULER_H
@@ -25,7 +25,20 @@ public slots:
     void onOnceLogTrigger() { onceLogFlag = true; }
 
 private:
+    // running aggregates of numeric parameters, updated in O(1) per sample
+    struct NumericLogData {
+        double sum { 0. };
+        double last { 0. };
+        double min { 0. };
+        double max { 0. };
+        quint64 count { 0 };
+        QString unit {};
+        int logType { LogParameter::LOG_NEVER };
+    };
+    void logNumeric(const QString& name, NumericLogData& data);
+
     QMap<QString, QVector<LogParameter>> logData;
+    QMap<QString, NumericLogData> numericLogData;
     bool onceLogFlag = true;
     int hashLength { MuonPi::Config::Log::max_geohash_length };
 };
@@ -2,6 +2,8 @@
 #define LOGPARAMETER_H
 #include <QString>
 
+#include <cmath>
+
 struct LogParameter {
 public:
     enum { LOG_NEVER = 0,
@@ -19,19 +21,55 @@ public:
         , fLogType(a_logType)
     {
     }
+    /**
+     * @brief Numeric log parameter
+     * The value is kept as a number, so the LogEngine can accumulate it without parsing strings.
+     * The text representation is only generated when needed.
+     */
+    LogParameter(const QString& a_name, double a_value, const QString& a_unit, int a_logType = LOG_AVERAGE)
+        : fName(a_name)
+        , fUnit(a_unit)
+        , fNumber(a_value)
+        , fNumeric(true)
+        , fLogType(a_logType)
+    {
+    }
 
     void setUpdatedRecently(bool updatedRecently) { updated = updatedRecently; }
     void setName(const QString& a_name) { fName = a_name; }
-    void setValue(const QString& a_value) { fValue = a_value; }
+    void setValue(const QString& a_value)
+    {
+        fValue = a_value;
+        fNumeric = false;
+    }
 
-    const QString& value() const { return fValue; }
+    QString value() const
+    {
+        if (!fNumeric) {
+            return fValue;
+        }
+        return formatNumber(fNumber, fUnit);
+    }
     const QString& name() const { return fName; }
     bool updatedRecently() const { return updated; }
     int logType() const { return fLogType; }
+    bool isNumeric() const { return fNumeric; }
+    double number() const { return fNumber; }
+    const QString& unit() const { return fUnit; }
+
+    static QString formatNumber(double a_value, const QString& a_unit)
+    {
+        // same text as the former QString::number() of the original type: integers in full, otherwise 6 significant digits
+        const bool integral { std::abs(a_value) < 9007199254740992. && a_value == std::trunc(a_value) };
+        const QString str { integral ? QString::number(static_cast<qint64>(a_value)) : QString::number(a_value) };
+        return a_unit.isEmpty() ? str : str + " " + a_unit;
+    }
 
 private:
-    QString fName, fValue;
-    bool updated;
+    QString fName, fValue, fUnit;
+    double fNumber { 0. };
+    bool fNumeric { false };
+    bool updated { false };
     int fLogType = LOG_NEVER;
 };
 
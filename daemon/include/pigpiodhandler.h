@@ -7,7 +7,10 @@
 #include <QTimer>
 #include <QVector>
 
+#include "utility/gpio_clock_model.h"
 #include "utility/gpio_mapping.h"
+#include "utility/spsc_ringbuffer.h"
+#include <config.h>
 #include <gpio_pin_definitions.h>
 
 #define XOR_RATE 0
@@ -16,6 +19,21 @@
 
 static QVector<unsigned int> DEFAULT_VECTOR;
 
+/**
+ * @brief Compact record of a single GPIO edge as seen by the pigpio callback
+ * tick is the pigpio tick (us) extended to 64bit with the tick overflow counter of the clock measurement,
+ * utc_ns the corresponding system time in ns since the unix epoch as estimated by the clock model.
+ * utc_ns is 0 as long as the clock model is not valid.
+ */
+struct GpioEvent {
+    uint64_t tick;
+    int64_t utc_ns;
+    uint8_t gpio;
+    uint8_t level;
+};
+
+using GpioEventBuffer = MuonPi::SpscRingBuffer<GpioEvent, MuonPi::Config::Hardware::GPIO::event_buffer_size>;
+
 class PigpiodHandler : public QObject {
     Q_OBJECT
 public:
@@ -26,19 +44,34 @@ public:
     QElapsedTimer elapsedEventTimer;
     GPIO_PIN samplingTriggerSignal = EVT_XOR;
 
-    double clockMeasurementSlope = 0.;
-    double clockMeasurementOffset = 0.;
     uint64_t gpioTickOverflowCounter = 0;
-    quint64 lastTimeMeasurementTick = 0;
+
+    // the conversion functions of the model may be used from any thread
+    const MuonPi::GpioClockModel& clockModel() const { return m_clockModel; }
 
     bool isInhibited() const { return inhibit; }
     void setInhibited(bool inh = true) { inhibit = inh; }
 
+    // the per-event signals (signal, eventInterval) are only emitted if the legacy mode is enabled
+    // otherwise events are delivered exclusively through the event buffer, thread safe
+    bool legacyEventSignals() const { return legacySignals.load(std::memory_order_relaxed); }
+    void setLegacyEventSignals(bool enable) { legacySignals.store(enable, std::memory_order_relaxed); }
+
+    // producer side, only to be called from the pigpio callback
+    void enqueueEvent(const GpioEvent& event);
+    // consumer side, only to be used from a single thread (the daemon)
+    GpioEventBuffer& eventBuffer() { return m_eventBuffer; }
+    // has to be called by the consumer before draining the buffer to rearm the eventsAvailable signal
+    void acknowledgeEvents() { m_eventsPending.store(false, std::memory_order_release); }
+
 signals:
     void signal(uint8_t gpio_pin);
+    // emitted once when new events arrive in the (previously acknowledged) event buffer
+    void eventsAvailable();
     void samplingTrigger();
     void eventInterval(quint64 nsecs);
     void timePulseDiff(qint32 usecs);
+    void adcConversionReady();
 
     // spi related signals
     void spiData(uint8_t reg, std::string data);
@@ -51,7 +84,7 @@ public slots:
     void setPullUp(unsigned int gpio);
     void setPullDown(unsigned int gpio);
     void setGpioState(unsigned int gpio, bool state);
-    void setSamplingTriggerSignal(GPIO_PIN signalName) { samplingTriggerSignal = signalName; }
+    void setSamplingTriggerSignal(GPIO_PIN signalName);
     void registerForCallback(unsigned int gpio, bool edge); // false=falling, true=rising
 
     // spi related slots
@@ -79,6 +112,10 @@ private:
 
     void measureGpioClockTime();
     bool inhibit = false;
+    std::atomic<bool> legacySignals { MuonPi::Config::Hardware::GPIO::legacy_event_signals };
+    GpioEventBuffer m_eventBuffer {};
+    MuonPi::GpioClockModel m_clockModel {};
+    std::atomic<bool> m_eventsPending { false };
     int verbose = 0;
 };
 
@@ -1,14 +1,23 @@
 #ifndef QTSERIALUBLOX_H
 #define QTSERIALUBLOX_H
 
+#include "utility/ubx_capture.h"
+#include "utility/ubx_framer.h"
+#include <config.h>
 #include <ublox_structs.h>
 #include <QLocale>
 #include <QObject>
 #include <QPointer>
 #include <QSerialPort>
 #include <QTimer>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <queue>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 struct GeodeticPos;
 struct GnssMonHwStruct;
@@ -37,6 +46,26 @@ public:
     explicit QtSerialUblox(const QString serialPortName, int newTimeout, int baudRate,
         bool newDumpRaw, int newVerbose, bool newShowout, bool newShowin, QObject* parent = 0);
 
+    enum class ReplaySpeed {
+        WireSpeed, // chunks are processed with the timing of the capture
+        Unpaced // chunks are processed as fast as possible
+    };
+
+    /**
+     * @brief setCaptureFile Write the raw serial input to a capture file (see MuonPi::UbxCaptureWriter)
+     * has to be called before makeConnection()
+     */
+    void setCaptureFile(const QString& fileName) { m_captureFile = fileName; }
+    /**
+     * @brief setReplayFile Read the input from a capture file instead of the serial port
+     * has to be called before makeConnection(), which then starts the replay. Outgoing messages are discarded.
+     */
+    void setReplayFile(const QString& fileName, ReplaySpeed speed = ReplaySpeed::WireSpeed)
+    {
+        m_replayFile = fileName;
+        m_replaySpeed = speed;
+    }
+
 signals:
     // all messages coming from QtSerialUblox class that should be displayed on console
     // get sent to Client thread with signal/slot mechanics
@@ -70,6 +99,8 @@ signals:
     void UBXReceivedDops(const UbxDopStruct& dops);
     void UBXReceivedTxBuf(uint8_t txUsage, uint8_t txPeakUsage);
     void UBXReceivedRxBuf(uint8_t rxUsage, uint8_t rxPeakUsage);
+    void UBXStreamErrors(quint64 checksumErrors, quint64 resyncs);
+    void replayFinished();
 
 public slots:
     // all functions that can be called from other classes through signal/slot mechanics
@@ -94,56 +125,76 @@ public slots:
     void closeAll();
 
     void ackTimeout();
+    void replayNext();
     // outPortMask is something like 1 for only UBX protocol or 0b11 for UBX and NMEA
 
     void setDynamicModel(uint8_t model);
+    // print hit counts and decoding times of all registered UBX message handlers
+    void reportMessageStatistics();
     static const std::string& getProtVersionString() { return fProtVersionString; }
     static double getProtVersion();
 
 private:
     // all functions for sending and receiving raw data used by other functions in "public slots" section
     // and scanning raw data up to the point where "UbxMessage" object is generated
-    bool scanUnknownMessage(std::string& buffer, UbxMessage& message);
     void calcChkSum(const std::string& buf, unsigned char* chkA, unsigned char* chkB);
     bool sendUBX(uint16_t msgID, const std::string& payload, uint16_t nBytes);
     bool sendUBX(uint16_t msgID, unsigned char* payload, uint16_t nBytes);
     bool sendUBX(UbxMessage& msg);
-    void sendQueuedMsg(bool afterTimeout = false);
+    void sendQueuedMsg();
+    void restartAckTimer();
+    void completePoll(uint16_t msgID);
     void delay(int millisecondsWait);
+    void ingest(const QByteArray& data);
+    void startReplay();
 
     // all functions only used for processing and showing "UbxMessage"
-    void processMessage(const UbxMessage& msg);
+    struct UbxHandler {
+        const char* name { nullptr };
+        std::size_t minLength { 0 }; // shorter payloads are rejected before decoding
+        std::function<void(std::string_view)> decode {};
+        quint64 hits { 0 };
+        quint64 shortPayloads { 0 };
+        std::chrono::nanoseconds totalTime { 0 };
+        std::chrono::nanoseconds maxTime { 0 };
+    };
+    void registerUbxHandlers();
+    void processMessage(uint16_t msgID, std::string_view payload);
+    void UBXAckNak(uint16_t ackMsgID, std::string_view msg);
     bool UBXNavClock(uint32_t& itow, int32_t& bias, int32_t& drift,
         uint32_t& tAccuracy, uint32_t& fAccuracy);
     bool UBXTimTP(uint32_t& itow, int32_t& quantErr, uint16_t& weekNr);
-    bool UBXTimTP(const std::string& msg);
-    bool UBXTimTM2(const std::string& msg);
-    std::vector<GnssSatellite> UBXNavSat(const std::string& msg, bool allSats);
-    std::vector<GnssSatellite> UBXNavSVinfo(const std::string& msg, bool allSats);
-    GeodeticPos UBXNavPosLLH(const std::string& msg);
-    void UBXCfgGNSS(const std::string& msg);
-    void UBXCfgNav5(const std::string& msg);
+    bool UBXTimTP(std::string_view msg);
+    bool UBXTimTM2(std::string_view msg);
+    std::vector<GnssSatellite> UBXNavSat(std::string_view msg, bool allSats);
+    std::vector<GnssSatellite> UBXNavSVinfo(std::string_view msg, bool allSats);
+    GeodeticPos UBXNavPosLLH(std::string_view msg);
+    void UBXCfgGNSS(std::string_view msg);
+    void UBXCfgNav5(std::string_view msg);
     std::vector<std::string> UBXMonVer();
-    void UBXNavClock(const std::string& msg);
-    void UBXNavTimeGPS(const std::string& msg);
-    void UBXNavTimeUTC(const std::string& msg);
-    void UBXNavStatus(const std::string& msg);
-    void UBXMonHW(const std::string& msg);
-    void UBXMonHW2(const std::string& msg);
-    void UBXMonTx(const std::string& msg);
-    void UBXMonRx(const std::string& msg);
-    void UBXMonVer(const std::string& msg);
-    void UBXCfgNavX5(const std::string& msg);
-    void UBXCfgAnt(const std::string& msg);
-    void UBXCfgTP5(const std::string& msg);
-    void UBXNavDOP(const std::string& msg);
+    void UBXNavClock(std::string_view msg);
+    void UBXNavTimeGPS(std::string_view msg);
+    void UBXNavTimeUTC(std::string_view msg);
+    void UBXNavStatus(std::string_view msg);
+    void UBXMonHW(std::string_view msg);
+    void UBXMonHW2(std::string_view msg);
+    void UBXMonTx(std::string_view msg);
+    void UBXMonRx(std::string_view msg);
+    void UBXMonVer(std::string_view msg);
+    void UBXCfgNavX5(std::string_view msg);
+    void UBXCfgAnt(std::string_view msg);
+    void UBXCfgTP5(std::string_view msg);
+    void UBXNavDOP(std::string_view msg);
 
     static std::string toStdString(unsigned char* data, int dataSize);
 
     // all global variables used in QtSerialUblox class until UbxMessage was created
     QPointer<QSerialPort> serialPort;
     QString _portName;
-    std::string m_buffer = "";
+    MuonPi::UbxFramer m_framer { MuonPi::Config::Hardware::Ublox::stream_buffer_size };
+    std::unordered_map<uint16_t, UbxHandler> m_ubxHandlers {};
+    quint64 m_unhandledMessages = 0;
+    quint64 m_reportedStreamErrors = 0;
     int _baudRate = 0;
     int verbose = 0;
     int timeout = 5000;
@@ -152,10 +203,27 @@ private:
     bool discardAllNMEA = true; // if true discard all NMEA messages and do not parse them
     bool showout = false; // if true show the ubx messages sent to the gps board as hex
     bool showin = false;
+    // messages which were sent but not yet acknowledged, in the order of sending.
+    // The receiver handles commands in order, so ACKs for the same msgID arrive in FIFO order,
+    // while ACKs for different msgIDs are matched independently.
+    struct PendingCommand {
+        UbxMessage msg {};
+        std::chrono::steady_clock::time_point deadline {};
+        int retries { 0 };
+    };
     std::queue<UbxMessage> outMsgBuffer;
-    UbxMessage* msgWaitingForAck = nullptr;
+    std::deque<PendingCommand> m_inFlight {};
     QPointer<QTimer> ackTimer;
-    int sendRetryCounter = 0;
+
+    QString m_captureFile {};
+    std::unique_ptr<MuonPi::UbxCaptureWriter> m_capture {};
+    QString m_replayFile {};
+    ReplaySpeed m_replaySpeed { ReplaySpeed::WireSpeed };
+    std::unique_ptr<MuonPi::UbxCaptureReader> m_replay {};
+    MuonPi::UbxCaptureReader::Chunk m_replayChunk {};
+    bool m_replayPending { false };
+    std::chrono::steady_clock::time_point m_replayStart {};
+    QPointer<QTimer> m_replayTimer;
 
     // all global variables used for keeping track of satellites and statistics (gpsProperty)
     gpsProperty<int> leapSeconds;
@@ -0,0 +1,87 @@
+#ifndef CONNECTIONMANAGER_H
+#define CONNECTIONMANAGER_H
+
+#include "tcpconnection.h"
+#include "tcpmessage.h"
+#include "tcpmessage_keys.h"
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+
+/**
+ * @brief Serves any number of tcp clients (gui, monitoring) from one thread
+ * Messages of the daemon are passed on to every client which subscribed to the group of the message,
+ * see TcpMessageGroup. Messages from the clients are forwarded, except for the subscription and quit
+ * messages, which are handled here for the sending client.
+ * Histograms are sent as full histograms and as deltas between two versions. The version each client holds
+ * is tracked here, so a client only receives deltas against a version it has and gets the full histogram
+ * when it subscribes or falls out of sync.
+ */
+class ConnectionManager : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ConnectionManager(int verbose = 0, QObject* parent = nullptr);
+
+    /**
+     * @brief isSubscribed Check if any client receives the given message group(s)
+     * Safe to call from other threads, used to skip building messages nobody receives.
+     */
+    [[nodiscard]] bool isSubscribed(quint32 groups) const { return (m_subscribedGroups.load() & groups) != 0; }
+    [[nodiscard]] int clientCount() const { return m_clientCount.load(); }
+
+signals:
+    void receivedTcpMessage(TcpMessage tcpMessage);
+    void toConsole(QString data);
+    void madeConnection(QString remotePeerAddress, quint16 remotePeerPort, QString localAddress, quint16 localPort);
+    void connectionTimeout(QString remotePeerAddress, quint16 remotePeerPort, QString localAddress, quint16 localPort,
+        quint32 timeoutTime, quint32 connectionDuration);
+    void finished();
+    /**
+     * @brief histogramsSubscribed A client subscribed to the histograms and needs all of them in full
+     */
+    void histogramsSubscribed();
+    /**
+     * @brief histogramResyncRequired At least one client does not hold the current version of the histogram
+     */
+    void histogramResyncRequired(QString name);
+
+public slots:
+    void addConnection(qintptr socketDescriptor);
+    void sendTcpMessage(TcpMessage tcpMessage);
+    /**
+     * @brief sendHistogram Send a full histogram of the given version to every subscribed client which does not hold it
+     */
+    void sendHistogram(TcpMessage tcpMessage, QString name, quint32 version);
+    /**
+     * @brief sendHistogramDelta Send a histogram delta to every subscribed client which holds baseVersion
+     */
+    void sendHistogramDelta(TcpMessage tcpMessage, QString name, quint32 baseVersion, quint32 version);
+    /**
+     * @brief closeAll Close all client connections and emit finished once they are closed
+     */
+    void closeAll();
+
+private slots:
+    void onReceivedTcpMessage(TcpMessage tcpMessage);
+
+private:
+    struct Client {
+        quint32 groups { TcpMessageGroup::ALL }; // subscribed message groups
+        QHash<QString, quint32> histogramVersions {}; // histogram name and the last version sent
+    };
+
+    void removeConnection(TcpConnection* connection);
+    void updateSubscriptions();
+
+    int m_verbose { 0 };
+    QHash<TcpConnection*, Client> m_clients {};
+    std::atomic<quint32> m_subscribedGroups { 0 };
+    std::atomic<int> m_clientCount { 0 };
+    bool m_closing { false };
+};
+
+#endif // CONNECTIONMANAGER_H
@@ -9,12 +9,15 @@
 #include <QStandardPaths>
 #include <QVector>
 #include "logparameter.h"
+#include <event_record.h>
+#include <vector>
 
 class FileHandler : public QObject {
     Q_OBJECT
 
 public:
     FileHandler(const QString& userName, const QString& passWord, quint32 fileSizeMB = 500, QObject* parent = nullptr);
+    ~FileHandler() override;
     QString getCurrentDataFileName() const;
     QString getCurrentLogFileName() const;
     QFileInfo dataFileInfo() const;
@@ -28,11 +31,12 @@ signals:
 
 public slots:
     void start();
-    void writeToDataFile(const QString& data); // writes data to the file opened in "dataFile"
+    void writeEventRecord(const MuonPi::EventRecord& record); // appends a binary event record to the file opened in "dataFile"
     void writeToLogFile(const QString& log); // writes log data to the file opened in "logFile"
 
 private slots:
     void onUploadRemind();
+    void onSyncRemind();
 
 private:
     // save and send data everyday
@@ -54,10 +58,19 @@ private:
     bool openFiles(bool writeHeader = false); // reads the config file and opens the correct data file to write to
     bool readFileInformation();
     bool uploadDataFile(QString fileName); // sends a data file with some filename via lftp script to the server
+    // writes the event records of a binary data file in the former text format, which the server expects
+    // returns false if the file is not an event record file or could not be converted
+    bool convertDataFileToText(const QString& binaryPath, const QString& textPath);
     bool uploadRecentDataFiles();
     bool switchFiles(QString fileName = ""); // closes the old file and opens a new one, changing "dataConfig.conf" to the new file
     bool writeConfigFile();
     void closeFiles();
+    bool hasEventRecordHeader();
+    // writes the buffered event records to the data file, with sync also to the storage medium
+    void flushEventBuffer(bool sync = false);
+    std::vector<char> m_eventBuffer {};
+    std::size_t m_eventBufferFill { 0 };
+    bool m_dataUnsynced { false }; // data was written to the file since the last fdatasync
     QString createFileName(); // creates a fileName based on date time and mac address
     quint32 fileSize; // in MB
     QDateTime lastUploadDateTime;
@@ -0,0 +1,130 @@
+#ifndef GPIO_CLOCK_MODEL_H
+#define GPIO_CLOCK_MODEL_H
+
+#include <config.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MuonPi {
+
+/**
+ * @brief Linear model of the system clock (UTC) as function of the pigpio tick
+ * The offset y = utc_ns - 1000 * tick is fitted with a least squares line over a sliding window of
+ * measurements. Sums are kept as means and co-moments, which are updated when a sample enters or leaves
+ * the window, so an update costs O(1). After each turnover of the window they are recomputed from the
+ * stored samples around a new origin, so that rounding errors can not accumulate.
+ * Samples deviating from the model by more than Config::Hardware::GPIO::Clock::Measurement::outlier_threshold
+ * standard deviations are rejected. A series of rejected samples is taken as a step of the system clock
+ * and restarts the model.
+ *
+ * addSample has to be called from a single thread. The conversion functions are thread safe and can be used
+ * from the pigpio callback: the fitted coefficients are published into a small ring of snapshots, each guarded
+ * by a sequence counter (seqlock). Readers take no lock and copy the latest snapshot; they only retry if the writer
+ * wrapped around the ring and overwrote that snapshot during the copy.
+ */
+class GpioClockModel {
+public:
+    explicit GpioClockModel(std::size_t window = Config::Hardware::GPIO::Clock::Measurement::buffer_size);
+
+    /**
+     * @brief addSample Add a simultaneous measurement of tick and system time
+     * @param tick the pigpio tick (us) extended to 64bit
+     * @param utc_ns the system time in ns since the unix epoch
+     * @return false if the sample was rejected as outlier
+     */
+    bool addSample(std::uint64_t tick, std::int64_t utc_ns);
+    void reset();
+
+    /**
+     * @brief valid True if enough samples were collected for a meaningful conversion
+     */
+    [[nodiscard]] bool valid() const;
+    /**
+     * @brief toUtcNs Convert an extended tick to ns since the unix epoch
+     * @return 0 if the model is not valid yet
+     */
+    [[nodiscard]] std::int64_t toUtcNs(std::uint64_t tick) const;
+    /**
+     * @brief extend Extend a raw 32bit pigpio tick to 64bit, choosing the wrap-around epoch closest
+     * to the latest sample of the model. Valid for ticks within +-35 minutes of the latest sample.
+     */
+    [[nodiscard]] std::uint64_t extend(std::uint32_t tick) const;
+    /**
+     * @brief uncertainty The standard deviation of the conversion at the latest sample, in ns
+     */
+    [[nodiscard]] double uncertainty() const;
+    /**
+     * @brief drift The rate deviation of the tick clock against the system clock, in ppm
+     */
+    [[nodiscard]] double drift() const;
+    [[nodiscard]] std::size_t rejectedSamples() const;
+
+private:
+    struct Sample {
+        std::uint64_t tick;
+        std::int64_t offset; // utc_ns - 1000 * tick
+    };
+
+    struct Coefficients {
+        std::uint64_t originTick { 0 };
+        std::int64_t originOffset { 0 };
+        double intercept { 0. }; // offset at the origin, relative to originOffset
+        double slope { 0. }; // ns per tick
+        double uncertainty { 0. };
+        std::uint64_t latestTick { 0 };
+        bool valid { false };
+    };
+
+    // one published set of coefficients, the fields are atomics so that a torn read is detected rather than undefined
+    struct PublishedCoefficients {
+        std::atomic<std::uint32_t> sequence { 0 }; // odd while being written
+        std::atomic<std::uint64_t> originTick { 0 };
+        std::atomic<std::int64_t> originOffset { 0 };
+        std::atomic<double> intercept { 0. };
+        std::atomic<double> slope { 0. };
+        std::atomic<double> uncertainty { 0. };
+        std::atomic<std::uint64_t> latestTick { 0 };
+        std::atomic<bool> valid { false };
+
+        void store(const Coefficients& coefficients);
+        // false if the snapshot was modified during the read
+        [[nodiscard]] bool load(Coefficients& coefficients) const;
+    };
+    static constexpr std::size_t published_slots { 4 };
+
+    void add(double x, double y);
+    void remove(double x, double y);
+    void rebase();
+    void publish();
+    void publish(const Coefficients& coefficients);
+    [[nodiscard]] Coefficients published() const;
+    [[nodiscard]] double residualSigma() const;
+
+    std::vector<Sample> m_samples {};
+    std::size_t m_next { 0 };
+    std::size_t m_count { 0 };
+    std::size_t m_sinceRebase { 0 };
+    std::size_t m_consecutiveOutliers { 0 };
+    std::size_t m_rejected { 0 };
+
+    // running statistics relative to the origin
+    std::uint64_t m_originTick { 0 };
+    std::int64_t m_originOffset { 0 };
+    double m_meanX { 0. };
+    double m_meanY { 0. };
+    double m_sxx { 0. };
+    double m_sxy { 0. };
+    double m_syy { 0. };
+
+    Coefficients m_current {}; // the latest published coefficients, only used by the writer
+    std::array<PublishedCoefficients, published_slots> m_published {};
+    std::atomic<std::size_t> m_publishedIndex { 0 };
+};
+
+} // namespace MuonPi
+
+#endif // GPIO_CLOCK_MODEL_H
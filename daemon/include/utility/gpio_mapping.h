@@ -1,6 +1,9 @@
 #ifndef GPIO_MAPPING_H
 #define GPIO_MAPPING_H
 #include <gpio_pin_definitions.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <map>
 
 #define MAX_HW_VER 3
@@ -11,71 +14,138 @@
 // TO MAKE IT MORE SIMPLE THERE WILL BE ONLY PIGPIO NAMING STANDARD,
 // NO WIRING PI FROM NOW
 
+struct GpioPinAssignment {
+    GPIO_PIN signal { UNDEFINED_PIN };
+    unsigned int bcm { 0 };
+};
+
+/* Pin mapping, HW Version 0, proxy to be never used nor initializing something */
+static constexpr std::array<GpioPinAssignment, 0> GPIO_PIN_ASSIGNMENTS_V0 {};
+
+/* Pin mapping, HW Version 1 */
+static constexpr std::array<GpioPinAssignment, 14> GPIO_PIN_ASSIGNMENTS_V1 { {
+    { UBIAS_EN, 4 },
+    { PREAMP_1, 20 },
+    { PREAMP_2, 21 },
+    { EVT_AND, 5 },
+    { EVT_XOR, 6 },
+    { GAIN_HL, 17 },
+    { ADC_READY, 23 },
+    { TIMEPULSE, 18 },
+    { STATUS1, 13 },
+    { STATUS2, 19 },
+    { STATUS3, 26 },
+    { TDC_INTB, 20 },
+    { TDC_STATUS, 21 },
+    { EXT_TRIGGER, 21 } } };
+
+/* Pin mapping, HW Version 2 */
+static constexpr std::array<GpioPinAssignment, 15> GPIO_PIN_ASSIGNMENTS_V2 { {
+    { UBIAS_EN, 26 },
+    { PREAMP_1, 4 },
+    { PREAMP_2, 17 },
+    { EVT_AND, 22 },
+    { EVT_XOR, 27 },
+    { GAIN_HL, 6 },
+    { ADC_READY, 12 },
+    { TIMEPULSE, 18 },
+    { TIME_MEAS_OUT, 5 },
+    { STATUS1, 13 },
+    { STATUS2, 19 },
+    { PREAMP_FAULT, 23 },
+    { TDC_INTB, 20 },
+    { TDC_STATUS, 21 },
+    { EXT_TRIGGER, 16 } } };
+
+/* Pin mapping, HW Version 3 */
+static constexpr std::array<GpioPinAssignment, 17> GPIO_PIN_ASSIGNMENTS_V3 { {
+    { UBIAS_EN, 26 },
+    { PREAMP_1, 4 },
+    { PREAMP_2, 17 },
+    { EVT_AND, 22 },
+    { EVT_XOR, 27 },
+    { GAIN_HL, 6 },
+    { ADC_READY, 12 },
+    { TIMEPULSE, 18 },
+    { TIME_MEAS_OUT, 5 },
+    { STATUS1, 13 },
+    { STATUS2, 19 },
+    { PREAMP_FAULT, 23 },
+    { TDC_INTB, 20 },
+    { TDC_STATUS, 21 },
+    { EXT_TRIGGER, 16 },
+    { IN_POL1, 24 },
+    { IN_POL2, 25 } } };
+
+template <std::size_t N>
+std::map<GPIO_PIN, unsigned int> makeGpioPinMap(const std::array<GpioPinAssignment, N>& assignments)
+{
+    std::map<GPIO_PIN, unsigned int> pinmap {};
+    for (const auto& assignment : assignments) {
+        pinmap.emplace(assignment.signal, assignment.bcm);
+    }
+    return pinmap;
+}
+
 static const std::map<GPIO_PIN, unsigned int> GPIO_PINMAP_VERSIONS[MAX_HW_VER + 1] = {
-    {
-        /* Pin mapping, HW Version 0, proxy to be never used nor initializing something */
-    },
-    { /* Pin mapping, HW Version 1 */
-        { UBIAS_EN, 4 },
-        { PREAMP_1, 20 },
-        { PREAMP_2, 21 },
-        { EVT_AND, 5 },
-        { EVT_XOR, 6 },
-        { GAIN_HL, 17 },
-        { ADC_READY, 23 },
-        { TIMEPULSE, 18 },
-        { STATUS1, 13 },
-        { STATUS2, 19 },
-        { STATUS3, 26 },
-        { TDC_INTB, 20 },
-        { TDC_STATUS, 21 },
-        { EXT_TRIGGER, 21 } },
-    { /* Pin mapping, HW Version 2 */
-        { UBIAS_EN, 26 },
-        { PREAMP_1, 4 },
-        { PREAMP_2, 17 },
-        { EVT_AND, 22 },
-        { EVT_XOR, 27 },
-        { GAIN_HL, 6 },
-        { ADC_READY, 12 },
-        { TIMEPULSE, 18 },
-        { TIME_MEAS_OUT, 5 },
-        { STATUS1, 13 },
-        { STATUS2, 19 },
-        { PREAMP_FAULT, 23 },
-        { TDC_INTB, 20 },
-        { TDC_STATUS, 21 },
-        { EXT_TRIGGER, 16 } },
-    { /* Pin mapping, HW Version 3 */
-        { UBIAS_EN, 26 },
-        { PREAMP_1, 4 },
-        { PREAMP_2, 17 },
-        { EVT_AND, 22 },
-        { EVT_XOR, 27 },
-        { GAIN_HL, 6 },
-        { ADC_READY, 12 },
-        { TIMEPULSE, 18 },
-        { TIME_MEAS_OUT, 5 },
-        { STATUS1, 13 },
-        { STATUS2, 19 },
-        { PREAMP_FAULT, 23 },
-        { TDC_INTB, 20 },
-        { TDC_STATUS, 21 },
-        { EXT_TRIGGER, 16 },
-        { IN_POL1, 24 },
-        { IN_POL2, 25 } }
+    makeGpioPinMap(GPIO_PIN_ASSIGNMENTS_V0),
+    makeGpioPinMap(GPIO_PIN_ASSIGNMENTS_V1),
+    makeGpioPinMap(GPIO_PIN_ASSIGNMENTS_V2),
+    makeGpioPinMap(GPIO_PIN_ASSIGNMENTS_V3)
 };
 
 extern std::map<GPIO_PIN, unsigned int> GPIO_PINMAP;
 
+// number of user gpios which can be registered for callbacks with pigpio (BCM 0..31)
+constexpr unsigned int GPIO_BCM_PIN_COUNT { 32 };
+// number of defined signals in the GPIO_PIN enum (excluding UNDEFINED_PIN)
+constexpr unsigned int GPIO_SIGNAL_COUNT { IN_POL2 + 1 };
+
+/**
+ * @brief Role of a single BCM pin, as resolved from the current pin mapping
+ * signal is the GPIO_PIN with the lowest enum value assigned to this pin (same as the
+ * first occurence in GPIO_PINMAP), flags mark the roles relevant for event processing
+ */
+struct GpioPinInfo {
+    enum Flags : std::uint8_t {
+        SAMPLING_TRIGGER = 0x01,
+        TIMEPULSE_SIGNAL = 0x02,
+        RATE_XOR = 0x04,
+        RATE_AND = 0x08,
+        TDC_INTERRUPT = 0x10,
+        ADC_READY_SIGNAL = 0x20
+    };
+    GPIO_PIN signal { UNDEFINED_PIN };
+    std::uint8_t flags { 0 };
+};
+
+using GpioPinTable = std::array<GpioPinInfo, GPIO_BCM_PIN_COUNT>;
+
+/**
+ * @brief The currently active lookup table
+ * All possible tables (hardware version x sampling trigger signal) are generated at compile time,
+ * switching the mapping only swaps this pointer, so readers always see a consistent table.
+ */
+extern std::atomic<const GpioPinTable*> GPIO_PIN_TABLE;
+
+/**
+ * @brief gpioPinInfo Look up the role of a BCM pin with a single indexed load
+ * safe to be called from the pigpio callback thread
+ */
+inline GpioPinInfo gpioPinInfo(unsigned int bcmGpioNumber)
+{
+    if (bcmGpioNumber >= GPIO_BCM_PIN_COUNT) {
+        return GpioPinInfo {};
+    }
+    return (*GPIO_PIN_TABLE.load(std::memory_order_acquire))[bcmGpioNumber];
+}
+
+void setGpioHardwareVersion(unsigned int hwVersion);
+void setGpioSamplingTrigger(GPIO_PIN samplingTrigger);
+
 inline GPIO_PIN bcmToGpioSignal(unsigned int bcmGpioNumber)
 {
-    std::map<GPIO_PIN, unsigned int>::const_iterator i = GPIO_PINMAP.cbegin();
-    while (i != GPIO_PINMAP.cend() && i->second != bcmGpioNumber)
-        ++i;
-    if (i == GPIO_PINMAP.cend())
-        return UNDEFINED_PIN;
-    return i->first;
+    return gpioPinInfo(bcmGpioNumber).signal;
 }
 
 #endif //GPIO_MAPPING_H
@@ -0,0 +1,78 @@
+#ifndef NAME_REGISTRY_H
+#define NAME_REGISTRY_H
+
+#include <QHash>
+#include <QString>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace MuonPi {
+
+/**
+ * @brief Registry of named objects, addressable by small integer handles
+ * Names are resolved to handles once, when the objects are registered (e.g. at startup).
+ * Hot paths keep the handle and index the dense storage directly, only code dealing with
+ * names coming from outside (network requests, log output) uses the name lookup.
+ * Handles stay valid for the lifetime of the registry, entries are never removed.
+ */
+template <typename T>
+class NameRegistry {
+public:
+    using Handle = std::size_t;
+    static constexpr Handle invalid_handle { std::numeric_limits<Handle>::max() };
+
+    /**
+     * @brief insert Register an object under the given name
+     * If the name is already registered, the object is replaced and the existing handle is returned.
+     */
+    Handle insert(const QString& name, const T& value = T {})
+    {
+        auto it = m_index.constFind(name);
+        if (it != m_index.constEnd()) {
+            m_values[it.value()] = value;
+            return it.value();
+        }
+        const Handle handle { m_values.size() };
+        m_values.push_back(value);
+        m_names.push_back(name);
+        m_index.insert(name, handle);
+        return handle;
+    }
+
+    [[nodiscard]] Handle handle(const QString& name) const
+    {
+        return m_index.value(name, invalid_handle);
+    }
+    [[nodiscard]] bool contains(const QString& name) const { return m_index.contains(name); }
+    [[nodiscard]] const QString& name(Handle handle) const { return m_names[handle]; }
+    [[nodiscard]] std::size_t size() const { return m_values.size(); }
+
+    T& operator[](Handle handle) { return m_values[handle]; }
+    const T& operator[](Handle handle) const { return m_values[handle]; }
+
+    /**
+     * @brief find Look up an object by name
+     * @return nullptr if no object is registered under this name
+     */
+    T* find(const QString& name)
+    {
+        const Handle h { handle(name) };
+        return (h == invalid_handle) ? nullptr : &m_values[h];
+    }
+
+    typename std::vector<T>::iterator begin() { return m_values.begin(); }
+    typename std::vector<T>::iterator end() { return m_values.end(); }
+    typename std::vector<T>::const_iterator begin() const { return m_values.begin(); }
+    typename std::vector<T>::const_iterator end() const { return m_values.end(); }
+
+private:
+    std::vector<T> m_values {};
+    std::vector<QString> m_names {};
+    QHash<QString, Handle> m_index {};
+};
+
+} // namespace MuonPi
+
+#endif // NAME_REGISTRY_H
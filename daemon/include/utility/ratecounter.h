@@ -0,0 +1,59 @@
+#ifndef RATECOUNTER_H
+#define RATECOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MuonPi {
+
+/**
+ * @brief Event rate counter on hardware ticks
+ * Counts are accumulated in fixed-width bins (default: 1s of 1us pigpio ticks) kept in a circular buffer
+ * sized for the longest window. A running sum is maintained for every window, so adding an event and
+ * querying a rate are both O(1) (amortized over the number of bins passed since the last call).
+ * Ticks are expected to be monotonic 64bit values, i.e. the 32bit pigpio tick extended by the overflow count.
+ */
+class RateCounter {
+public:
+    /**
+     * @param windows averaging windows in units of bins, e.g. { 1, 60, 3600 }
+     * @param binWidth width of one bin in ticks
+     */
+    explicit RateCounter(const std::vector<std::size_t>& windows, std::uint64_t binWidth = 1000000);
+
+    /**
+     * @brief add Count events at the given tick
+     * Ticks older than the current bin are counted into the current bin.
+     */
+    void add(std::uint64_t tick, std::uint32_t count = 1);
+    /**
+     * @brief advance Move the current bin forward to the given tick, expiring old bins
+     */
+    void advance(std::uint64_t tick);
+    /**
+     * @brief rate The average rate over the given window up to tick in events per second, assuming 1us ticks
+     * the current, partially elapsed bin is weighted by its elapsed time
+     * @param window index into the list of windows given at construction
+     */
+    [[nodiscard]] double rate(std::size_t window, std::uint64_t tick);
+    /**
+     * @brief counts The number of events in the given window
+     */
+    [[nodiscard]] std::uint64_t counts(std::size_t window) const;
+    [[nodiscard]] std::size_t windowCount() const { return m_windows.size(); }
+    void clear();
+
+private:
+    std::vector<std::size_t> m_windows {};
+    std::vector<std::uint64_t> m_sums {};
+    std::vector<std::uint32_t> m_bins {};
+    std::uint64_t m_binWidth { 1000000 };
+    std::uint64_t m_firstBin { 0 };
+    std::uint64_t m_currentBin { 0 };
+    bool m_started { false };
+};
+
+} // namespace MuonPi
+
+#endif // RATECOUNTER_H
@@ -0,0 +1,104 @@
+#ifndef SPSC_RINGBUFFER_H
+#define SPSC_RINGBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace MuonPi {
+
+constexpr std::size_t cache_line_size { 64 };
+
+/**
+ * @brief Fixed-capacity lock-free single-producer/single-consumer ring buffer
+ * The producer (e.g. the pigpio callback thread) calls push(), the consumer (e.g. the daemon thread)
+ * calls pop(). No locks and no allocations take place after construction.
+ * If the buffer is full, push() drops the new element and increments the overrun counter.
+ * Head and tail indices live on separate cache lines to avoid false sharing between the two threads.
+ * @tparam T trivially copyable element type
+ * @tparam N capacity, must be a power of two
+ */
+template <typename T, std::size_t N>
+class SpscRingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRingBuffer capacity must be a power of two");
+
+public:
+    SpscRingBuffer() = default;
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    /**
+     * @brief push Append an element. Must only be called from the producer thread.
+     * @return false if the buffer was full and the element has been dropped
+     */
+    bool push(const T& item)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail >= N) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail >= N) {
+                m_overruns.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        m_buffer[head & mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief pop Remove up to maxItems elements in FIFO order. Must only be called from the consumer thread.
+     * @param dest destination array with room for at least maxItems elements
+     * @return the number of elements actually copied to dest
+     */
+    std::size_t pop(T* dest, std::size_t maxItems)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        std::size_t count = head - tail;
+        // the fill level only grows between two pops, so its maximum is seen here
+        if (count > m_highWaterMark.load(std::memory_order_relaxed)) {
+            m_highWaterMark.store(count, std::memory_order_relaxed);
+        }
+        if (count > maxItems) {
+            count = maxItems;
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            dest[i] = m_buffer[(tail + i) & mask];
+        }
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] static constexpr std::size_t capacity() { return N; }
+    /**
+     * @brief overruns number of elements dropped because the buffer was full
+     */
+    [[nodiscard]] std::uint64_t overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+    /**
+     * @brief highWaterMark maximum fill level seen by the consumer since construction
+     */
+    [[nodiscard]] std::size_t highWaterMark() const { return m_highWaterMark.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t mask { N - 1 };
+
+    // written by the producer
+    alignas(cache_line_size) std::atomic<std::size_t> m_head { 0 };
+    std::size_t m_cachedTail { 0 };
+    std::atomic<std::uint64_t> m_overruns { 0 };
+    // written by the consumer
+    alignas(cache_line_size) std::atomic<std::size_t> m_tail { 0 };
+    std::atomic<std::size_t> m_highWaterMark { 0 };
+    alignas(cache_line_size) std::array<T, N> m_buffer {};
+};
+
+} // namespace MuonPi
+
+#endif // SPSC_RINGBUFFER_H
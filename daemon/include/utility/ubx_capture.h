@@ -0,0 +1,122 @@
+#ifndef UBX_CAPTURE_H
+#define UBX_CAPTURE_H
+
+#include <config.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MuonPi {
+
+/**
+ * @brief Capture file of the raw serial input from the u-blox module
+ * The file starts with a 16 byte header: magic "MUONPIUB" and the system time of the start of the capture
+ * in ns since the unix epoch (int64, little-endian). It is followed by one record per received chunk:
+ * the time since the previous chunk (the start of the capture for the first one) in us and the chunk length,
+ * both as unsigned LEB128 varints, and the bytes of the chunk. Records cut off at the end of the file
+ * (capture interrupted by a power loss) are ignored when reading.
+ */
+namespace UbxCapture {
+    constexpr char magic[8] { 'M', 'U', 'O', 'N', 'P', 'I', 'U', 'B' };
+    constexpr std::size_t header_size { 16 };
+}
+
+/**
+ * @brief Buffered writer of a UBX capture file
+ * append() only encodes the chunk into a memory buffer, the file is written by a separate thread in blocks
+ * of Config::Hardware::Ublox::Capture::block_size or after flush_interval at the latest. If the writer falls
+ * behind by more than max_buffered bytes, chunks are dropped and counted.
+ */
+class UbxCaptureWriter {
+public:
+    explicit UbxCaptureWriter(const std::string& fileName);
+    /**
+     * @brief ~UbxCaptureWriter Writes the remaining buffered data and closes the file
+     */
+    ~UbxCaptureWriter();
+
+    UbxCaptureWriter(const UbxCaptureWriter&) = delete;
+    UbxCaptureWriter& operator=(const UbxCaptureWriter&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return m_file != nullptr; }
+
+    /**
+     * @brief append Store a received chunk, timestamped with the current time
+     * @return false if the file is not open or the chunk was dropped
+     */
+    bool append(const char* data, std::size_t size);
+
+    [[nodiscard]] std::uint64_t chunks() const { return m_chunks.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t bytes() const { return m_bytes.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t droppedChunks() const { return m_droppedChunks.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t writeErrors() const { return m_writeErrors.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    std::FILE* m_file { nullptr };
+    std::chrono::steady_clock::time_point m_last {};
+
+    std::mutex m_mutex {};
+    std::condition_variable m_condition {};
+    std::vector<char> m_buffer {}; // filled by append(), guarded by m_mutex
+    std::vector<char> m_writing {}; // only used by the writer thread
+    bool m_stop { false };
+    std::thread m_thread {};
+
+    std::atomic<std::uint64_t> m_chunks { 0 };
+    std::atomic<std::uint64_t> m_bytes { 0 };
+    std::atomic<std::uint64_t> m_droppedChunks { 0 };
+    std::atomic<std::uint64_t> m_writeErrors { 0 };
+};
+
+/**
+ * @brief Sequential reader of a UBX capture file
+ */
+class UbxCaptureReader {
+public:
+    struct Chunk {
+        std::chrono::microseconds time { 0 }; // since the start of the capture
+        std::string data {};
+    };
+
+    explicit UbxCaptureReader(const std::string& fileName);
+    ~UbxCaptureReader();
+
+    UbxCaptureReader(const UbxCaptureReader&) = delete;
+    UbxCaptureReader& operator=(const UbxCaptureReader&) = delete;
+
+    /**
+     * @brief isOpen False if the file could not be opened or is not a capture file
+     */
+    [[nodiscard]] bool isOpen() const { return m_file != nullptr; }
+    /**
+     * @brief startTime The system time of the start of the capture in ns since the unix epoch
+     */
+    [[nodiscard]] std::int64_t startTime() const { return m_startTime; }
+
+    /**
+     * @brief next Read the next chunk, the buffer of chunk.data is reused
+     * @return false at the end of the file
+     */
+    bool next(Chunk& chunk);
+
+private:
+    bool readVarint(std::uint64_t& value);
+
+    std::FILE* m_file { nullptr };
+    std::int64_t m_startTime { 0 };
+    std::chrono::microseconds m_time { 0 };
+};
+
+} // namespace MuonPi
+
+#endif // UBX_CAPTURE_H
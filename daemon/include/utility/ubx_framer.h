@@ -0,0 +1,100 @@
+#ifndef UBX_FRAMER_H
+#define UBX_FRAMER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace MuonPi {
+
+/**
+ * @brief Incremental framer for the u-blox UBX protocol
+ * Received bytes are written into a fixed-size byte ring buffer and scanned by a state machine
+ * (sync chars -> class/id -> length -> payload -> Fletcher checksum), which keeps its position between calls,
+ * so the scanning cost does not depend on the backlog. Only after a checksum failure or an implausible length
+ * the bytes of the abandoned frame are scanned again, starting right after its sync chars.
+ * Complete frames are handed out as views into the ring buffer. Only frames wrapping around
+ * the end of the buffer are copied to a scratch buffer to make them contiguous.
+ * Bytes outside of UBX frames (e.g. NMEA sentences) are skipped.
+ */
+class UbxFramer {
+public:
+    struct Frame {
+        std::uint16_t msgID { 0 }; // class in the high byte, id in the low byte
+        std::string_view payload {};
+    };
+
+    struct Statistics {
+        std::uint64_t frames { 0 };
+        std::uint64_t checksumErrors { 0 };
+        std::uint64_t oversizedFrames { 0 };
+        std::uint64_t resyncs { 0 }; // number of times an already started frame had to be abandoned
+        std::uint64_t discardedBytes { 0 }; // bytes outside of valid UBX frames
+    };
+
+    /**
+     * @param capacity size of the ring buffer in bytes, rounded up to a power of two.
+     * Frames with a payload larger than capacity - 8 are rejected.
+     */
+    explicit UbxFramer(std::size_t capacity = 65536);
+
+    /**
+     * @brief write Append received bytes
+     * @return the number of bytes actually stored, which is less than size if the buffer is full.
+     * In that case the remaining bytes have to be written again after draining frames with next().
+     */
+    std::size_t write(const char* data, std::size_t size);
+    /**
+     * @brief next Scan for the next complete frame with a valid checksum
+     * The payload view stays valid until the next call of write() or reset().
+     * @return false if no complete frame is available yet
+     */
+    bool next(Frame& frame);
+    void reset();
+
+    [[nodiscard]] std::size_t size() const { return m_head - m_tail; }
+    [[nodiscard]] std::size_t capacity() const { return m_buffer.size(); }
+    [[nodiscard]] const Statistics& statistics() const { return m_statistics; }
+
+    static constexpr std::uint8_t sync_char_1 { 0xb5 };
+    static constexpr std::uint8_t sync_char_2 { 0x62 };
+    static constexpr std::size_t header_size { 6 };
+    static constexpr std::size_t checksum_size { 2 };
+
+private:
+    enum class State {
+        Sync1,
+        Sync2,
+        Class,
+        Id,
+        Length1,
+        Length2,
+        Payload,
+        ChecksumA,
+        ChecksumB
+    };
+
+    [[nodiscard]] std::uint8_t at(std::size_t index) const { return static_cast<std::uint8_t>(m_buffer[index & m_mask]); }
+    void resync();
+    std::string_view view(std::size_t start, std::size_t length);
+
+    std::vector<char> m_buffer {};
+    std::vector<char> m_scratch {};
+    std::size_t m_mask { 0 };
+    // monotonic byte counters, the ring index is counter & m_mask
+    std::size_t m_head { 0 }; // next byte to be written
+    std::size_t m_tail { 0 }; // first byte not yet consumed, start of the current frame while inside a frame
+    std::size_t m_scan { 0 }; // next byte to be inspected by the state machine
+
+    State m_state { State::Sync1 };
+    std::uint16_t m_msgID { 0 };
+    std::size_t m_length { 0 };
+    std::uint8_t m_chkA { 0 };
+    std::uint8_t m_chkB { 0 };
+    Statistics m_statistics {};
+};
+
+} // namespace MuonPi
+
+#endif // UBX_FRAMER_H
@@ -0,0 +1,72 @@
+#ifndef UBX_PAYLOAD_H
+#define UBX_PAYLOAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace MuonPi::Ublox {
+
+/**
+ * @brief read Read a little-endian field from a UBX payload
+ * The value is copied with memcpy, so unaligned offsets are fine. The caller is responsible for
+ * checking the payload length, the dispatcher guarantees the minimum length registered for the message.
+ * @param payload view of the message payload (without header and checksum)
+ * @param offset byte offset of the field as given in the u-blox protocol specification
+ */
+template <typename T>
+[[nodiscard]] inline T read(std::string_view payload, std::size_t offset)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "UBX fields have to be trivially copyable");
+    T value;
+    std::memcpy(&value, payload.data() + offset, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    auto* bytes = reinterpret_cast<unsigned char*>(&value);
+    for (std::size_t i = 0; i < sizeof(T) / 2; i++) {
+        const unsigned char tmp { bytes[i] };
+        bytes[i] = bytes[sizeof(T) - 1 - i];
+        bytes[sizeof(T) - 1 - i] = tmp;
+    }
+#endif
+    return value;
+}
+
+/**
+ * @brief Decoded UBX-TIM-TM2 (time mark) payload
+ */
+struct TimTm2 {
+    static constexpr std::size_t size { 28 };
+
+    std::uint8_t ch;
+    std::uint8_t flags;
+    std::uint16_t count; // rising edge counter
+    std::uint16_t wnR; // week number of last rising edge
+    std::uint16_t wnF; // week number of last falling edge
+    std::uint32_t towMsR; // time of week of rising edge, ms
+    std::uint32_t towSubMsR; // time of week of rising edge, sub ms (ns)
+    std::uint32_t towMsF; // time of week of falling edge, ms
+    std::uint32_t towSubMsF; // time of week of falling edge, sub ms (ns)
+    std::uint32_t accEst; // accuracy estimate, ns
+
+    [[nodiscard]] static TimTm2 decode(std::string_view payload)
+    {
+        return TimTm2 {
+            read<std::uint8_t>(payload, 0),
+            read<std::uint8_t>(payload, 1),
+            read<std::uint16_t>(payload, 2),
+            read<std::uint16_t>(payload, 4),
+            read<std::uint16_t>(payload, 6),
+            read<std::uint32_t>(payload, 8),
+            read<std::uint32_t>(payload, 12),
+            read<std::uint32_t>(payload, 16),
+            read<std::uint32_t>(payload, 20),
+            read<std::uint32_t>(payload, 24)
+        };
+    }
+};
+
+} // namespace MuonPi::Ublox
+
+#endif // UBX_PAYLOAD_H
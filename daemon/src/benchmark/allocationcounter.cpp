@@ -0,0 +1,94 @@
+#include "benchmark/allocationcounter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+
+namespace MuonPi::Benchmark::Allocations {
+
+static std::atomic<std::uint64_t> s_allocations { 0 };
+static std::atomic<std::uint64_t> s_bytes { 0 };
+static thread_local bool s_excluded { false };
+
+static inline void count(std::size_t size)
+{
+    if (s_excluded) {
+        return;
+    }
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+Snapshot snapshot()
+{
+    return Snapshot { s_allocations.load(std::memory_order_relaxed), s_bytes.load(std::memory_order_relaxed) };
+}
+
+void excludeCurrentThread()
+{
+    s_excluded = true;
+}
+
+} // namespace MuonPi::Benchmark::Allocations
+
+/* glibc exports its allocator under these names, so the interposed functions below do not need
+ * an allocator of their own. operator new of libstdc++ calls malloc and is counted as well,
+ * the aligned variants of operator new call aligned_alloc or posix_memalign.
+ * There is no exported posix_memalign or aligned_alloc, both are built on __libc_memalign.
+ */
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size) noexcept
+{
+    MuonPi::Benchmark::Allocations::count(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    MuonPi::Benchmark::Allocations::count(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size) noexcept
+{
+    MuonPi::Benchmark::Allocations::count(size);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    MuonPi::Benchmark::Allocations::count(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    MuonPi::Benchmark::Allocations::count(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size) noexcept
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0) {
+        return EINVAL;
+    }
+    MuonPi::Benchmark::Allocations::count(size);
+    void* result { __libc_memalign(alignment, size) };
+    if (result == nullptr) {
+        return ENOMEM;
+    }
+    *ptr = result;
+    return 0;
+}
+
+void free(void* ptr) noexcept
+{
+    __libc_free(ptr);
+}
+}
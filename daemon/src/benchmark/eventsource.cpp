@@ -0,0 +1,31 @@
+#include "benchmark/eventsource.h"
+#include "benchmark/allocationcounter.h"
+
+namespace MuonPi::Benchmark {
+
+EventSource::~EventSource()
+{
+    stop();
+}
+
+void EventSource::start()
+{
+    if (m_running.exchange(true)) {
+        return;
+    }
+    m_thread = std::thread([this]() {
+        // the load generator is not part of the measured pipeline
+        Allocations::excludeCurrentThread();
+        run();
+    });
+}
+
+void EventSource::stop()
+{
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+} // namespace MuonPi::Benchmark
@@ -0,0 +1,58 @@
+#include "benchmark/gpioticksource.h"
+#include "benchmark/simulatedpigpiod.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace MuonPi::Benchmark {
+
+GpioTickSource::GpioTickSource(std::vector<Channel> channels, std::uint64_t seed)
+    : m_channels { std::move(channels) }
+    , m_seed { seed }
+{
+    m_channels.erase(std::remove_if(m_channels.begin(), m_channels.end(), [](const Channel& channel) { return !(channel.rate > 0.); }), m_channels.end());
+}
+
+GpioTickSource::~GpioTickSource()
+{
+    stop();
+}
+
+void GpioTickSource::run()
+{
+    if (m_channels.empty()) {
+        return;
+    }
+    SimulatedPigpiod& pigpiod { SimulatedPigpiod::instance() };
+    std::mt19937_64 generator { m_seed };
+    std::exponential_distribution<double> unit { 1. };
+
+    // the schedule is kept in us since the epoch of the tick counter, as double to accumulate fractional intervals
+    const auto interval { [&](const Channel& channel) {
+        return ((channel.periodic) ? 1. : unit(generator)) * 1e6 / channel.rate;
+    } };
+    const double start { static_cast<double>(pigpiod.now()) };
+    std::vector<double> next(m_channels.size());
+    for (std::size_t i = 0; i < m_channels.size(); i++) {
+        next[i] = start + interval(m_channels[i]);
+    }
+
+    while (running()) {
+        const auto earliest { std::min_element(next.begin(), next.end()) };
+        const std::size_t i { static_cast<std::size_t>(std::distance(next.begin(), earliest)) };
+        const auto due { static_cast<std::uint64_t>(*earliest) };
+        if (due > pigpiod.now()) {
+            // wake up at least every 10ms to react on stop()
+            std::this_thread::sleep_until(std::min(pigpiod.epoch() + std::chrono::microseconds(due),
+                std::chrono::steady_clock::now() + std::chrono::milliseconds(10)));
+            continue;
+        }
+        if (pigpiod.inject(m_channels[i].gpio, 1, static_cast<std::uint32_t>(due))) {
+            m_injectedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+        next[i] += interval(m_channels[i]);
+    }
+}
+
+} // namespace MuonPi::Benchmark
@@ -0,0 +1,283 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <config.h>
+#include "benchmark/allocationcounter.h"
+#include "benchmark/gpioticksource.h"
+#include "benchmark/pipelineprobe.h"
+#include "benchmark/simulatedbroker.h"
+#include "benchmark/simulatedpigpiod.h"
+#include "benchmark/ubxstreamsource.h"
+#include "daemon.h"
+#include "hardware/i2c/i2cdevice.h"
+#include "utility/gpio_mapping.h"
+#include "utility/ubx_capture.h"
+
+using namespace MuonPi::Benchmark;
+
+static int verbose = 0;
+
+static void messageOutput(QtMsgType type, const QMessageLogContext&, const QString& msg)
+{
+    // the daemon is chatty, only problems are shown unless asked for more
+    if ((type == QtDebugMsg || type == QtInfoMsg) && verbose < 1) {
+        return;
+    }
+    std::fprintf(stderr, "%s\n", qPrintable(msg));
+}
+
+struct Measurement {
+    double duration { 0. }; // in s
+    std::uint64_t gpioInjected { 0 };
+    std::uint64_t ubxInjected { 0 };
+    std::uint64_t ubxBytes { 0 };
+    SimulatedBroker::Snapshot mqtt {};
+    Allocations::Snapshot allocations {};
+    PipelineProbe::Result received {};
+};
+
+static double percentile(const std::vector<std::uint32_t>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0.;
+    }
+    const auto index { static_cast<std::size_t>(p / 100. * static_cast<double>(sorted.size() - 1) + 0.5) };
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void report(Measurement& m)
+{
+    const double t { std::max(m.duration, 1e-9) };
+    const std::uint64_t events { m.received.gpioEvents + m.received.timemarks };
+    std::printf("measurement window          : %.1f s\n", m.duration);
+    std::printf("gpio events injected        : %llu (%.1f /s)\n", static_cast<unsigned long long>(m.gpioInjected), m.gpioInjected / t);
+    std::printf("gpio events delivered       : %llu (%.1f /s)\n", static_cast<unsigned long long>(m.received.gpioEvents), m.received.gpioEvents / t);
+    std::printf("ubx bytes injected          : %llu (%.1f /s)\n", static_cast<unsigned long long>(m.ubxBytes), m.ubxBytes / t);
+    std::printf("ubx timemarks injected      : %llu (%.1f /s)\n", static_cast<unsigned long long>(m.ubxInjected), m.ubxInjected / t);
+    std::printf("ubx timemarks delivered     : %llu (%.1f /s)\n", static_cast<unsigned long long>(m.received.timemarks), m.received.timemarks / t);
+    std::printf("tcp messages received       : %llu (%.1f /s)\n", static_cast<unsigned long long>(m.received.messages), m.received.messages / t);
+    std::printf("mqtt messages published     : %llu (%llu bytes)\n", static_cast<unsigned long long>(m.mqtt.messages), static_cast<unsigned long long>(m.mqtt.bytes));
+    std::vector<std::uint32_t>& latencies { m.received.latencies };
+    if (latencies.empty()) {
+        std::printf("gpio event latency          : no events with tick received\n");
+    } else {
+        std::sort(latencies.begin(), latencies.end());
+        std::printf("gpio event latency (us)     : p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %u\n",
+            percentile(latencies, 50.), percentile(latencies, 90.), percentile(latencies, 99.), percentile(latencies, 99.9), latencies.back());
+    }
+    std::printf("allocations (daemon)        : %llu (%llu bytes)\n", static_cast<unsigned long long>(m.allocations.allocations), static_cast<unsigned long long>(m.allocations.bytes));
+    if (events > 0) {
+        std::printf("allocations per event       : %.2f (%.1f bytes)\n", static_cast<double>(m.allocations.allocations) / events, static_cast<double>(m.allocations.bytes) / events);
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    qRegisterMetaType<TcpMessage>("TcpMessage");
+    qInstallMessageHandler(messageOutput);
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("muondetector-daemon-benchmark");
+    QCoreApplication::setApplicationVersion(QString::fromStdString(MuonPi::Version::software.string()));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs the muondetector daemon pipeline with simulated gpio and GNSS inputs\n"
+                                     "and reports throughput, latency and heap allocations.\n"
+                                     "MQTT messages go to a simulated broker. No i2c devices are used unless --i2c-bus is given,\n"
+                                     "stop a running daemon before using it on a detector.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption ubxFileOption("ubx",
+        QCoreApplication::translate("main", "recorded UBX byte stream or daemon capture (--capture) to replay on the serial port"),
+        QCoreApplication::translate("main", "file"));
+    parser.addOption(ubxFileOption);
+    QCommandLineOption ubxRateOption("ubx-rate",
+        QCoreApplication::translate("main", "replay rate of the UBX stream in bytes/s, 0 for as fast as possible\n"
+                                            "default: wire speed of the baudrate"),
+        QCoreApplication::translate("main", "rate"));
+    parser.addOption(ubxRateOption);
+    QCommandLineOption baudrateOption("baudrate",
+        QCoreApplication::translate("main", "baudrate of the simulated serial port"),
+        QCoreApplication::translate("main", "baudrate"), "9600");
+    parser.addOption(baudrateOption);
+    QCommandLineOption xorRateOption("xor-rate",
+        QCoreApplication::translate("main", "rate of the XOR event signal in Hz"),
+        QCoreApplication::translate("main", "rate"), "20");
+    parser.addOption(xorRateOption);
+    QCommandLineOption andRateOption("and-rate",
+        QCoreApplication::translate("main", "rate of the AND event signal in Hz"),
+        QCoreApplication::translate("main", "rate"), "2");
+    parser.addOption(andRateOption);
+    QCommandLineOption periodicOption("periodic",
+        QCoreApplication::translate("main", "generate events at fixed intervals instead of random ones"));
+    parser.addOption(periodicOption);
+    QCommandLineOption warmupOption("warmup",
+        QCoreApplication::translate("main", "time in s before the measurement starts"),
+        QCoreApplication::translate("main", "seconds"), "5");
+    parser.addOption(warmupOption);
+    QCommandLineOption durationOption("duration",
+        QCoreApplication::translate("main", "duration of the measurement in s"),
+        QCoreApplication::translate("main", "seconds"), "30");
+    parser.addOption(durationOption);
+    QCommandLineOption portOption("port",
+        QCoreApplication::translate("main", "tcp port of the daemon under test"),
+        QCoreApplication::translate("main", "port"), "51599");
+    parser.addOption(portOption);
+    QCommandLineOption flushWindowOption("flush-window",
+        QCoreApplication::translate("main", "gpio event batch flush window in ms"),
+        QCoreApplication::translate("main", "ms"), QString::number(MuonPi::Config::Hardware::GPIO::EventBatch::flush_window));
+    parser.addOption(flushWindowOption);
+    QCommandLineOption storeLocalOption("store-local",
+        QCoreApplication::translate("main", "write the events to the local data files"));
+    parser.addOption(storeLocalOption);
+    QCommandLineOption i2cBusOption("i2c-bus",
+        QCoreApplication::translate("main", "i2c bus of the detector board, e.g. /dev/i2c-1"),
+        QCoreApplication::translate("main", "device"));
+    parser.addOption(i2cBusOption);
+    QCommandLineOption verbosityOption(QStringList() << "e"
+                                                     << "verbose",
+        QCoreApplication::translate("main", "set verbosity level of the daemon\n"
+                                            "5 is max"),
+        QCoreApplication::translate("main", "verbosity"), "0");
+    parser.addOption(verbosityOption);
+    parser.process(a);
+
+    verbose = parser.value(verbosityOption).toInt();
+    const int warmup { std::max(parser.value(warmupOption).toInt(), 0) };
+    const int duration { std::max(parser.value(durationOption).toInt(), 1) };
+    const int baudrate { parser.value(baudrateOption).toInt() };
+
+    std::unique_ptr<UbxStreamSource> ubxSource {};
+    if (parser.isSet(ubxFileOption)) {
+        QFile file { parser.value(ubxFileOption) };
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCritical() << "could not open" << file.fileName() << ":" << file.errorString();
+            return EXIT_FAILURE;
+        }
+        QByteArray recording {};
+        MuonPi::UbxCaptureReader capture { parser.value(ubxFileOption).toStdString() };
+        if (capture.isOpen()) {
+            // a capture of the daemon is streamed as the concatenation of its chunks
+            MuonPi::UbxCaptureReader::Chunk chunk {};
+            while (capture.next(chunk)) {
+                recording.append(chunk.data.data(), static_cast<int>(chunk.data.size()));
+            }
+        } else {
+            recording = file.readAll();
+        }
+        const double rate { parser.isSet(ubxRateOption) ? parser.value(ubxRateOption).toDouble() : baudrate / 10. };
+        ubxSource = std::make_unique<UbxStreamSource>(recording.toStdString(), rate);
+        if (!ubxSource->open()) {
+            qCritical() << "could not create a pseudo terminal for the serial port";
+            return EXIT_FAILURE;
+        }
+        qWarning() << "replaying" << recording.size() << "bytes with" << ubxSource->timemarksPerPass() << "time marks per pass";
+    }
+
+    // without a bus all i2c devices are absent, as on a computer without detector board
+    i2cDevice::setDefaultBus(parser.value(i2cBusOption).toStdString());
+
+    Daemon::configuration config {};
+    config.verbose = verbose;
+    config.dumpRaw = false;
+    config.gpsdevname = (ubxSource) ? QString::fromStdString(ubxSource->portName()) : QString();
+    config.baudrate = baudrate;
+    config.serverPort = static_cast<quint16>(parser.value(portOption).toUInt());
+    config.station_ID = "benchmark";
+    config.storeLocal = parser.isSet(storeLocalOption);
+    config.gpioEventFlushWindow = parser.value(flushWindowOption).toInt();
+    config.mqtt.journal_file = QDir::temp().filePath("muondetector-benchmark-journal");
+    QFile::remove(config.mqtt.journal_file);
+
+    auto daemon { std::make_unique<Daemon>(config) };
+
+    std::vector<GpioTickSource::Channel> channels {
+        { GPIO_PINMAP[EVT_XOR], parser.value(xorRateOption).toDouble(), parser.isSet(periodicOption) },
+        { GPIO_PINMAP[EVT_AND], parser.value(andRateOption).toDouble(), parser.isSet(periodicOption) },
+        { GPIO_PINMAP[TIMEPULSE], 1., true }
+    };
+    GpioTickSource gpioSource { std::move(channels) };
+
+    auto probe { new PipelineProbe("127.0.0.1", config.serverPort) };
+    auto probeThread { new QThread() };
+    probeThread->setObjectName("muondetector-benchmark-probe");
+    probe->moveToThread(probeThread);
+    // a functor without context object is called directly, i.e. in the new thread
+    QObject::connect(probeThread, &QThread::started, []() { Allocations::excludeCurrentThread(); });
+    QObject::connect(probeThread, &QThread::started, probe, &PipelineProbe::start);
+    QObject::connect(probeThread, &QThread::finished, probe, &PipelineProbe::deleteLater);
+    QObject::connect(probeThread, &QThread::finished, probeThread, &QThread::deleteLater);
+    QObject::connect(probe, &PipelineProbe::error, &a, [](const QString& message) {
+        qCritical() << "could not connect to the daemon:" << message;
+        QCoreApplication::exit(EXIT_FAILURE);
+    });
+
+    Measurement measurement {};
+    Allocations::Snapshot allocationsStart {};
+    SimulatedBroker::Snapshot mqttStart {};
+    std::uint64_t gpioStart { 0 }, ubxStart { 0 }, ubxBytesStart { 0 };
+    std::uint64_t startTime { 0 };
+
+    // the inputs are fed once the client is connected, the counters are reset after the warm-up
+    QObject::connect(probe, &PipelineProbe::connected, &a, [&]() {
+        qWarning() << "connected, warming up for" << warmup << "s";
+        gpioSource.start();
+        if (ubxSource) {
+            ubxSource->start();
+        }
+        QTimer::singleShot(warmup * 1000, &a, [&]() {
+            qWarning() << "measuring for" << duration << "s";
+            probe->take();
+            allocationsStart = Allocations::snapshot();
+            mqttStart = SimulatedBroker::instance().published();
+            gpioStart = gpioSource.injectedEvents();
+            if (ubxSource) {
+                ubxStart = ubxSource->injectedEvents();
+                ubxBytesStart = ubxSource->injectedBytes();
+            }
+            startTime = SimulatedPigpiod::instance().now();
+            QTimer::singleShot(duration * 1000, &a, [&]() {
+                const Allocations::Snapshot allocationsEnd { Allocations::snapshot() };
+                measurement.received = probe->take();
+                measurement.duration = (SimulatedPigpiod::instance().now() - startTime) * 1e-6;
+                measurement.allocations = { allocationsEnd.allocations - allocationsStart.allocations, allocationsEnd.bytes - allocationsStart.bytes };
+                const SimulatedBroker::Snapshot mqttEnd { SimulatedBroker::instance().published() };
+                measurement.mqtt = { mqttEnd.messages - mqttStart.messages, mqttEnd.bytes - mqttStart.bytes };
+                measurement.gpioInjected = gpioSource.injectedEvents() - gpioStart;
+                if (ubxSource) {
+                    measurement.ubxInjected = ubxSource->injectedEvents() - ubxStart;
+                    measurement.ubxBytes = ubxSource->injectedBytes() - ubxBytesStart;
+                }
+                QCoreApplication::exit(EXIT_SUCCESS);
+            });
+        });
+    });
+    // give the daemon time to set up its server and the serial port
+    QTimer::singleShot(1000, probeThread, [probeThread]() { probeThread->start(); });
+
+    const int result { a.exec() };
+    gpioSource.stop();
+    if (ubxSource) {
+        ubxSource->stop();
+    }
+    if (result == EXIT_SUCCESS) {
+        report(measurement);
+    }
+    probeThread->quit();
+    probeThread->wait();
+    emit daemon->aboutToQuit();
+    daemon.reset();
+    return result;
+}
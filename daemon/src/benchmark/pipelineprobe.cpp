@@ -0,0 +1,66 @@
+#include "benchmark/pipelineprobe.h"
+#include "benchmark/simulatedpigpiod.h"
+
+#include <muondetector_structs.h>
+#include <tcpconnection.h>
+#include <tcpmessage_keys.h>
+
+namespace MuonPi::Benchmark {
+
+PipelineProbe::PipelineProbe(QString hostName, quint16 port, QObject* parent)
+    : QObject { parent }
+    , m_hostName { std::move(hostName) }
+    , m_port { port }
+{
+}
+
+void PipelineProbe::start()
+{
+    m_connection = new TcpConnection(m_hostName, m_port, 0, 15000, 5000, this);
+    connect(m_connection, &TcpConnection::receivedTcpMessage, this, &PipelineProbe::onTcpMessage);
+    connect(m_connection, &TcpConnection::connected, this, &PipelineProbe::connected);
+    connect(m_connection, &TcpConnection::error, this, [this](int, const QString& message) {
+        emit error(message);
+    });
+    // new clients are subscribed to all message groups, so no subscription is sent
+    m_connection->makeConnection();
+}
+
+void PipelineProbe::onTcpMessage(TcpMessage tcpMessage)
+{
+    const std::uint32_t arrival { SimulatedPigpiod::instance().currentTick() };
+    const auto msgID { static_cast<TCP_MSG_KEY>(tcpMessage.getMsgID()) };
+    std::lock_guard<std::mutex> lock { m_mutex };
+    m_result.messages++;
+    if (msgID == TCP_MSG_KEY::MSG_GPIO_EVENT_BATCH) {
+        quint16 nrEvents { 0 };
+        tcpMessage.stream() >> nrEvents;
+        for (quint16 i = 0; i < nrEvents; i++) {
+            GpioEventStruct evt;
+            tcpMessage.stream() >> evt;
+            // the extended tick carries the simulated 32bit tick in its lower half
+            m_result.latencies.push_back(arrival - static_cast<std::uint32_t>(evt.tick));
+        }
+        m_result.gpioEvents += nrEvents;
+        return;
+    }
+    if (msgID == TCP_MSG_KEY::MSG_GPIO_EVENT) {
+        // sent without tick if batching is disabled
+        m_result.gpioEvents++;
+        return;
+    }
+    if (msgID == TCP_MSG_KEY::MSG_UBX_TIMEMARK) {
+        m_result.timemarks++;
+        return;
+    }
+}
+
+PipelineProbe::Result PipelineProbe::take()
+{
+    Result result {};
+    std::lock_guard<std::mutex> lock { m_mutex };
+    std::swap(result, m_result);
+    return result;
+}
+
+} // namespace MuonPi::Benchmark
@@ -0,0 +1,131 @@
+#include "benchmark/simulatedbroker.h"
+
+#include <mosquitto.h>
+
+namespace MuonPi::Benchmark {
+
+SimulatedBroker& SimulatedBroker::instance()
+{
+    static SimulatedBroker s_instance {};
+    return s_instance;
+}
+
+SimulatedBroker::Snapshot SimulatedBroker::published() const
+{
+    return Snapshot { m_messages.load(std::memory_order_relaxed), m_bytes.load(std::memory_order_relaxed) };
+}
+
+void SimulatedBroker::publish(int payloadLength)
+{
+    m_messages.fetch_add(1, std::memory_order_relaxed);
+    m_bytes.fetch_add(static_cast<std::uint64_t>(payloadLength), std::memory_order_relaxed);
+}
+
+} // namespace MuonPi::Benchmark
+
+using MuonPi::Benchmark::SimulatedBroker;
+
+// the client handle is opaque in mosquitto.h
+struct mosquitto {
+    void* object { nullptr };
+    void (*onConnect)(struct mosquitto*, void*, int) { nullptr };
+    void (*onDisconnect)(struct mosquitto*, void*, int) { nullptr };
+    bool connected { false };
+};
+
+/* The subset of the libmosquitto interface used by the MqttHandler
+ *
+ */
+extern "C" {
+
+int mosquitto_lib_init(void)
+{
+    return MOSQ_ERR_SUCCESS;
+}
+
+int mosquitto_lib_cleanup(void)
+{
+    return MOSQ_ERR_SUCCESS;
+}
+
+struct mosquitto* mosquitto_new(const char*, bool, void* obj)
+{
+    struct mosquitto* mosq { new mosquitto {} };
+    mosq->object = obj;
+    return mosq;
+}
+
+void mosquitto_destroy(struct mosquitto* mosq)
+{
+    delete mosq;
+}
+
+void mosquitto_connect_callback_set(struct mosquitto* mosq, void (*on_connect)(struct mosquitto*, void*, int))
+{
+    mosq->onConnect = on_connect;
+}
+
+void mosquitto_disconnect_callback_set(struct mosquitto* mosq, void (*on_disconnect)(struct mosquitto*, void*, int))
+{
+    mosq->onDisconnect = on_disconnect;
+}
+
+void mosquitto_message_callback_set(struct mosquitto*, void (*)(struct mosquitto*, void*, const struct mosquitto_message*))
+{
+}
+
+int mosquitto_loop_start(struct mosquitto*)
+{
+    return MOSQ_ERR_SUCCESS;
+}
+
+int mosquitto_loop_stop(struct mosquitto*, bool)
+{
+    return MOSQ_ERR_SUCCESS;
+}
+
+int mosquitto_username_pw_set(struct mosquitto*, const char*, const char*)
+{
+    return MOSQ_ERR_SUCCESS;
+}
+
+int mosquitto_connect(struct mosquitto* mosq, const char*, int, int)
+{
+    mosq->connected = true;
+    if (mosq->onConnect != nullptr) {
+        mosq->onConnect(mosq, mosq->object, 0);
+    }
+    return MOSQ_ERR_SUCCESS;
+}
+
+int mosquitto_disconnect(struct mosquitto* mosq)
+{
+    if (!mosq->connected) {
+        return MOSQ_ERR_NO_CONN;
+    }
+    mosq->connected = false;
+    if (mosq->onDisconnect != nullptr) {
+        mosq->onDisconnect(mosq, mosq->object, 0);
+    }
+    return MOSQ_ERR_SUCCESS;
+}
+
+int mosquitto_subscribe(struct mosquitto* mosq, int*, const char*, int)
+{
+    return (mosq->connected) ? MOSQ_ERR_SUCCESS : MOSQ_ERR_NO_CONN;
+}
+
+int mosquitto_unsubscribe(struct mosquitto* mosq, int*, const char*)
+{
+    return (mosq->connected) ? MOSQ_ERR_SUCCESS : MOSQ_ERR_NO_CONN;
+}
+
+int mosquitto_publish(struct mosquitto* mosq, int*, const char*, int payloadlen, const void*, int, bool)
+{
+    if (!mosq->connected) {
+        return MOSQ_ERR_NO_CONN;
+    }
+    SimulatedBroker::instance().publish(payloadlen);
+    return MOSQ_ERR_SUCCESS;
+}
+}
@@ -0,0 +1,161 @@
+#include "benchmark/simulatedpigpiod.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+extern "C" {
+#include <pigpiod_if2.h>
+}
+
+namespace MuonPi::Benchmark {
+
+SimulatedPigpiod& SimulatedPigpiod::instance()
+{
+    static SimulatedPigpiod s_instance {};
+    return s_instance;
+}
+
+SimulatedPigpiod::SimulatedPigpiod()
+    : m_epoch { std::chrono::steady_clock::now() }
+{
+}
+
+std::uint64_t SimulatedPigpiod::now() const
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_epoch).count());
+}
+
+bool SimulatedPigpiod::inject(unsigned int gpio, unsigned int level, std::uint32_t tick)
+{
+    // the callbacks are called without the lock held, the pigpio callback of the handler may call pigpio_stop()
+    std::array<Callback, max_callbacks_per_gpio> callbacks {};
+    std::size_t n { 0 };
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        if (!m_running) {
+            return false;
+        }
+        for (const auto& registration : m_callbacks) {
+            if (registration.gpio != gpio || n == callbacks.size()) {
+                continue;
+            }
+            if (registration.edge != EITHER_EDGE && registration.edge != ((level != 0) ? RISING_EDGE : FALLING_EDGE)) {
+                continue;
+            }
+            callbacks[n++] = registration.callback;
+        }
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        callbacks[i](handle, gpio, level, tick);
+    }
+    return n > 0;
+}
+
+bool SimulatedPigpiod::isRegistered(unsigned int gpio) const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    return std::any_of(m_callbacks.begin(), m_callbacks.end(), [gpio](const Registration& registration) { return registration.gpio == gpio; });
+}
+
+int SimulatedPigpiod::start()
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    m_running = true;
+    return handle;
+}
+
+void SimulatedPigpiod::stop()
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    m_running = false;
+    m_callbacks.clear();
+}
+
+int SimulatedPigpiod::addCallback(unsigned int gpio, unsigned int edge, Callback callback)
+{
+    if (gpio > PI_MAX_USER_GPIO) {
+        return PI_BAD_USER_GPIO;
+    }
+    std::lock_guard<std::mutex> lock { m_mutex };
+    const unsigned int id { m_nextId++ };
+    m_callbacks.push_back(Registration { id, gpio, edge, callback });
+    return static_cast<int>(id);
+}
+
+int SimulatedPigpiod::cancelCallback(unsigned int id)
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    auto it { std::find_if(m_callbacks.begin(), m_callbacks.end(), [id](const Registration& registration) { return registration.id == id; }) };
+    if (it == m_callbacks.end()) {
+        return pigif_callback_not_found;
+    }
+    m_callbacks.erase(it);
+    return 0;
+}
+
+} // namespace MuonPi::Benchmark
+
+using MuonPi::Benchmark::SimulatedPigpiod;
+
+/* The subset of the pigpiod_if2 interface used by the daemon
+ *
+ */
+extern "C" {
+
+int pigpio_start(const char*, const char*)
+{
+    return SimulatedPigpiod::instance().start();
+}
+
+void pigpio_stop(int)
+{
+    SimulatedPigpiod::instance().stop();
+}
+
+int set_mode(int, unsigned, unsigned)
+{
+    return 0;
+}
+
+int set_pull_up_down(int, unsigned, unsigned)
+{
+    return 0;
+}
+
+int gpio_write(int, unsigned, unsigned)
+{
+    return 0;
+}
+
+uint32_t get_current_tick(int)
+{
+    return SimulatedPigpiod::instance().currentTick();
+}
+
+int callback(int, unsigned user_gpio, unsigned edge, CBFunc_t f)
+{
+    return SimulatedPigpiod::instance().addCallback(user_gpio, edge, f);
+}
+
+int callback_cancel(unsigned callback_id)
+{
+    return SimulatedPigpiod::instance().cancelCallback(callback_id);
+}
+
+int spi_open(int, unsigned, unsigned, unsigned)
+{
+    return 0;
+}
+
+int spi_close(int, unsigned)
+{
+    return 0;
+}
+
+int spi_xfer(int, unsigned, char*, char* rxBuf, unsigned count)
+{
+    std::memset(rxBuf, 0, count);
+    return static_cast<int>(count);
+}
+}
@@ -0,0 +1,121 @@
+#include "benchmark/ubxstreamsource.h"
+#include "utility/ubx_framer.h"
+
+#include <ublox_messages.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace MuonPi::Benchmark {
+
+UbxStreamSource::UbxStreamSource(std::string recording, double bytesPerSecond, bool loop)
+    : m_recording { std::move(recording) }
+    , m_bytesPerSecond { std::max(bytesPerSecond, 0.) }
+    , m_loop { loop }
+{
+    // find the positions at which the daemon has received a complete time mark message
+    UbxFramer framer {};
+    UbxFramer::Frame frame {};
+    for (std::size_t i = 0; i < m_recording.size(); i++) {
+        framer.write(m_recording.data() + i, 1);
+        while (framer.next(frame)) {
+            if (frame.msgID == UBX_TIM_TM2) {
+                m_timemarkEnds.push_back(i + 1);
+            }
+        }
+    }
+}
+
+UbxStreamSource::~UbxStreamSource()
+{
+    stop();
+    if (m_master >= 0) {
+        ::close(m_master);
+    }
+}
+
+bool UbxStreamSource::open()
+{
+    if (m_master >= 0) {
+        return true;
+    }
+    m_master = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (m_master < 0) {
+        return false;
+    }
+    const char* slave { nullptr };
+    if (::grantpt(m_master) != 0 || ::unlockpt(m_master) != 0 || (slave = ::ptsname(m_master)) == nullptr) {
+        ::close(m_master);
+        m_master = -1;
+        return false;
+    }
+    m_portName = slave;
+    return true;
+}
+
+void UbxStreamSource::drain()
+{
+    char buffer[1024];
+    // EIO as long as the slave side is not opened, EAGAIN if nothing was sent
+    while (::read(m_master, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+void UbxStreamSource::run()
+{
+    if (m_master < 0 || m_recording.empty()) {
+        return;
+    }
+    // bytes handed to the pty at once, at least one millisecond worth of data when paced
+    constexpr std::size_t max_chunk { 4096 };
+    const auto start { std::chrono::steady_clock::now() };
+    std::uint64_t written { 0 };
+    std::size_t position { 0 };
+    std::size_t nextTimemark { 0 };
+
+    while (running()) {
+        drain();
+        std::size_t chunk { max_chunk };
+        if (m_bytesPerSecond > 0.) {
+            const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+            const auto target { static_cast<std::uint64_t>(elapsed.count() * m_bytesPerSecond) };
+            if (target <= written) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            chunk = static_cast<std::size_t>(std::min<std::uint64_t>(target - written, max_chunk));
+        }
+        chunk = std::min(chunk, m_recording.size() - position);
+        const ssize_t result { ::write(m_master, m_recording.data() + position, chunk) };
+        if (result < 0) {
+            if (errno != EAGAIN && errno != EINTR) {
+                break;
+            }
+            // the daemon does not keep up, wait until it reads from the port
+            pollfd fd { m_master, POLLOUT, 0 };
+            ::poll(&fd, 1, 10);
+            continue;
+        }
+        position += static_cast<std::size_t>(result);
+        written += static_cast<std::uint64_t>(result);
+        m_injectedBytes.fetch_add(static_cast<std::uint64_t>(result), std::memory_order_relaxed);
+        while (nextTimemark < m_timemarkEnds.size() && m_timemarkEnds[nextTimemark] <= position) {
+            nextTimemark++;
+            m_injectedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (position == m_recording.size()) {
+            if (!m_loop) {
+                break;
+            }
+            position = 0;
+            nextTimemark = 0;
+        }
+    }
+}
+
+} // namespace MuonPi::Benchmark
@@ -1,7 +1,9 @@
 #include <QNetworkInterface>
 #include <QThread>
 #include <QtNetwork>
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <config.h>
 #include <daemon.h>
 #include "utility/geohash.h"
@@ -9,6 +11,7 @@
 #include <gpio_pin_definitions.h>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <locale>
 #include <logengine.h>
 #include <muondetector_structs.h>
@@ -181,7 +184,9 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     qRegisterMetaType<GnssMonHwStruct>("GnssMonHwStruct");
     qRegisterMetaType<GnssMonHw2Struct>("GnssMonHw2Struct");
     qRegisterMetaType<UbxTimeMarkStruct>("UbxTimeMarkStruct");
+    qRegisterMetaType<MuonPi::EventRecord>("MuonPi::EventRecord");
     qRegisterMetaType<I2cDeviceEntry>("I2cDeviceEntry");
+    qRegisterMetaType<qintptr>("qintptr");
 
     // signal handling
     setup_unix_signal_handlers();
@@ -264,6 +269,7 @@ Daemon::Daemon(configuration cfg, QObject* parent)
 
     // set up the pin definitions (hw version specific)
     GPIO_PINMAP = GPIO_PINMAP_VERSIONS[HW_VERSION];
+    setGpioHardwareVersion(HW_VERSION);
 
     if (verbose > 1) {
         // print out the current gpio pin mapping
@@ -295,12 +301,14 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     connect(this, &Daemon::aboutToQuit, mqttHandlerThread, &QThread::quit);
     connect(mqttHandlerThread, &QThread::finished, mqttHandlerThread, &QThread::deleteLater);
 
-    mqttHandler = new MuonPi::MqttHandler(cfg.station_ID, verbose - 1);
+    mqttHandler = new MuonPi::MqttHandler(cfg.station_ID, verbose - 1, cfg.mqtt);
     mqttHandler->moveToThread(mqttHandlerThread);
     connect(mqttHandler, &MuonPi::MqttHandler::mqttConnectionStatus, this, &Daemon::sendMqttStatus);
     connect(mqttHandler, &MuonPi::MqttHandler::giving_up, this, &Daemon::handleSigTerm);
     connect(fileHandlerThread, &QThread::finished, mqttHandler, &MuonPi::MqttHandler::deleteLater);
     connect(this, &Daemon::requestMqttConnectionStatus, mqttHandler, &MuonPi::MqttHandler::onRequestConnectionStatus);
+    connect(this, &Daemon::requestMqttQueueStatus, mqttHandler, &MuonPi::MqttHandler::onRequestQueueStatus);
+    connect(mqttHandler, &MuonPi::MqttHandler::queueStatus, this, &Daemon::onMqttQueueStatus);
     mqttHandlerThread->start();
 
     // create fileHandler
@@ -345,13 +353,33 @@ Daemon::Daemon(configuration cfg, QObject* parent)
         adc->setAGC(false);
         if (!adc->setDataReadyPinMode()) {
             qWarning() << "error: failed setting data ready pin mode (setting thresh regs)";
+        } else {
+            adc->setReadyInterrupt(MuonPi::Config::Hardware::ADC::ReadyInterrupt::enabled);
         }
 
-        // set up sampling timer used for continuous sampling mode
-        samplingTimer.setInterval(MuonPi::Config::Hardware::trace_sampling_interval);
-        samplingTimer.setSingleShot(false);
-        samplingTimer.setTimerType(Qt::PreciseTimer);
-        connect(&samplingTimer, &QTimer::timeout, this, &Daemon::sampleAdc0TraceEvent);
+        // conversions triggered by events run on the i2c bus thread, so that they do not block the event processing
+        AdcSampler* adcSampler { new AdcSampler(adc, &i2cScheduler, this) };
+        connect(this, &Daemon::requestAdcPeakSample, adcSampler, &AdcSampler::samplePeak);
+        connect(this, &Daemon::requestAdcChannelSample, adcSampler, &AdcSampler::sampleChannel);
+        connect(adcSampler, &AdcSampler::peakSampled, this, &Daemon::onAdcPeakSampled);
+        connect(adcSampler, &AdcSampler::channelSampled, this, &Daemon::onAdcChannelSampled);
+
+        // traces are recorded in continuous conversion mode, which occupies its thread while the trace mode is active
+        adcTraceThread = new QThread();
+        adcTraceThread->setObjectName("muondetector-daemon-adctrace");
+        adcTraceEngine = new AdcTraceEngine(adc);
+        adcTraceEngine->moveToThread(adcTraceThread);
+        connect(this, &Daemon::aboutToQuit, this, [this]() {
+            AdcTraceEngine* engine { adcTraceEngine };
+            adcTraceEngine = nullptr;
+            engine->stop();
+            adcTraceThread->quit();
+        });
+        connect(adcTraceThread, &QThread::finished, adcTraceThread, &QThread::deleteLater);
+        connect(adcTraceThread, &QThread::finished, adcTraceEngine, &AdcTraceEngine::deleteLater);
+        connect(this, &Daemon::startAdcTrace, adcTraceEngine, &AdcTraceEngine::run);
+        connect(adcTraceEngine, &AdcTraceEngine::traceCaptured, this, &Daemon::onAdcTraceCaptured);
+        adcTraceThread->start();
 
         // set up peak sampling mode
         setAdcSamplingMode(ADC_MODE_PEAK);
@@ -385,15 +413,13 @@ Daemon::Daemon(configuration cfg, QObject* parent)
         if (verbose > 2) {
             qInfo() << "MCP4728 device is present.";
             qDebug() << "DAC registers / output voltages:";
+            MCP4728::DacChannel dacChannels[4];
+            MCP4728::DacChannel eepromChannels[4];
+            dac->readChannels(dacChannels, eepromChannels);
             for (int i = 0; i < 4; i++) {
-                MCP4728::DacChannel dacChannel;
-                MCP4728::DacChannel eepromChannel;
-                eepromChannel.eeprom = true;
-                dac->readChannel(i, dacChannel);
-                dac->readChannel(i, eepromChannel);
-                qDebug() << "  ch" << i << ": " << dacChannel.value << " = " << MCP4728::code2voltage(dacChannel) << " V"
-                                                                                                                     "  (stored: "
-                         << eepromChannel.value << " = " << MCP4728::code2voltage(eepromChannel) << " V)";
+                qDebug() << "  ch" << i << ": " << dacChannels[i].value << " = " << MCP4728::code2voltage(dacChannels[i]) << " V"
+                                                                                                                           "  (stored: "
+                         << eepromChannels[i].value << " = " << MCP4728::code2voltage(eepromChannels[i]) << " V)";
             }
             qDebug() << "readout took " << dac->getLastTimeInterval() << " ms";
         }
@@ -407,10 +433,7 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     for (int i = std::min(DAC_TH1, DAC_TH2); i <= std::max(DAC_TH1, DAC_TH2); i++) {
         if (cfg.dacThresh[i] < 0. && dac->devicePresent()) {
             MCP4728::DacChannel dacChannel;
-            MCP4728::DacChannel eepromChannel;
-            eepromChannel.eeprom = true;
             dac->readChannel(i, dacChannel);
-            dac->readChannel(i, eepromChannel);
             cfg.dacThresh[i] = MCP4728::code2voltage(dacChannel);
         }
     }
@@ -431,10 +454,7 @@ Daemon::Daemon(configuration cfg, QObject* parent)
     biasVoltage = cfg.biasVoltage;
     if (biasVoltage < 0. && dac->devicePresent()) {
         MCP4728::DacChannel dacChannel;
-        MCP4728::DacChannel eepromChannel;
-        eepromChannel.eeprom = true;
         dac->readChannel(DAC_BIAS, dacChannel);
-        dac->readChannel(DAC_BIAS, eepromChannel);
         biasVoltage = MCP4728::code2voltage(dacChannel);
     }
 
@@ -560,6 +580,27 @@ Daemon::Daemon(configuration cfg, QObject* parent)
         // maybe think about other fall back solution
         daemonPort = MuonPi::Settings::gui.port;
     }
+    // all tcp clients are served by the connection manager in its own thread
+    tcpThread = new QThread();
+    tcpThread->setObjectName("muondetector-daemon-tcp");
+    connectionManager = new ConnectionManager(verbose);
+    connectionManager->moveToThread(tcpThread);
+    connect(this, &Daemon::aboutToQuit, connectionManager, &ConnectionManager::closeAll);
+    connect(connectionManager, &ConnectionManager::finished, tcpThread, &QThread::quit);
+    connect(tcpThread, &QThread::finished, tcpThread, &QThread::deleteLater);
+    connect(tcpThread, &QThread::finished, connectionManager, &ConnectionManager::deleteLater);
+    connect(this, &Daemon::acceptConnection, connectionManager, &ConnectionManager::addConnection);
+    connect(this, &Daemon::sendTcpMessage, connectionManager, &ConnectionManager::sendTcpMessage);
+    connect(this, &Daemon::sendHistogramMessage, connectionManager, &ConnectionManager::sendHistogram);
+    connect(this, &Daemon::sendHistogramDeltaMessage, connectionManager, &ConnectionManager::sendHistogramDelta);
+    connect(connectionManager, &ConnectionManager::histogramsSubscribed, this, &Daemon::onHistogramsSubscribed);
+    connect(connectionManager, &ConnectionManager::histogramResyncRequired, this, &Daemon::onHistogramResyncRequired);
+    connect(connectionManager, &ConnectionManager::receivedTcpMessage, this, &Daemon::receivedTcpMessage);
+    connect(connectionManager, &ConnectionManager::toConsole, this, &Daemon::toConsole);
+    connect(connectionManager, &ConnectionManager::madeConnection, this, &Daemon::onMadeConnection);
+    connect(connectionManager, &ConnectionManager::connectionTimeout, this, &Daemon::onStoppedConnection);
+    tcpThread->start();
+
     if (!this->listen(daemonAddress, daemonPort)) {
         qCritical() << tr("Unable to start the server: %1.\n").arg(this->errorString());
     } else {
@@ -576,6 +617,7 @@ Daemon::Daemon(configuration cfg, QObject* parent)
 
     // set up histograms
     setupHistos();
+    setupProperties();
 
     // establish ublox gnss module connection
     connectToGps();
@@ -599,6 +641,8 @@ Daemon::Daemon(configuration cfg, QObject* parent)
 
 Daemon::~Daemon()
 {
+    // no transaction may access the devices deleted below
+    i2cScheduler.stop();
     snHup.clear();
     snTerm.clear();
     snInt.clear();
@@ -610,6 +654,9 @@ Daemon::~Daemon()
         delete dac;
         dac = nullptr;
     }
+    if (adcTraceThread && !adcTraceThread->wait(2000)) {
+        qWarning() << "Timeout waiting for thread " + adcTraceThread->objectName();
+    }
     if (adc != nullptr) {
         delete adc;
         adc = nullptr;
@@ -664,15 +711,15 @@ void Daemon::connectToPigpiod()
 
     //pighandler <-> tdc
     connect(pigHandler, &PigpiodHandler::spiData, tdc7200, &TDC7200::onDataReceived);
-    connect(pigHandler, &PigpiodHandler::signal, tdc7200, &TDC7200::onDataAvailable);
+    connect(this, &Daemon::tdcInterrupt, tdc7200, &TDC7200::onDataAvailable);
     connect(tdc7200, &TDC7200::readData, pigHandler, &PigpiodHandler::readSpi);
     connect(tdc7200, &TDC7200::writeData, pigHandler, &PigpiodHandler::writeSpi);
 
     //tdc <-> thread & daemon
     connect(tdc7200, &TDC7200::tdcEvent, this, [this](double usecs) {
-        if (histoMap.find("Time-to-Digital Time Diff") != histoMap.end()) {
-            checkRescaleHisto(histoMap["Time-to-Digital Time Diff"], usecs);
-            histoMap["Time-to-Digital Time Diff"].fill(usecs);
+        if (histoHandle.tdcTimeDiff != HistoRegistry::invalid_handle) {
+            checkRescaleHisto(histoMap[histoHandle.tdcTimeDiff], usecs);
+            histoMap[histoHandle.tdcTimeDiff].fill(usecs);
         }
     });
     connect(tdc7200, &TDC7200::statusUpdated, this, [this](bool isPresent) {
@@ -691,24 +738,30 @@ void Daemon::connectToPigpiod()
     connect(this, &Daemon::GpioSetPullDown, pigHandler, &PigpiodHandler::setPullDown);
     connect(this, &Daemon::GpioSetState, pigHandler, &PigpiodHandler::setGpioState);
     connect(this, &Daemon::GpioRegisterForCallback, pigHandler, &PigpiodHandler::registerForCallback);
-    connect(pigHandler, &PigpiodHandler::signal, this, &Daemon::sendGpioPinEvent);
+    // all gpio events are delivered through the lock-free event buffer of the pigpio handler
+    // and drained here in batches
+    connect(pigHandler, &PigpiodHandler::eventsAvailable, this, &Daemon::onGpioEventsAvailable);
     connect(pigHandler, &PigpiodHandler::samplingTrigger, this, &Daemon::sampleAdc0Event);
-    connect(pigHandler, &PigpiodHandler::eventInterval, this, [this](quint64 nsecs) {
-        if (histoMap.find("gpioEventInterval") != histoMap.end()) {
-            checkRescaleHisto(histoMap["gpioEventInterval"], 1e-6 * nsecs);
-            histoMap["gpioEventInterval"].fill(1e-6 * nsecs);
-        }
-    });
-    connect(pigHandler, &PigpiodHandler::eventInterval, this, [this](quint64 nsecs) {
-        if (histoMap.find("gpioEventIntervalShort") != histoMap.end()) {
-            if (nsecs / 1000 <= histoMap["gpioEventIntervalShort"].getMax())
-                histoMap["gpioEventIntervalShort"].fill((double)nsecs / 1000.);
-        }
-    });
+    // the trace engine marks the trigger position without a detour through the event loop
+    connect(
+        pigHandler, &PigpiodHandler::samplingTrigger, this, [this]() {
+            if (adcTraceEngine != nullptr) {
+                adcTraceEngine->trigger();
+            }
+        },
+        Qt::DirectConnection);
+    // wakes up the conversion in the adc thread directly from the pigpio callback
+    connect(
+        pigHandler, &PigpiodHandler::adcConversionReady, this, [this]() {
+            if (adc != nullptr) {
+                adc->conversionReady();
+            }
+        },
+        Qt::DirectConnection);
     connect(pigHandler, &PigpiodHandler::timePulseDiff, this, [this](qint32 usecs) {
-        if (histoMap.find("TPTimeDiff") != histoMap.end()) {
-            checkRescaleHisto(histoMap["TPTimeDiff"], usecs);
-            histoMap["TPTimeDiff"].fill((double)usecs);
+        if (histoHandle.tpTimeDiff != HistoRegistry::invalid_handle) {
+            checkRescaleHisto(histoMap[histoHandle.tpTimeDiff], usecs);
+            histoMap[histoHandle.tpTimeDiff].fill((double)usecs);
         }
     });
     pigHandler->setSamplingTriggerSignal(eventTrigger);
@@ -720,17 +773,15 @@ void Daemon::connectToPigpiod()
         qInfo() << "the timing resolution of the system clock is " << ts_res.tv_nsec << " ns";
     }
 
-    timespec_get(&lastRateInterval, TIME_UTC);
-    startOfProgram = lastRateInterval;
-    connect(pigHandler, &PigpiodHandler::signal, this, [this](uint8_t gpio_pin) {
-        rateCounterIntervalActualisation();
-        if (gpio_pin == GPIO_PINMAP[EVT_XOR]) {
-            xorCounts.back()++;
-        }
-        if (gpio_pin == GPIO_PINMAP[EVT_AND]) {
-            andCounts.back()++;
-        }
-    });
+    timespec_get(&startOfProgram, TIME_UTC);
+
+    // gpio events are collected and sent to the gui in batches
+    // flushed either when the batch is full or the flush window expired
+    config.gpioEventBatchSize = std::clamp(config.gpioEventBatchSize, 1, MuonPi::Config::Hardware::GPIO::EventBatch::max_events_limit);
+    gpioEventBatch.reserve(config.gpioEventBatchSize);
+    gpioEventFlushTimer.setSingleShot(true);
+    gpioEventFlushTimer.setInterval(std::max(config.gpioEventFlushWindow, 0));
+    connect(&gpioEventFlushTimer, &QTimer::timeout, this, &Daemon::flushGpioEventBatch);
     pigThread->start();
     rateBufferReminder.setInterval(rateBufferInterval);
     rateBufferReminder.setSingleShot(false);
@@ -772,17 +823,25 @@ void Daemon::connectToGps()
 {
     // before connecting to gps we have to make sure all other programs are closed
     // and serial echo is off
-    if (gpsdevname.isEmpty()) {
+    const bool replay { !config.ubxReplayFile.isEmpty() };
+    if (gpsdevname.isEmpty() && !replay) {
         return;
     }
-    QProcess prepareSerial;
-    QString command = "stty";
-    QStringList args = { "-F", "/dev/ttyAMA0", "-echo", "-onlcr" };
-    prepareSerial.start(command, args, QIODevice::ReadWrite);
-    prepareSerial.waitForFinished();
+    if (!replay) {
+        QProcess prepareSerial;
+        QString command = "stty";
+        QStringList args = { "-F", "/dev/ttyAMA0", "-echo", "-onlcr" };
+        prepareSerial.start(command, args, QIODevice::ReadWrite);
+        prepareSerial.waitForFinished();
+    }
 
     // here is where the magic threading happens look closely
     qtGps = new QtSerialUblox(gpsdevname, gpsTimeout, baudrate, dumpRaw, verbose - 1, showout, showin);
+    if (replay) {
+        qtGps->setReplayFile(config.ubxReplayFile, (config.ubxReplayUnpaced) ? QtSerialUblox::ReplaySpeed::Unpaced : QtSerialUblox::ReplaySpeed::WireSpeed);
+    } else if (!config.ubxCaptureFile.isEmpty()) {
+        qtGps->setCaptureFile(config.ubxCaptureFile);
+    }
     gpsThread = new QThread();
     gpsThread->setObjectName("muondetector-daemon-gnss");
     qtGps->moveToThread(gpsThread);
@@ -793,6 +852,9 @@ void Daemon::connectToGps()
     connect(gpsThread, &QThread::finished, qtGps, &QtSerialUblox::deleteLater);
     // connect all signals not coming from Daemon to gps
     connect(qtGps, &QtSerialUblox::toConsole, this, &Daemon::gpsToConsole);
+    connect(qtGps, &QtSerialUblox::replayFinished, this, [this]() {
+        qInfo() << "replay of the gps capture" << config.ubxReplayFile << "finished, no more gps data will arrive";
+    });
     connect(gpsThread, &QThread::started, qtGps, &QtSerialUblox::makeConnection);
     connect(qtGps, &QtSerialUblox::gpsRestart, this, &Daemon::connectToGps);
     // connect all command signals for ublox module here
@@ -825,19 +887,24 @@ void Daemon::connectToGps()
     connect(this, &Daemon::UBXSetMinCNO, qtGps, &QtSerialUblox::UBXSetMinCNO);
     connect(this, &Daemon::UBXSetAopCfg, qtGps, &QtSerialUblox::UBXSetAopCfg);
     connect(this, &Daemon::UBXSaveCfg, qtGps, &QtSerialUblox::UBXSaveCfg);
+    connect(this, &Daemon::requestUbxMessageStatistics, qtGps, &QtSerialUblox::reportMessageStatistics);
     connect(qtGps, &QtSerialUblox::UBXReceivedTimeTM2, this, &Daemon::onUBXReceivedTimeTM2);
+    connect(qtGps, &QtSerialUblox::UBXStreamErrors, this, [this](quint64 checksumErrors, quint64 resyncs) {
+        emit logParameter(LogParameter("ubxChecksumErrors", checksumErrors, "", LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter("ubxResyncs", resyncs, "", LogParameter::LOG_LATEST));
+    });
 
     connect(qtGps, &QtSerialUblox::UBXReceivedDops, this, [this](const UbxDopStruct& dops) {
         currentDOP = dops;
-        emit logParameter(LogParameter("positionDOP", QString::number(dops.pDOP / 100.), LogParameter::LOG_AVERAGE));
-        emit logParameter(LogParameter("timeDOP", QString::number(dops.tDOP / 100.), LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("positionDOP", dops.pDOP / 100., "", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("timeDOP", dops.tDOP / 100., "", LogParameter::LOG_AVERAGE));
     });
 
     // connect fileHandler related stuff
     if (fileHandler != nullptr) {
         //connect(qtGps, &QtSerialUblox::timTM2, fileHandler, &FileHandler::writeToDataFile);
         if (config.storeLocal) {
-            connect(this, &Daemon::eventMessage, fileHandler, &FileHandler::writeToDataFile);
+            connect(this, &Daemon::eventRecord, fileHandler, &FileHandler::writeEventRecord);
         }
         //connect(qtGps, &QtSerialUblox::timTM2, mqttHandler, &MuonPi::MqttHandler::sendData);
         connect(this, &Daemon::eventMessage, mqttHandler, &MuonPi::MqttHandler::sendData);
@@ -851,81 +918,76 @@ void Daemon::incomingConnection(qintptr socketDescriptor)
     if (verbose > 4) {
         qDebug() << "incoming connection";
     }
-    tcpThread = new QThread();
-    tcpThread->setObjectName("muondetector-daemon-tcp");
-    tcpConnection = new TcpConnection(socketDescriptor, verbose);
-    tcpConnection->moveToThread(tcpThread);
-    // connect all signals about quitting
-    connect(this, &Daemon::aboutToQuit, tcpConnection, &TcpConnection::closeThisConnection);
-    connect(this, &Daemon::closeConnection, tcpConnection, &TcpConnection::closeConnection);
-    connect(tcpConnection, &TcpConnection::finished, tcpThread, &QThread::quit);
-    connect(tcpThread, &QThread::finished, tcpThread, &QThread::deleteLater);
-    connect(tcpThread, &QThread::finished, tcpConnection, &TcpConnection::deleteLater);
-    // connect all other signals
-    connect(tcpThread, &QThread::started, tcpConnection, &TcpConnection::receiveConnection);
-    connect(this, &Daemon::sendTcpMessage, tcpConnection, &TcpConnection::sendTcpMessage);
-    connect(tcpConnection, &TcpConnection::receivedTcpMessage, this, &Daemon::receivedTcpMessage);
-    connect(tcpConnection, &TcpConnection::toConsole, this, &Daemon::toConsole);
-    connect(tcpConnection, &TcpConnection::madeConnection, this, &Daemon::onMadeConnection);
-    connect(tcpConnection, &TcpConnection::connectionTimeout, this, &Daemon::onStoppedConnection);
-    tcpThread->start();
+    emit acceptConnection(socketDescriptor);
 
     pollAllUbxMsgRate();
     emit requestMqttConnectionStatus();
 }
 
 // Histogram functions
+void Daemon::setupProperties()
+{
+    propertyHandle.nrSats = propertyMap.insert("nrSats");
+    propertyHandle.visSats = propertyMap.insert("visSats");
+    propertyHandle.usedSats = propertyMap.insert("usedSats");
+    propertyHandle.maxCNR = propertyMap.insert("maxCNR");
+    propertyHandle.fixStatus = propertyMap.insert("fixStatus");
+    propertyHandle.events = propertyMap.insert("events");
+    propertyHandle.clkDrift = propertyMap.insert("clkDrift");
+    propertyHandle.clkBias = propertyMap.insert("clkBias");
+}
+
 void Daemon::setupHistos()
 {
     Histogram hist = Histogram("geoHeight", 200, 0., 199.);
     hist.setUnit("m");
-    histoMap["geoHeight"] = hist;
+    histoHandle.geoHeight = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("geoLongitude", 200, 0., 0.003);
     hist.setUnit("deg");
-    histoMap["geoLongitude"] = hist;
+    histoHandle.geoLongitude = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("geoLatitude", 200, 0., 0.003);
     hist.setUnit("deg");
-    histoMap["geoLatitude"] = hist;
+    histoHandle.geoLatitude = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("weightedGeoHeight", 200, 0., 199.);
     hist.setUnit("m");
-    histoMap["weightedGeoHeight"] = hist;
+    histoHandle.weightedGeoHeight = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("pulseHeight", 500, 0., 3.8);
     hist.setUnit("V");
-    histoMap["pulseHeight"] = hist;
+    histoHandle.pulseHeight = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("adcSampleTime", 500, 0., 49.9);
     hist.setUnit("ms");
-    histoMap["adcSampleTime"] = hist;
+    histoHandle.adcSampleTime = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("UbxEventLength", 100, 50., 149.);
     hist.setUnit("ns");
-    histoMap["UbxEventLength"] = hist;
+    histoHandle.ubxEventLength = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("gpioEventInterval", 400, 0., 1500.);
     hist.setUnit("ms");
-    histoMap["gpioEventInterval"] = hist;
+    histoHandle.gpioEventInterval = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("gpioEventIntervalShort", 50, 0., 49.);
     hist.setUnit("us");
-    histoMap["gpioEventIntervalShort"] = hist;
+    histoHandle.gpioEventIntervalShort = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("UbxEventInterval", 200, 0., 1100.);
     hist.setUnit("ms");
-    histoMap["UbxEventInterval"] = hist;
+    histoHandle.ubxEventInterval = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("TPTimeDiff", 200, -999., 1000.);
     hist.setUnit("us");
-    histoMap["TPTimeDiff"] = hist;
+    histoHandle.tpTimeDiff = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("Time-to-Digital Time Diff", 400, 0., 1e6);
     hist.setUnit("ns");
-    histoMap["Time-to-Digital Time Diff"] = hist;
+    histoHandle.tdcTimeDiff = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("Bias Voltage", 500, 0., 1.);
     hist.setUnit("V");
-    histoMap["Bias Voltage"] = hist;
+    histoHandle.biasVoltage = histoMap.insert(QString::fromStdString(hist.getName()), hist);
     hist = Histogram("Bias Current", 200, 0., 50.);
     hist.setUnit("uA");
-    histoMap["Bias Current"] = hist;
+    histoHandle.biasCurrent = histoMap.insert(QString::fromStdString(hist.getName()), hist);
 }
 
 void Daemon::clearHisto(const QString& histoName)
 {
-    if (histoMap.find(histoName) != histoMap.end()) {
-        histoMap[histoName].clear();
-        emit sendHistogram(histoMap[histoName]);
+    if (Histogram* hist = histoMap.find(histoName)) {
+        hist->clear();
+        emit sendHistogram(*hist);
     }
     return;
 }
@@ -982,7 +1044,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     if (msgID == TCP_MSG_KEY::MSG_THRESHOLD) {
         uint8_t channel;
         float threshold;
-        *(tcpMessage.dStream) >> channel >> threshold;
+        tcpMessage.stream() >> channel >> threshold;
         if (threshold < 0.001) {
             if (verbose > 2)
                 qWarning() << "setting DAC " << channel << " to 0!";
@@ -999,10 +1061,10 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_BIAS_VOLTAGE) {
         float voltage;
-        *(tcpMessage.dStream) >> voltage;
+        tcpMessage.stream() >> voltage;
         setBiasVoltage(voltage);
-        if (histoMap.find("pulseHeight") != histoMap.end())
-            histoMap["pulseHeight"].clear();
+        if (histoHandle.pulseHeight != HistoRegistry::invalid_handle)
+            histoMap[histoHandle.pulseHeight].clear();
         sendBiasVoltage();
         return;
     }
@@ -1012,7 +1074,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_BIAS_SWITCH) {
         bool status;
-        *(tcpMessage.dStream) >> status;
+        tcpMessage.stream() >> status;
         setBiasStatus(status);
         sendBiasStatus();
         return;
@@ -1023,7 +1085,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     if (msgID == TCP_MSG_KEY::MSG_PREAMP_SWITCH) {
         quint8 channel;
         bool status;
-        *(tcpMessage.dStream) >> channel >> status;
+        tcpMessage.stream() >> channel >> status;
         if (channel == 0) {
             preampStatus[0] = status;
             emit GpioSetState(GPIO_PINMAP[PREAMP_1], status);
@@ -1043,7 +1105,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_POLARITY_SWITCH) {
         bool pol1, pol2;
-        *(tcpMessage.dStream) >> pol1 >> pol2;
+        tcpMessage.stream() >> pol1 >> pol2;
         if (HW_VERSION >= 3 && pol1 != polarity1) {
             polarity1 = pol1;
             emit GpioSetState(GPIO_PINMAP[IN_POL1], polarity1);
@@ -1061,11 +1123,11 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_GAIN_SWITCH) {
         bool status;
-        *(tcpMessage.dStream) >> status;
+        tcpMessage.stream() >> status;
         gainSwitch = status;
         emit GpioSetState(GPIO_PINMAP[GAIN_HL], status);
-        if (histoMap.find("pulseHeight") != histoMap.end())
-            histoMap["pulseHeight"].clear();
+        if (histoHandle.pulseHeight != HistoRegistry::invalid_handle)
+            histoMap[histoHandle.pulseHeight].clear();
         emit logParameter(LogParameter("gainSwitch", QString::number((int)gainSwitch), LogParameter::LOG_EVERY));
         sendGainSwitchStatus();
         return;
@@ -1090,16 +1152,16 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_MSG_RATE) {
         QMap<uint16_t, int> ubxMsgRates;
-        *(tcpMessage.dStream) >> ubxMsgRates;
+        tcpMessage.stream() >> ubxMsgRates;
         setUbxMsgRates(ubxMsgRates);
     }
     if (msgID == TCP_MSG_KEY::MSG_PCA_SWITCH) {
         quint8 portMask;
-        *(tcpMessage.dStream) >> portMask;
+        tcpMessage.stream() >> portMask;
         setPcaChannel((uint8_t)portMask);
         sendPcaChannel();
-        if (histoMap.find("UbxEventLength") != histoMap.end())
-            histoMap["UbxEventLength"].clear();
+        if (histoHandle.ubxEventLength != HistoRegistry::invalid_handle)
+            histoMap[histoHandle.ubxEventLength].clear();
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_PCA_SWITCH_REQUEST) {
@@ -1108,7 +1170,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_EVENTTRIGGER) {
         unsigned int signal;
-        *(tcpMessage.dStream) >> signal;
+        tcpMessage.stream() >> signal;
         setEventTriggerSelection((GPIO_PIN)signal);
         usleep(1000);
         sendEventTriggerSelection();
@@ -1121,7 +1183,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     if (msgID == TCP_MSG_KEY::MSG_GPIO_RATE_REQUEST) {
         quint8 whichRate;
         quint16 number;
-        *(tcpMessage.dStream) >> number >> whichRate;
+        tcpMessage.stream() >> number >> whichRate;
         sendGpioRates(number, whichRate);
     }
     if (msgID == TCP_MSG_KEY::MSG_GPIO_RATE_RESET) {
@@ -1130,7 +1192,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_DAC_REQUEST) {
         quint8 channel;
-        *(tcpMessage.dStream) >> channel;
+        tcpMessage.stream() >> channel;
         MCP4728::DacChannel channelData;
         if (!dac->devicePresent())
             return;
@@ -1140,7 +1202,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_ADC_SAMPLE_REQUEST) {
         quint8 channel;
-        *(tcpMessage.dStream) >> channel;
+        tcpMessage.stream() >> channel;
         sampleAdcEvent(channel);
     }
     if (msgID == TCP_MSG_KEY::MSG_TEMPERATURE_REQUEST) {
@@ -1167,10 +1229,10 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     if (msgID == TCP_MSG_KEY::MSG_CALIB_SET) {
         std::vector<CalibStruct> calibs;
         quint8 nrEntries = 0;
-        *(tcpMessage.dStream) >> nrEntries;
+        tcpMessage.stream() >> nrEntries;
         for (int i = 0; i < nrEntries; i++) {
             CalibStruct item;
-            *(tcpMessage.dStream) >> item;
+            tcpMessage.stream() >> item;
             calibs.push_back(item);
         }
         receivedCalibItems(calibs);
@@ -1178,10 +1240,10 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     if (msgID == TCP_MSG_KEY::MSG_UBX_GNSS_CONFIG) {
         std::vector<GnssConfigStruct> configs;
         int nrEntries = 0;
-        *(tcpMessage.dStream) >> nrEntries;
+        tcpMessage.stream() >> nrEntries;
         for (int i = 0; i < nrEntries; i++) {
             GnssConfigStruct config;
-            *(tcpMessage.dStream) >> config.gnssId >> config.resTrkCh >> config.maxTrkCh >> config.flags;
+            tcpMessage.stream() >> config.gnssId >> config.resTrkCh >> config.maxTrkCh >> config.flags;
             configs.push_back(config);
         }
         emit setGnssConfig(configs);
@@ -1190,7 +1252,7 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_CFG_TP5) {
         UbxTimePulseStruct tp;
-        *(tcpMessage.dStream) >> tp;
+        tcpMessage.stream() >> tp;
         emit UBXSetCfgTP5(tp);
         emit sendPollUbxMsg(UBX_CFG_TP5);
         return;
@@ -1201,30 +1263,25 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
         emit sendPollUbxMsg(UBX_CFG_GNSS);
         return;
     }
-    if (msgID == TCP_MSG_KEY::MSG_QUIT_CONNECTION) {
-        QString closeAddress;
-        *(tcpMessage.dStream) >> closeAddress;
-        emit closeConnection(closeAddress);
-    }
     if (msgID == TCP_MSG_KEY::MSG_DAC_EEPROM_SET) {
         saveDacValuesToEeprom();
     }
     if (msgID == TCP_MSG_KEY::MSG_HISTOGRAM_CLEAR) {
         QString histoName;
-        *(tcpMessage.dStream) >> histoName;
+        tcpMessage.stream() >> histoName;
         clearHisto(histoName);
     }
     if (msgID == TCP_MSG_KEY::MSG_ADC_MODE_REQUEST) {
         TcpMessage answer(TCP_MSG_KEY::MSG_ADC_MODE);
-        *(answer.dStream) << (quint8)adcSamplingMode;
+        answer.stream() << (quint8)adcSamplingMode;
         emit sendTcpMessage(answer);
     }
     if (msgID == TCP_MSG_KEY::MSG_ADC_MODE) {
         quint8 mode = 0;
-        *(tcpMessage.dStream) >> mode;
+        tcpMessage.stream() >> mode;
         setAdcSamplingMode(mode);
         TcpMessage answer(TCP_MSG_KEY::MSG_ADC_MODE);
-        *(answer.dStream) << (quint8)adcSamplingMode;
+        answer.stream() << (quint8)adcSamplingMode;
         emit sendTcpMessage(answer);
     }
     if (msgID == TCP_MSG_KEY::MSG_LOG_INFO) {
@@ -1232,12 +1289,12 @@ void Daemon::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_RATE_SCAN) {
         quint8 channel = 0;
-        *(tcpMessage.dStream) >> channel;
+        tcpMessage.stream() >> channel;
         startRateScan(channel);
     }
     if (msgID == TCP_MSG_KEY::MSG_GPIO_INHIBIT) {
         bool inhibit = true;
-        *(tcpMessage.dStream) >> inhibit;
+        tcpMessage.stream() >> inhibit;
         if (pigHandler != nullptr)
             pigHandler->setInhibited(inhibit);
     }
@@ -1248,10 +1305,12 @@ void Daemon::setAdcSamplingMode(quint8 mode)
     if (mode > ADC_MODE_TRACE)
         return;
     adcSamplingMode = mode;
+    if (adcTraceEngine == nullptr)
+        return;
     if (mode == ADC_MODE_TRACE)
-        samplingTimer.start();
+        emit startAdcTrace(adcTraceEngine->requestRun());
     else
-        samplingTimer.stop();
+        adcTraceEngine->stop();
 }
 
 void Daemon::scanI2cBus()
@@ -1282,7 +1341,7 @@ void Daemon::sendLogInfo()
     lis.status = (quint8)(fileHandler->dataFileInfo().exists() && fileHandler->logFileInfo().exists());
     lis.logAge = (qint32)fileHandler->currentLogAge();
     TcpMessage answer(TCP_MSG_KEY::MSG_LOG_INFO);
-    *(answer.dStream) << lis;
+    answer.stream() << lis;
     emit sendTcpMessage(answer);
 }
 
@@ -1292,14 +1351,24 @@ void Daemon::sendI2cStats()
     quint8 nrDevices = i2cDevice::getGlobalDeviceList().size();
     quint32 bytesRead = i2cDevice::getGlobalNrBytesRead();
     quint32 bytesWritten = i2cDevice::getGlobalNrBytesWritten();
-    *(tcpMessage.dStream) << nrDevices << bytesRead << bytesWritten;
+    tcpMessage.stream() << nrDevices << bytesRead << bytesWritten;
 
     for (uint8_t i = 0; i < i2cDevice::getGlobalDeviceList().size(); i++) {
-        uint8_t addr = i2cDevice::getGlobalDeviceList()[i]->getAddress();
-        QString title = QString::fromStdString(i2cDevice::getGlobalDeviceList()[i]->getTitle());
-        i2cDevice::getGlobalDeviceList()[i]->devicePresent();
-        uint8_t status = i2cDevice::getGlobalDeviceList()[i]->getStatus();
-        *(tcpMessage.dStream) << addr << title << status;
+        i2cDevice* device = i2cDevice::getGlobalDeviceList()[i];
+        uint8_t addr = device->getAddress();
+        QString title = QString::fromStdString(device->getTitle());
+        device->devicePresent();
+        uint8_t status = device->getStatus();
+        tcpMessage.stream() << addr << title << status;
+    }
+    // the transfer statistics are appended, so that older clients which stop reading after the device list still work
+    quint32 syscalls = i2cDevice::getGlobalNrSyscalls();
+    tcpMessage.stream() << syscalls;
+    for (uint8_t i = 0; i < nrDevices; i++) {
+        i2cDevice* device = i2cDevice::getGlobalDeviceList()[i];
+        tcpMessage.stream() << (quint32)device->getNrBytesRead() << (quint32)device->getNrBytesWritten()
+                            << (quint32)device->getNrIOErrors() << (quint32)device->getNrSyscalls()
+                            << (quint32)(device->getLastTimeInterval() * 1000.);
     }
     emit sendTcpMessage(tcpMessage);
 }
@@ -1307,7 +1376,7 @@ void Daemon::sendI2cStats()
 void Daemon::sendSpiStats()
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_SPI_STATS);
-    *(tcpMessage.dStream) << spiDevicePresent;
+    tcpMessage.stream() << spiDevicePresent;
     emit sendTcpMessage(spiDevicePresent);
 }
 
@@ -1318,9 +1387,9 @@ void Daemon::sendCalib()
     bool eepValid = calib->isEepromValid();
     quint16 nrPars = calib->getCalibList().size();
     quint64 id = calib->getSerialID();
-    *(tcpMessage.dStream) << valid << eepValid << id << nrPars;
+    tcpMessage.stream() << valid << eepValid << id << nrPars;
     for (int i = 0; i < nrPars; i++) {
-        *(tcpMessage.dStream) << calib->getCalibItem(i);
+        tcpMessage.stream() << calib->getCalibItem(i);
     }
     emit sendTcpMessage(tcpMessage);
 }
@@ -1335,56 +1404,121 @@ void Daemon::receivedCalibItems(const std::vector<CalibStruct>& newCalibs)
 void Daemon::onGpsPropertyUpdatedGeodeticPos(const GeodeticPos& pos)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_GEO_POS);
-    (*tcpMessage.dStream) << pos.iTOW << pos.lon << pos.lat
+    tcpMessage.stream() << pos.iTOW << pos.lon << pos.lat
                           << pos.height << pos.hMSL << pos.hAcc
                           << pos.vAcc;
     emit sendTcpMessage(tcpMessage);
 
     QString geohash = GeoHash::hashFromCoordinates(1e-7 * pos.lon, 1e-7 * pos.lat, 10);
 
-    emit logParameter(LogParameter("geoLongitude", QString::number(1e-7 * pos.lon, 'f', 7) + " deg", LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("geoLatitude", QString::number(1e-7 * pos.lat, 'f', 7) + " deg", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("geoLongitude", 1e-7 * pos.lon, "deg", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("geoLatitude", 1e-7 * pos.lat, "deg", LogParameter::LOG_AVERAGE));
     emit logParameter(LogParameter("geoHash", geohash + " ", LogParameter::LOG_LATEST));
-    emit logParameter(LogParameter("geoHeightMSL", QString::number(1e-3 * pos.hMSL, 'f', 2) + " m", LogParameter::LOG_AVERAGE));
-    if (histoMap.find("geoHeight") != histoMap.end())
-        emit logParameter(LogParameter("meanGeoHeightMSL", QString::number(histoMap["geoHeight"].getMean(), 'f', 2) + " m", LogParameter::LOG_LATEST));
-    emit logParameter(LogParameter("geoHorAccuracy", QString::number(1e-3 * pos.hAcc, 'f', 2) + " m", LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("geoVertAccuracy", QString::number(1e-3 * pos.vAcc, 'f', 2) + " m", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("geoHeightMSL", 1e-3 * pos.hMSL, "m", LogParameter::LOG_AVERAGE));
+    if (histoHandle.geoHeight != HistoRegistry::invalid_handle)
+        emit logParameter(LogParameter("meanGeoHeightMSL", QString::number(histoMap[histoHandle.geoHeight].getMean(), 'f', 2) + " m", LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("geoHorAccuracy", 1e-3 * pos.hAcc, "m", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("geoVertAccuracy", 1e-3 * pos.vAcc, "m", LogParameter::LOG_AVERAGE));
 
     if (1e-3 * pos.vAcc < 100.) {
-        QString name = "geoHeight";
-        if (histoMap.find(name) != histoMap.end()) {
-            checkRescaleHisto(histoMap[name], 1e-3 * pos.hMSL);
-            histoMap[name].fill(1e-3 * pos.hMSL);
+        if (histoHandle.geoHeight != HistoRegistry::invalid_handle) {
+            checkRescaleHisto(histoMap[histoHandle.geoHeight], 1e-3 * pos.hMSL);
+            histoMap[histoHandle.geoHeight].fill(1e-3 * pos.hMSL);
             if (currentDOP.vDOP > 0) {
-                name = "weightedGeoHeight";
                 double heightWeight = 100. / currentDOP.vDOP;
-                checkRescaleHisto(histoMap[name], 1e-3 * pos.hMSL);
-                histoMap[name].fill(1e-3 * pos.hMSL, heightWeight);
+                checkRescaleHisto(histoMap[histoHandle.weightedGeoHeight], 1e-3 * pos.hMSL);
+                histoMap[histoHandle.weightedGeoHeight].fill(1e-3 * pos.hMSL, heightWeight);
             }
         }
     }
     if (1e-3 * pos.hAcc < 100.) {
-        QString name = "geoLongitude";
-        checkRescaleHisto(histoMap[name], 1e-7 * pos.lon);
-        histoMap[name].fill(1e-7 * pos.lon);
-        name = "geoLatitude";
-        checkRescaleHisto(histoMap[name], 1e-7 * pos.lat);
-        histoMap[name].fill(1e-7 * pos.lat);
+        checkRescaleHisto(histoMap[histoHandle.geoLongitude], 1e-7 * pos.lon);
+        histoMap[histoHandle.geoLongitude].fill(1e-7 * pos.lon);
+        checkRescaleHisto(histoMap[histoHandle.geoLatitude], 1e-7 * pos.lat);
+        histoMap[histoHandle.geoLatitude].fill(1e-7 * pos.lat);
     }
 }
 
-void Daemon::sendHistogram(const Histogram& hist)
+void Daemon::sendHistogram(Histogram& hist)
 {
-    TcpMessage tcpMessage(TCP_MSG_KEY::MSG_HISTOGRAM);
-    (*tcpMessage.dStream) << hist;
-    emit sendTcpMessage(tcpMessage);
+    const QString name { QString::fromStdString(hist.getName()) };
+    HistogramTransport& transport { histoTransport[name] };
+    if (!connectionManager->isSubscribed(TcpMessageGroup::HISTOGRAMS)) {
+        // the changes are not tracked while nobody listens, the next client gets the full histogram
+        transport.fullUpdate = true;
+        hist.clearChanges();
+        return;
+    }
+    // a new version is sent in full the first time, after changes which were not sent and whenever the binning was changed or cleared
+    bool fullUpdate { transport.fullUpdate || transport.version == 0 || hist.isCompletelyChanged() };
+    // a delta entry is 12 bytes, a full bin 8 bytes
+    if (!fullUpdate && hist.getChangedBins().size() * 3 > static_cast<std::size_t>(hist.getNrBins()) * 2) {
+        fullUpdate = true;
+    }
+    const bool changed { fullUpdate || hist.hasChanges() };
+    if (!changed && !transport.resync) {
+        return;
+    }
+
+    const quint32 baseVersion { transport.version };
+    if (changed) {
+        transport.version = (transport.version == std::numeric_limits<quint32>::max()) ? 1 : transport.version + 1;
+    }
+    transport.fullUpdate = false;
+
+    if (!fullUpdate && changed) {
+        // only to the clients holding baseVersion
+        HistogramDeltaStruct delta {};
+        delta.bins.reserve(static_cast<int>(hist.getChangedBins().size()));
+        for (int bin : hist.getChangedBins()) {
+            delta.bins.push_back(qMakePair(static_cast<qint32>(bin), hist.getBinContent(bin)));
+        }
+        delta.name = name;
+        delta.baseVersion = baseVersion;
+        delta.version = transport.version;
+        delta.underflow = hist.getUnderflow();
+        delta.overflow = hist.getOverflow();
+        TcpMessage tcpMessage(TCP_MSG_KEY::MSG_HISTOGRAM_DELTA);
+        tcpMessage.stream() << delta;
+        emit sendHistogramDeltaMessage(tcpMessage, name, baseVersion, transport.version);
+    }
+    hist.clearChanges();
+    if (fullUpdate || transport.resync) {
+        // after the delta, so only the clients which did not receive it get the full histogram
+        TcpMessage tcpMessage(TCP_MSG_KEY::MSG_HISTOGRAM);
+        tcpMessage.stream() << hist << transport.version;
+        emit sendHistogramMessage(tcpMessage, name, transport.version);
+    }
+    transport.resync = false;
+}
+
+void Daemon::onHistogramsSubscribed()
+{
+    for (auto& transport : histoTransport) {
+        transport.resync = true;
+    }
+    // histograms kept outside of the registry (i2c latencies) are sent with the next poll
+    for (auto& hist : histoMap) {
+        sendHistogram(hist);
+    }
+}
+
+void Daemon::onHistogramResyncRequired(const QString& name)
+{
+    auto it = histoTransport.find(name);
+    if (it == histoTransport.end()) {
+        return;
+    }
+    it.value().resync = true;
+    if (Histogram* hist = histoMap.find(name)) {
+        sendHistogram(*hist);
+    }
 }
 
 void Daemon::sendUbxMsgRates()
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_MSG_RATE);
-    *(tcpMessage.dStream) << msgRateCfgs;
+    tcpMessage.stream() << msgRateCfgs;
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -1394,7 +1528,7 @@ void Daemon::sendDacThresh(uint8_t channel)
         return;
     }
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_THRESHOLD);
-    *(tcpMessage.dStream) << (quint8)channel << dacThresh[(int)channel];
+    tcpMessage.stream() << (quint8)channel << dacThresh[(int)channel];
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -1405,39 +1539,129 @@ void Daemon::sendDacReadbackValue(uint8_t channel, float voltage)
     }
 
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_DAC_READBACK);
-    *(tcpMessage.dStream) << (quint8)channel << voltage;
+    tcpMessage.stream() << (quint8)channel << voltage;
     emit sendTcpMessage(tcpMessage);
 }
 
-void Daemon::sendGpioPinEvent(uint8_t gpio_pin)
+void Daemon::sendGpioPinEvent(GPIO_PIN signal)
 {
+    if (signal == UNDEFINED_PIN) {
+        return;
+    }
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_GPIO_EVENT);
-    // reverse lookup of gpio function from given pin (first occurence)
-    auto result = std::find_if(GPIO_PINMAP.begin(), GPIO_PINMAP.end(), [&gpio_pin](const std::pair<GPIO_PIN, unsigned int>& item) { return item.second == gpio_pin; });
-    if (result != GPIO_PINMAP.end()) {
-        *(tcpMessage.dStream) << (GPIO_PIN)result->first;
-        emit sendTcpMessage(tcpMessage);
+    tcpMessage.stream() << signal;
+    emit sendTcpMessage(tcpMessage);
+}
+
+void Daemon::onGpioEventsAvailable()
+{
+    if (pigHandler == nullptr) {
+        return;
+    }
+    // rearm the notification first, so that events arriving while draining trigger a new signal
+    pigHandler->acknowledgeEvents();
+    std::array<GpioEvent, MuonPi::Config::Hardware::GPIO::event_drain_batch> batch;
+    std::size_t n { 0 };
+    while ((n = pigHandler->eventBuffer().pop(batch.data(), batch.size())) > 0) {
+        for (std::size_t i = 0; i < n; i++) {
+            processGpioEvent(batch[i]);
+        }
+    }
+}
+
+void Daemon::processGpioEvent(const GpioEvent& event)
+{
+    const GpioPinInfo pinInfo { gpioPinInfo(event.gpio) };
+    if (pinInfo.signal == UNDEFINED_PIN) {
+        return;
+    }
+
+    const quint64 tick { event.tick };
+    lastGpioEventTick = tick;
+    lastGpioEventTimer.start();
+    if (pinInfo.flags & GpioPinInfo::RATE_XOR) {
+        xorRateCounter.add(tick);
+    }
+    if (pinInfo.flags & GpioPinInfo::RATE_AND) {
+        andRateCounter.add(tick);
+    }
+
+    // the first trigger has no interval yet, the 64bit tick would otherwise spoil the histogram range
+    if ((pinInfo.flags & GpioPinInfo::SAMPLING_TRIGGER) && lastTriggerTick != 0) {
+        const quint64 nsecs = (tick - lastTriggerTick) * 1000ULL;
+        if (histoHandle.gpioEventInterval != HistoRegistry::invalid_handle) {
+            checkRescaleHisto(histoMap[histoHandle.gpioEventInterval], 1e-6 * nsecs);
+            histoMap[histoHandle.gpioEventInterval].fill(1e-6 * nsecs);
+        }
+        if (histoHandle.gpioEventIntervalShort != HistoRegistry::invalid_handle) {
+            if (nsecs / 1000 <= histoMap[histoHandle.gpioEventIntervalShort].getMax())
+                histoMap[histoHandle.gpioEventIntervalShort].fill((double)nsecs / 1000.);
+        }
+    }
+    if (pinInfo.flags & GpioPinInfo::SAMPLING_TRIGGER) {
+        lastTriggerTick = tick;
     }
+
+    if (pinInfo.flags & GpioPinInfo::TDC_INTERRUPT) {
+        emit tdcInterrupt(event.gpio);
+    }
+
+    queueGpioPinEvent(pinInfo.signal, tick, event.utc_ns);
+}
+
+void Daemon::queueGpioPinEvent(GPIO_PIN signal, quint64 tick, qint64 utc_ns)
+{
+    if (signal == UNDEFINED_PIN || !connectionManager->isSubscribed(TcpMessageGroup::GPIO_EVENTS)) {
+        return;
+    }
+    if (config.gpioEventFlushWindow <= 0) {
+        sendGpioPinEvent(signal);
+        return;
+    }
+    gpioEventBatch.push_back(GpioEventStruct { tick, utc_ns, static_cast<quint8>(signal) });
+    if (gpioEventBatch.size() >= static_cast<std::size_t>(config.gpioEventBatchSize)) {
+        flushGpioEventBatch();
+        return;
+    }
+    if (!gpioEventFlushTimer.isActive()) {
+        gpioEventFlushTimer.start();
+    }
+}
+
+void Daemon::flushGpioEventBatch()
+{
+    gpioEventFlushTimer.stop();
+    if (gpioEventBatch.empty()) {
+        return;
+    }
+    TcpMessage tcpMessage(TCP_MSG_KEY::MSG_GPIO_EVENT_BATCH);
+    tcpMessage.stream() << static_cast<quint16>(gpioEventBatch.size());
+    for (const auto& evt : gpioEventBatch) {
+        tcpMessage.stream() << evt;
+    }
+    emit sendTcpMessage(tcpMessage);
+    // clear() keeps the capacity, so no reallocation happens for the next batch
+    gpioEventBatch.clear();
 }
 
 void Daemon::sendBiasVoltage()
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_BIAS_VOLTAGE);
-    *(tcpMessage.dStream) << biasVoltage;
+    tcpMessage.stream() << biasVoltage;
     emit sendTcpMessage(tcpMessage);
 }
 
 void Daemon::sendBiasStatus()
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_BIAS_SWITCH);
-    *(tcpMessage.dStream) << biasON;
+    tcpMessage.stream() << biasON;
     emit sendTcpMessage(tcpMessage);
 }
 
 void Daemon::sendGainSwitchStatus()
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_GAIN_SWITCH);
-    *(tcpMessage.dStream) << gainSwitch;
+    tcpMessage.stream() << gainSwitch;
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -1447,21 +1671,21 @@ void Daemon::sendPreampStatus(uint8_t channel)
         return;
     }
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_PREAMP_SWITCH);
-    *(tcpMessage.dStream) << (quint8)channel << preampStatus[channel];
+    tcpMessage.stream() << (quint8)channel << preampStatus[channel];
     emit sendTcpMessage(tcpMessage);
 }
 
 void Daemon::sendPolarityStatus()
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_POLARITY_SWITCH);
-    *(tcpMessage.dStream) << polarity1 << polarity2;
+    tcpMessage.stream() << polarity1 << polarity2;
     emit sendTcpMessage(tcpMessage);
 }
 
 void Daemon::sendPcaChannel()
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_PCA_SWITCH);
-    *(tcpMessage.dStream) << (quint8)pcaPortMask;
+    tcpMessage.stream() << (quint8)pcaPortMask;
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -1470,14 +1694,23 @@ void Daemon::sendEventTriggerSelection()
     if (pigHandler == nullptr)
         return;
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_EVENTTRIGGER);
-    *(tcpMessage.dStream) << (GPIO_PIN)pigHandler->samplingTriggerSignal;
+    tcpMessage.stream() << (GPIO_PIN)pigHandler->samplingTriggerSignal;
     emit sendTcpMessage(tcpMessage);
 }
 
+void Daemon::onMqttQueueStatus(quint32 batchedEvents, quint32 journalBatches, qint64 journalBytes, double replayRate, quint32 droppedBatches)
+{
+    emit logParameter(LogParameter("mqttBatchedEvents", batchedEvents, "", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("mqttJournalBatches", journalBatches, "", LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("mqttJournalSize", journalBytes, "bytes", LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("mqttReplayRate", replayRate, "1/s", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("mqttDroppedBatches", droppedBatches, "", LogParameter::LOG_LATEST));
+}
+
 void Daemon::sendMqttStatus(bool connected)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_MQTT_STATUS);
-    *(tcpMessage.dStream) << connected;
+    tcpMessage.stream() << connected;
     if (connected != mqttConnectionStatus) {
         if (connected) {
             qInfo() << "MQTT (re)connected";
@@ -1491,74 +1724,57 @@ void Daemon::sendMqttStatus(bool connected)
     emit sendTcpMessage(tcpMessage);
 }
 
-void Daemon::rateCounterIntervalActualisation()
+quint64 Daemon::currentGpioTick() const
 {
-    if (xorCounts.isEmpty()) {
-        xorCounts.push_back(0);
-    }
-    if (andCounts.isEmpty()) {
-        andCounts.push_back(0);
-    }
-    timespec now;
-    timespec_get(&now, TIME_UTC);
-    int64_t diff = msecdiff(now, lastRateInterval);
-    while (diff > 1000) {
-        xorCounts.push_back(0);
-        andCounts.push_back(0);
-        while ((quint32)xorCounts.size() > (rateBufferTime)) {
-            xorCounts.pop_front();
-        }
-        while ((quint32)andCounts.size() > (rateBufferTime)) {
-            andCounts.pop_front();
-        }
-        lastRateInterval.tv_sec += 1;
-        diff = msecdiff(now, lastRateInterval);
+    if (!lastGpioEventTimer.isValid()) {
+        return lastGpioEventTick;
     }
+    return lastGpioEventTick + static_cast<quint64>(lastGpioEventTimer.nsecsElapsed() / 1000);
 }
 
 void Daemon::clearRates()
 {
-    xorCounts.clear();
-    xorCounts.push_back(0);
-    andCounts.clear();
-    andCounts.push_back(0);
+    const quint64 now { currentGpioTick() };
+    xorRateCounter.clear();
+    xorRateCounter.advance(now);
+    andRateCounter.clear();
+    andRateCounter.advance(now);
     xorRatePoints.clear();
     andRatePoints.clear();
 }
 
-qreal Daemon::getRateFromCounts(quint8 which_rate)
+std::vector<std::size_t> Daemon::rateWindows()
+{
+    std::vector<std::size_t> windows(RATE_WINDOW_COUNT);
+    windows[RATE_WINDOW_SHORT] = MuonPi::Config::Hardware::GPIO::Rate::short_window;
+    windows[RATE_WINDOW_DEFAULT] = MuonPi::Config::Hardware::GPIO::Rate::default_window;
+    windows[RATE_WINDOW_LONG] = MuonPi::Config::Hardware::GPIO::Rate::long_window;
+    return windows;
+}
+
+qreal Daemon::getRateFromCounts(quint8 which_rate, std::size_t window)
 {
-    rateCounterIntervalActualisation();
-    QList<quint64>* counts;
     if (which_rate == XOR_RATE) {
-        counts = &xorCounts;
+        return xorRateCounter.rate(window, currentGpioTick());
     } else if (which_rate == AND_RATE) {
-        counts = &andCounts;
-    } else {
-        return -1.0;
-    }
-    quint64 sum = 0;
-    for (auto count : *counts) {
-        sum += count;
+        return andRateCounter.rate(window, currentGpioTick());
     }
-    timespec now;
-    timespec_get(&now, TIME_UTC);
-    qreal timeInterval = ((qreal)(1000 * (counts->size() - 1))) + (qreal)msecdiff(now, lastRateInterval); // in ms
-    qreal rate = sum / timeInterval * 1000;
-    return (rate);
+    return -1.0;
 }
 
 void Daemon::onRateBufferReminder()
 {
-    qreal secsSinceStart = 0.001 * (qreal)msecdiff(lastRateInterval, startOfProgram);
+    timespec now;
+    timespec_get(&now, TIME_UTC);
+    qreal secsSinceStart = 0.001 * (qreal)msecdiff(now, startOfProgram);
     qreal xorRate = getRateFromCounts(XOR_RATE);
     qreal andRate = getRateFromCounts(AND_RATE);
     QPointF xorPoint(secsSinceStart, xorRate);
     QPointF andPoint(secsSinceStart, andRate);
     xorRatePoints.append(xorPoint);
     andRatePoints.append(andPoint);
-    emit logParameter(LogParameter("rateXOR", QString::number(xorRate) + " Hz", LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("rateAND", QString::number(andRate) + " Hz", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("rateXOR", xorRate, "Hz", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("rateAND", andRate, "Hz", LogParameter::LOG_AVERAGE));
     while ((quint32)xorRatePoints.size() > rateMaxShowInterval / rateBufferInterval) {
         xorRatePoints.pop_front();
     }
@@ -1590,57 +1806,48 @@ void Daemon::sendGpioRates(int number, quint8 whichRate)
             someRates.push_front(ratePoints->at(ratePoints->size() - 1 - i));
         }
     }
-    *(tcpMessage.dStream) << whichRate << someRates;
+    tcpMessage.stream() << whichRate << someRates;
     emit sendTcpMessage(tcpMessage);
 }
 
 void Daemon::sampleAdc0Event()
 {
-    const uint8_t channel = 0;
     if (adc == nullptr || adcSamplingMode == ADC_MODE_DISABLED) {
         return;
     }
     if (adc->getStatus() & i2cDevice::MODE_UNREACHABLE)
         return;
+    // in trace mode the peak is taken from the trace
+    if (adcSamplingMode == ADC_MODE_TRACE)
+        return;
+    // the result arrives in onAdcPeakSampled
+    emit requestAdcPeakSample();
+}
+
+void Daemon::onAdcPeakSampled(float value, double conversionTime)
+{
+    const uint8_t channel = 0;
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_ADC_SAMPLE);
-    float value = adc->readVoltage(channel);
-    *(tcpMessage.dStream) << (quint8)channel << value;
+    tcpMessage.stream() << (quint8)channel << value;
     emit sendTcpMessage(tcpMessage);
-    QString name = "pulseHeight";
-    histoMap[name].fill(value);
-    emit logParameter(LogParameter("adcSamplingTime", QString::number(adc->getLastConvTime()) + " ms", LogParameter::LOG_AVERAGE));
-    name = "adcSampleTime";
-    checkRescaleHisto(histoMap[name], adc->getLastConvTime());
-    histoMap[name].fill(adc->getLastConvTime());
-    currentAdcSampleIndex = 0;
+    histoMap[histoHandle.pulseHeight].fill(value);
+    emit logParameter(LogParameter("adcSamplingTime", conversionTime, "ms", LogParameter::LOG_AVERAGE));
+    checkRescaleHisto(histoMap[histoHandle.adcSampleTime], conversionTime);
+    histoMap[histoHandle.adcSampleTime].fill(conversionTime);
 }
 
-void Daemon::sampleAdc0TraceEvent()
+void Daemon::onAdcTraceCaptured(QByteArray trace, float peak)
 {
     const uint8_t channel = 0;
-    if (adc == nullptr || adcSamplingMode == ADC_MODE_DISABLED) {
-        return;
-    }
-    if (adc->getStatus() & i2cDevice::MODE_UNREACHABLE)
-        return;
-    float value = adc->readVoltage(channel);
-    adcSamplesBuffer.push_back(value);
-    if (adcSamplesBuffer.size() > MuonPi::Config::Hardware::ADC::buffer_size)
-        adcSamplesBuffer.pop_front();
-    if (currentAdcSampleIndex >= 0) {
-        currentAdcSampleIndex++;
-        if (currentAdcSampleIndex >= (MuonPi::Config::Hardware::ADC::buffer_size - MuonPi::Config::Hardware::ADC::pretrigger)) {
-            TcpMessage tcpMessage(TCP_MSG_KEY::MSG_ADC_TRACE);
-            *(tcpMessage.dStream) << (quint16)adcSamplesBuffer.size();
-            for (int i = 0; i < adcSamplesBuffer.size(); i++)
-                *(tcpMessage.dStream) << adcSamplesBuffer[i];
-            emit sendTcpMessage(tcpMessage);
-            currentAdcSampleIndex = -1;
-        }
+    TcpMessage tcpMessage(TCP_MSG_KEY::MSG_ADC_SAMPLE);
+    tcpMessage.stream() << (quint8)channel << peak;
+    emit sendTcpMessage(tcpMessage);
+    histoMap[histoHandle.pulseHeight].fill(peak);
+    if (connectionManager->isSubscribed(TcpMessageGroup::ADC)) {
+        TcpMessage traceMessage(TCP_MSG_KEY::MSG_ADC_TRACE);
+        traceMessage.stream().writeRawData(trace.constData(), trace.size());
+        emit sendTcpMessage(traceMessage);
     }
-    emit logParameter(LogParameter("adcSamplingTime", QString::number(adc->getLastConvTime()) + " ms", LogParameter::LOG_AVERAGE));
-    checkRescaleHisto(histoMap["adcSampleTime"], adc->getLastConvTime());
-    histoMap["adcSampleTime"].fill(adc->getLastConvTime());
 }
 
 void Daemon::sampleAdcEvent(uint8_t channel)
@@ -1650,9 +1857,13 @@ void Daemon::sampleAdcEvent(uint8_t channel)
     }
     if (adc->getStatus() & i2cDevice::MODE_UNREACHABLE)
         return;
+    emit requestAdcChannelSample(channel);
+}
+
+void Daemon::onAdcChannelSampled(quint8 channel, float value)
+{
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_ADC_SAMPLE);
-    float value = adc->readVoltage(channel);
-    *(tcpMessage.dStream) << (quint8)channel << value;
+    tcpMessage.stream() << channel << value;
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -1661,12 +1872,17 @@ void Daemon::getTemperature()
     if (lm75 == nullptr) {
         return;
     }
-    TcpMessage tcpMessage(TCP_MSG_KEY::MSG_TEMPERATURE);
     if (lm75->getStatus() & i2cDevice::MODE_UNREACHABLE)
         return;
-    float value = lm75->getTemperature();
-    *(tcpMessage.dStream) << value;
-    emit sendTcpMessage(tcpMessage);
+    LM75* sensor { lm75 };
+    i2cScheduler.post(
+        MuonPi::I2cScheduler::Priority::Normal, [sensor]() { return sensor->getTemperature(); }, this,
+        [this](float value) {
+            lastTemperature = value;
+            TcpMessage tcpMessage(TCP_MSG_KEY::MSG_TEMPERATURE);
+            tcpMessage.stream() << value;
+            emit sendTcpMessage(tcpMessage);
+        });
 }
 
 void Daemon::setEventTriggerSelection(GPIO_PIN signal)
@@ -1758,11 +1974,9 @@ void Daemon::setDacThresh(uint8_t channel, float threshold)
 
 void Daemon::saveDacValuesToEeprom()
 {
-    for (int i = 0; i < 4; i++) {
-        MCP4728::DacChannel dacChannel;
-        dac->readChannel(i, dacChannel);
-        dacChannel.eeprom = true;
-        dac->writeChannel(i, dacChannel);
+    MCP4728::DacChannel dacChannels[4];
+    if (dac->readChannels(dacChannels)) {
+        dac->storeChannels(dacChannels);
     }
 }
 
@@ -1894,19 +2108,19 @@ void Daemon::UBXReceivedMsgRateCfg(uint16_t msgID, uint8_t rate)
 void Daemon::onGpsMonHWUpdated(const GnssMonHwStruct& hw)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_MONHW);
-    (*tcpMessage.dStream) << hw;
+    tcpMessage.stream() << hw;
     emit sendTcpMessage(tcpMessage);
-    emit logParameter(LogParameter("preampNoise", QString::number(-hw.noise) + " dBHz", LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("preampAGC", QString::number(hw.agc), LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("antennaStatus", QString::number(hw.antStatus), LogParameter::LOG_LATEST));
-    emit logParameter(LogParameter("antennaPower", QString::number(hw.antPower), LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("jammingLevel", QString::number(hw.jamInd / 2.55, 'f', 1) + " %", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("preampNoise", -hw.noise, "dBHz", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("preampAGC", hw.agc, "", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("antennaStatus", hw.antStatus, "", LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("antennaPower", hw.antPower, "", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("jammingLevel", hw.jamInd / 2.55, "%", LogParameter::LOG_AVERAGE));
 }
 
 void Daemon::onGpsMonHW2Updated(const GnssMonHw2Struct& hw2)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_MONHW2);
-    (*tcpMessage.dStream) << hw2;
+    tcpMessage.stream() << hw2;
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -1931,16 +2145,16 @@ void Daemon::onGpsPropertyUpdatedGnss(const std::vector<GnssSatellite>& sats,
     }
     int N = sats.size();
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_GNSS_SATS);
-    (*tcpMessage.dStream) << N;
+    tcpMessage.stream() << N;
     for (int i = 0; i < N; i++) {
-        (*tcpMessage.dStream) << sats[i];
+        tcpMessage.stream() << sats[i];
     }
     emit sendTcpMessage(tcpMessage);
     nrSats = Property("nrSats", N);
     nrVisibleSats = QVariant { static_cast<qulonglong>(visibleSats.size()) };
 
-    propertyMap["nrSats"] = Property("nrSats", N);
-    propertyMap["visSats"] = Property("visSats", visibleSats.size());
+    propertyMap[propertyHandle.nrSats] = Property("nrSats", N);
+    propertyMap[propertyHandle.visSats] = Property("visSats", visibleSats.size());
 
     int usedSats = 0, maxCnr = 0;
     if (visibleSats.size()) {
@@ -1951,12 +2165,12 @@ void Daemon::onGpsPropertyUpdatedGnss(const std::vector<GnssSatellite>& sats,
                 maxCnr = sat.fCnr;
         }
     }
-    propertyMap["usedSats"] = Property("usedSats", usedSats);
-    propertyMap["maxCNR"] = Property("maxCNR", maxCnr);
+    propertyMap[propertyHandle.usedSats] = Property("usedSats", usedSats);
+    propertyMap[propertyHandle.maxCNR] = Property("maxCNR", maxCnr);
 
-    emit logParameter(LogParameter("sats", QString("%1").arg(visibleSats.size()), LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("usedSats", QString("%1").arg(usedSats), LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("maxCNR", QString("%1").arg(maxCnr) + " dB", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("sats", visibleSats.size(), "", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("usedSats", usedSats, "", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("maxCNR", maxCnr, "dB", LogParameter::LOG_AVERAGE));
 }
 
 void Daemon::onUBXReceivedGnssConfig(uint8_t numTrkCh, const std::vector<GnssConfigStruct>& gnssConfigs)
@@ -1966,9 +2180,9 @@ void Daemon::onUBXReceivedGnssConfig(uint8_t numTrkCh, const std::vector<GnssCon
     }
     int N = gnssConfigs.size();
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_GNSS_CONFIG);
-    (*tcpMessage.dStream) << (int)numTrkCh << N;
+    tcpMessage.stream() << (int)numTrkCh << N;
     for (int i = 0; i < N; i++) {
-        (*tcpMessage.dStream) << gnssConfigs[i].gnssId << gnssConfigs[i].resTrkCh << gnssConfigs[i].maxTrkCh << gnssConfigs[i].flags;
+        tcpMessage.stream() << gnssConfigs[i].gnssId << gnssConfigs[i].resTrkCh << gnssConfigs[i].maxTrkCh << gnssConfigs[i].flags;
     }
     emit sendTcpMessage(tcpMessage);
 }
@@ -1980,7 +2194,7 @@ void Daemon::onUBXReceivedTP5(const UbxTimePulseStruct& tp)
         // put some verbose output here
     }
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_CFG_TP5);
-    (*tcpMessage.dStream) << tp;
+    tcpMessage.stream() << tp;
     emit sendTcpMessage(tcpMessage);
     // check here if UTC is selected as time source
     // this should probably be implemented somewhere else, maybe at ublox init
@@ -2003,11 +2217,11 @@ void Daemon::onUBXReceivedTxBuf(uint8_t txUsage, uint8_t txPeakUsage)
         qDebug() << "TX buf peak usage: " << (int)txPeakUsage << " %";
     }
     tcpMessage = new TcpMessage(TCP_MSG_KEY::MSG_UBX_TXBUF);
-    *(tcpMessage->dStream) << (quint8)txUsage << (quint8)txPeakUsage;
+    tcpMessage->stream() << (quint8)txUsage << (quint8)txPeakUsage;
     emit sendTcpMessage(*tcpMessage);
     delete tcpMessage;
-    emit logParameter(LogParameter("TXBufUsage", QString::number(txUsage) + " %", LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("maxTXBufUsage", QString::number(txPeakUsage) + " %", LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("TXBufUsage", txUsage, "%", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("maxTXBufUsage", txPeakUsage, "%", LogParameter::LOG_LATEST));
 }
 
 void Daemon::onUBXReceivedRxBuf(uint8_t rxUsage, uint8_t rxPeakUsage)
@@ -2018,11 +2232,11 @@ void Daemon::onUBXReceivedRxBuf(uint8_t rxUsage, uint8_t rxPeakUsage)
         qDebug() << "RX buf peak usage: " << (int)rxPeakUsage << " %";
     }
     tcpMessage = new TcpMessage(TCP_MSG_KEY::MSG_UBX_RXBUF);
-    *(tcpMessage->dStream) << (quint8)rxUsage << (quint8)rxPeakUsage;
+    tcpMessage->stream() << (quint8)rxUsage << (quint8)rxPeakUsage;
     emit sendTcpMessage(*tcpMessage);
     delete tcpMessage;
-    emit logParameter(LogParameter("RXBufUsage", QString::number(rxUsage) + " %", LogParameter::LOG_AVERAGE));
-    emit logParameter(LogParameter("maxRXBufUsage", QString::number(rxPeakUsage) + " %", LogParameter::LOG_LATEST));
+    emit logParameter(LogParameter("RXBufUsage", rxUsage, "%", LogParameter::LOG_AVERAGE));
+    emit logParameter(LogParameter("maxRXBufUsage", rxPeakUsage, "%", LogParameter::LOG_LATEST));
 }
 
 void Daemon::gpsPropertyUpdatedUint8(uint8_t data, std::chrono::duration<double> updateAge,
@@ -2048,13 +2262,13 @@ void Daemon::gpsPropertyUpdatedUint8(uint8_t data, std::chrono::duration<double>
                     - std::chrono::duration_cast<std::chrono::microseconds>(updateAge)
                  << "Fix value: " << (int)data << endl;
         tcpMessage = new TcpMessage(TCP_MSG_KEY::MSG_UBX_FIXSTATUS);
-        *(tcpMessage->dStream) << (quint8)data;
+        tcpMessage->stream() << (quint8)data;
         emit sendTcpMessage(*tcpMessage);
         delete tcpMessage;
-        emit logParameter(LogParameter("fixStatus", QString::number(data), LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter("fixStatus", data, "", LogParameter::LOG_LATEST));
         emit logParameter(LogParameter("fixStatusString", FIX_TYPE_STRINGS[data], LogParameter::LOG_LATEST));
         fixStatus = QVariant(data);
-        propertyMap["fixStatus"] = Property("fixStatus", FIX_TYPE_STRINGS[data]);
+        propertyMap[propertyHandle.fixStatus] = Property("fixStatus", FIX_TYPE_STRINGS[data]);
         break;
     default:
         break;
@@ -2072,10 +2286,10 @@ void Daemon::gpsPropertyUpdatedUint32(uint32_t data, chrono::duration<double> up
                     - std::chrono::duration_cast<std::chrono::microseconds>(updateAge)
                  << "time accuracy: " << data << " ns" << endl;
         tcpMessage = new TcpMessage(TCP_MSG_KEY::MSG_UBX_TIME_ACCURACY);
-        *(tcpMessage->dStream) << (quint32)data;
+        tcpMessage->stream() << (quint32)data;
         emit sendTcpMessage(*tcpMessage);
         delete tcpMessage;
-        emit logParameter(LogParameter("timeAccuracy", QString::number(data) + " ns", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("timeAccuracy", data, "ns", LogParameter::LOG_AVERAGE));
         break;
     case 'f':
         if (verbose > 3)
@@ -2083,10 +2297,10 @@ void Daemon::gpsPropertyUpdatedUint32(uint32_t data, chrono::duration<double> up
                     - std::chrono::duration_cast<std::chrono::microseconds>(updateAge)
                  << "frequency accuracy: " << data << " ps/s" << endl;
         tcpMessage = new TcpMessage(TCP_MSG_KEY::MSG_UBX_FREQ_ACCURACY);
-        *(tcpMessage->dStream) << (quint32)data;
+        tcpMessage->stream() << (quint32)data;
         emit sendTcpMessage(*tcpMessage);
         delete tcpMessage;
-        emit logParameter(LogParameter("freqAccuracy", QString::number(data) + " ps/s", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("freqAccuracy", data, "ps/s", LogParameter::LOG_AVERAGE));
         break;
     case 'u':
         if (verbose > 3)
@@ -2094,19 +2308,19 @@ void Daemon::gpsPropertyUpdatedUint32(uint32_t data, chrono::duration<double> up
                     - std::chrono::duration_cast<std::chrono::microseconds>(updateAge)
                  << "Ublox uptime: " << data << " s" << endl;
         tcpMessage = new TcpMessage(TCP_MSG_KEY::MSG_UBX_UPTIME);
-        *(tcpMessage->dStream) << (quint32)data;
+        tcpMessage->stream() << (quint32)data;
         emit sendTcpMessage(*tcpMessage);
         delete tcpMessage;
-        emit logParameter(LogParameter("ubloxUptime", QString::number(data) + " s", LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter("ubloxUptime", data, "s", LogParameter::LOG_LATEST));
         break;
     case 'c':
         if (verbose > 3)
             cout << std::chrono::system_clock::now()
                     - std::chrono::duration_cast<std::chrono::microseconds>(updateAge)
                  << "rising edge counter: " << data << endl;
-        propertyMap["events"] = Property("events", (quint16)data);
+        propertyMap[propertyHandle.events] = Property("events", (quint16)data);
         tcpMessage = new TcpMessage(TCP_MSG_KEY::MSG_UBX_EVENTCOUNTER);
-        *(tcpMessage->dStream) << (quint32)data;
+        tcpMessage->stream() << (quint32)data;
         emit sendTcpMessage(*tcpMessage);
         delete tcpMessage;
         break;
@@ -2124,16 +2338,16 @@ void Daemon::gpsPropertyUpdatedInt32(int32_t data, std::chrono::duration<double>
             cout << std::chrono::system_clock::now()
                     - std::chrono::duration_cast<std::chrono::microseconds>(updateAge)
                  << "clock drift: " << data << " ns/s" << endl;
-        logParameter(LogParameter("clockDrift", QString::number(data) + " ns/s", LogParameter::LOG_AVERAGE));
-        propertyMap["clkDrift"] = Property("clkDrift", (qint32)data);
+        logParameter(LogParameter("clockDrift", data, "ns/s", LogParameter::LOG_AVERAGE));
+        propertyMap[propertyHandle.clkDrift] = Property("clkDrift", (qint32)data);
         break;
     case 'b':
         if (verbose > 3)
             cout << std::chrono::system_clock::now()
                     - std::chrono::duration_cast<std::chrono::microseconds>(updateAge)
                  << "clock bias: " << data << " ns" << endl;
-        emit logParameter(LogParameter("clockBias", QString::number(data) + " ns", LogParameter::LOG_AVERAGE));
-        propertyMap["clkBias"] = Property("clkBias", (qint32)data);
+        emit logParameter(LogParameter("clockBias", data, "ns", LogParameter::LOG_AVERAGE));
+        propertyMap[propertyHandle.clkBias] = Property("clkBias", (qint32)data);
         break;
     default:
         break;
@@ -2144,7 +2358,7 @@ void Daemon::UBXReceivedVersion(const QString& swString, const QString& hwString
 {
     static bool initialVersionInfo = true;
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_VERSION);
-    (*tcpMessage.dStream) << swString << hwString << protString;
+    tcpMessage.stream() << swString << hwString << protString;
     emit sendTcpMessage(tcpMessage);
     emit logParameter(LogParameter("UBX_SW_Version", swString, LogParameter::LOG_ONCE));
     emit logParameter(LogParameter("UBX_HW_Version", hwString, LogParameter::LOG_ONCE));
@@ -2261,67 +2475,92 @@ void Daemon::intSignalHandler(int)
 
 void Daemon::aquireMonitoringParameters()
 {
-    if (lm75 && lm75->devicePresent())
-        emit logParameter(LogParameter("temperature", QString::number(lm75->getTemperature()) + " degC", LogParameter::LOG_AVERAGE));
+    if (lm75 != nullptr) {
+        LM75* sensor { lm75 };
+        i2cScheduler.post(
+            MuonPi::I2cScheduler::Priority::Normal,
+            [sensor]() {
+                const bool present { sensor->devicePresent() };
+                return std::make_pair(present, (present) ? sensor->getTemperature() : 0.);
+            },
+            this,
+            [this](const std::pair<bool, double>& result) {
+                if (!result.first) {
+                    return;
+                }
+                lastTemperature = result.second;
+                emit logParameter(LogParameter("temperature", result.second, "degC", LogParameter::LOG_AVERAGE));
+            });
+    }
 
-    double v1 = 0., v2 = 0.;
     if (adc && (!(adc->getStatus() & i2cDevice::MODE_UNREACHABLE)) && (adc->getStatus() & (i2cDevice::MODE_NORMAL | i2cDevice::MODE_FORCE))) {
-        v1 = adc->readVoltage(2);
-        v2 = adc->readVoltage(3);
-        if (calib && calib->getCalibItem("VDIV").name == "VDIV") {
-            CalibStruct vdivItem = calib->getCalibItem("VDIV");
-            std::istringstream istr(vdivItem.value);
-            double vdiv;
-            istr >> vdiv;
-            vdiv /= 100.;
-            logParameter(LogParameter("calib_vdiv", QString::number(vdiv), LogParameter::LOG_ONCE));
+        ADS1115* converter { adc };
+        i2cScheduler.post(
+            MuonPi::I2cScheduler::Priority::Normal,
+            [converter]() {
+                const double v1 { converter->readVoltage(2) };
+                return std::make_pair(v1, converter->readVoltage(3));
+            },
+            this,
+            [this](const std::pair<double, double>& voltages) { processBiasMonitoring(voltages.first, voltages.second); });
+    }
+}
+
+void Daemon::processBiasMonitoring(double v1, double v2)
+{
+    if (calib && calib->getCalibItem("VDIV").name == "VDIV") {
+        CalibStruct vdivItem = calib->getCalibItem("VDIV");
+        std::istringstream istr(vdivItem.value);
+        double vdiv;
+        istr >> vdiv;
+        vdiv /= 100.;
+        logParameter(LogParameter("calib_vdiv", QString::number(vdiv), LogParameter::LOG_ONCE));
+        istr.clear();
+        istr.str(calib->getCalibItem("RSENSE").value);
+        double rsense;
+        istr >> rsense;
+        if (verbose > 2) {
+            qDebug() << "rsense:" << QString::fromStdString(calib->getCalibItem("RSENSE").value) << " (" << rsense << ")";
+        }
+        rsense /= 10. * 1000.; // yields Rsense in MOhm
+        logParameter(LogParameter("calib_rsense", QString::number(rsense * 1000.) + " kOhm", LogParameter::LOG_ONCE));
+        double ubias = v2 * vdiv;
+        logParameter(LogParameter("vbias", ubias, "V", LogParameter::LOG_AVERAGE));
+        checkRescaleHisto(histoMap[histoHandle.biasVoltage], ubias);
+        histoMap[histoHandle.biasVoltage].fill(ubias);
+        double usense = (v1 - v2) * vdiv;
+        logParameter(LogParameter("vsense", usense, "V", LogParameter::LOG_AVERAGE));
+
+        CalibStruct flagItem = calib->getCalibItem("CALIB_FLAGS");
+        int calFlags = 0;
+
+        istr.clear();
+        istr.str(flagItem.value);
+        istr >> calFlags;
+        if (verbose > 2) {
+            qDebug() << "cal flags:" << QString::fromStdString(flagItem.value) << " (" << (int)calFlags << dec << ")";
+        }
+        double icorr = 0.;
+        if (calFlags & CalibStruct::CALIBFLAGS_CURRENT_COEFFS) {
+            double islope, ioffs;
             istr.clear();
-            istr.str(calib->getCalibItem("RSENSE").value);
-            double rsense;
-            istr >> rsense;
-            if (verbose > 2) {
-                qDebug() << "rsense:" << QString::fromStdString(calib->getCalibItem("RSENSE").value) << " (" << rsense << ")";
-            }
-            rsense /= 10. * 1000.; // yields Rsense in MOhm
-            logParameter(LogParameter("calib_rsense", QString::number(rsense * 1000.) + " kOhm", LogParameter::LOG_ONCE));
-            double ubias = v2 * vdiv;
-            logParameter(LogParameter("vbias", QString::number(ubias) + " V", LogParameter::LOG_AVERAGE));
-            checkRescaleHisto(histoMap["Bias Voltage"], ubias);
-            histoMap["Bias Voltage"].fill(ubias);
-            double usense = (v1 - v2) * vdiv;
-            logParameter(LogParameter("vsense", QString::number(usense) + " V", LogParameter::LOG_AVERAGE));
-
-            CalibStruct flagItem = calib->getCalibItem("CALIB_FLAGS");
-            int calFlags = 0;
-
+            istr.str(calib->getCalibItem("COEFF2").value);
+            istr >> ioffs;
+            logParameter(LogParameter("calib_coeff2", QString::number(ioffs), LogParameter::LOG_ONCE));
             istr.clear();
-            istr.str(flagItem.value);
-            istr >> calFlags;
-            if (verbose > 2) {
-                qDebug() << "cal flags:" << QString::fromStdString(flagItem.value) << " (" << (int)calFlags << dec << ")";
-            }
-            double icorr = 0.;
-            if (calFlags & CalibStruct::CALIBFLAGS_CURRENT_COEFFS) {
-                double islope, ioffs;
-                istr.clear();
-                istr.str(calib->getCalibItem("COEFF2").value);
-                istr >> ioffs;
-                logParameter(LogParameter("calib_coeff2", QString::number(ioffs), LogParameter::LOG_ONCE));
-                istr.clear();
-                istr.str(calib->getCalibItem("COEFF3").value);
-                istr >> islope;
-                logParameter(LogParameter("calib_coeff3", QString::number(islope), LogParameter::LOG_ONCE));
-                icorr = ubias * islope + ioffs;
-            }
-            double ibias = usense / rsense - icorr;
-            checkRescaleHisto(histoMap["Bias Current"], ibias);
-            histoMap["Bias Current"].fill(ibias);
-            logParameter(LogParameter("ibias", QString::number(ibias) + " uA", LogParameter::LOG_AVERAGE));
-
-        } else {
-            logParameter(LogParameter("vadc3", QString::number(v1) + " V", LogParameter::LOG_AVERAGE));
-            logParameter(LogParameter("vadc4", QString::number(v2) + " V", LogParameter::LOG_AVERAGE));
+            istr.str(calib->getCalibItem("COEFF3").value);
+            istr >> islope;
+            logParameter(LogParameter("calib_coeff3", QString::number(islope), LogParameter::LOG_ONCE));
+            icorr = ubias * islope + ioffs;
         }
+        double ibias = usense / rsense - icorr;
+        checkRescaleHisto(histoMap[histoHandle.biasCurrent], ibias);
+        histoMap[histoHandle.biasCurrent].fill(ibias);
+        logParameter(LogParameter("ibias", ibias, "uA", LogParameter::LOG_AVERAGE));
+
+    } else {
+        logParameter(LogParameter("vadc3", v1, "V", LogParameter::LOG_AVERAGE));
+        logParameter(LogParameter("vadc4", v2, "V", LogParameter::LOG_AVERAGE));
     }
 }
 
@@ -2346,16 +2585,38 @@ void Daemon::onLogParameterPolled()
     if (pigHandler != nullptr)
         emit logParameter(LogParameter("gpioTriggerSelection", "0x" + QString::number((int)pigHandler->samplingTriggerSignal, 16), LogParameter::LOG_ON_CHANGE));
     if (adc && !(adc->getStatus() & i2cDevice::MODE_UNREACHABLE)) {
+        emit logParameter(LogParameter("adcReadyTimeouts", adc->getNrReadyTimeouts(), "", LogParameter::LOG_LATEST));
+    }
+    if (pigHandler != nullptr) {
+        emit logParameter(LogParameter("gpioEventOverruns", pigHandler->eventBuffer().overruns(), "", LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter("gpioEventBufferPeak", pigHandler->eventBuffer().highWaterMark(), "", LogParameter::LOG_LATEST));
+        const MuonPi::GpioClockModel& clockModel { pigHandler->clockModel() };
+        if (clockModel.valid()) {
+            emit logParameter(LogParameter("gpioClockUncertainty", clockModel.uncertainty(), "ns", LogParameter::LOG_AVERAGE));
+            emit logParameter(LogParameter("gpioClockDrift", clockModel.drift(), "ppm", LogParameter::LOG_AVERAGE));
+        }
+        emit logParameter(LogParameter("gpioClockRejectedSamples", clockModel.rejectedSamples(), "", LogParameter::LOG_LATEST));
     }
 
-    for (const auto& hist : histoMap) {
+    emit requestMqttQueueStatus();
+
+    for (auto& hist : histoMap) {
         sendHistogram(hist);
     }
+    for (i2cDevice* device : i2cDevice::getGlobalDeviceList()) {
+        Histogram latency { device->pollLatencyHistogram() };
+        if (latency.getEntries() == 0) {
+            continue;
+        }
+        latency.setName("i2cLatency_" + device->getTitle());
+        sendHistogram(latency);
+    }
 
     sendLogInfo();
     if (verbose > 2) {
         qDebug() << "current data file: " << fileHandler->dataFileInfo().absoluteFilePath();
         qDebug() << " file size: " << fileHandler->dataFileInfo().size() / (1024 * 1024) << "MiB";
+        emit requestUbxMessageStatistics();
     }
 
     // Since Linux 2.3.23 (i386) and Linux 2.3.48 (all architectures) the
@@ -2394,10 +2655,10 @@ void Daemon::onLogParameterPolled()
             qDebug() << "free swap       : " << (1.0e-6 * info.freeswap / info.mem_unit) << " Mb";
         }
         emit logParameter(LogParameter("systemNrCPUs", QString::number(get_nprocs()) + " ", LogParameter::LOG_ONCE));
-        emit logParameter(LogParameter("systemUptime", QString::number(info.uptime / 3600.) + " h", LogParameter::LOG_LATEST));
-        emit logParameter(LogParameter("systemFreeMem", QString::number(1e-6 * info.freeram / info.mem_unit) + " Mb", LogParameter::LOG_AVERAGE));
-        emit logParameter(LogParameter("systemFreeSwap", QString::number(1e-6 * info.freeswap / info.mem_unit) + " Mb", LogParameter::LOG_AVERAGE));
-        emit logParameter(LogParameter("systemLoadAvg", QString::number(info.loads[0] * f_load) + " ", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("systemUptime", info.uptime / 3600., "h", LogParameter::LOG_LATEST));
+        emit logParameter(LogParameter("systemFreeMem", 1e-6 * info.freeram / info.mem_unit, "Mb", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("systemFreeSwap", 1e-6 * info.freeswap / info.mem_unit, "Mb", LogParameter::LOG_AVERAGE));
+        emit logParameter(LogParameter("systemLoadAvg", info.loads[0] * f_load, "", LogParameter::LOG_AVERAGE));
     }
 }
 
@@ -2412,45 +2673,65 @@ void Daemon::onUBXReceivedTimeTM2(const UbxTimeMarkStruct& tm)
     long double dts = (tm.falling.tv_sec - tm.rising.tv_sec) * 1.0e9L;
     dts += (tm.falling.tv_nsec - tm.rising.tv_nsec);
     if ((dts > 0.0L) && tm.fallingValid) {
-        checkRescaleHisto(histoMap["UbxEventLength"], static_cast<double>(dts));
-        histoMap["UbxEventLength"].fill(static_cast<double>(dts));
+        checkRescaleHisto(histoMap[histoHandle.ubxEventLength], static_cast<double>(dts));
+        histoMap[histoHandle.ubxEventLength].fill(static_cast<double>(dts));
     }
     long double interval = (tm.rising.tv_sec - lastTimeMark.rising.tv_sec) * 1.0e9L;
     interval += (tm.rising.tv_nsec - lastTimeMark.rising.tv_nsec);
-    histoMap["UbxEventInterval"].fill(static_cast<double>(1.0e-6L * interval));
+    histoMap[histoHandle.ubxEventInterval].fill(static_cast<double>(1.0e-6L * interval));
     uint16_t diffCount = tm.evtCounter - lastTimeMark.evtCounter;
     emit timeMarkIntervalCountUpdate(diffCount, static_cast<double>(interval * 1.0e-9L));
     lastTimeMark = tm;
 
-    // output is: rising falling timeAcc valid timeBase utcAvailable
-    std::stringstream tempStream;
-    tempStream << tm.rising << tm.falling << tm.accuracy_ns << " " << tm.evtCounter << " "
-               << static_cast<short>(tm.valid) << " " << static_cast<short>(tm.timeBase) << " "
-               << static_cast<short>(tm.utcAvailable);
-    emit eventMessage(QString::fromStdString(tempStream.str()));
+    MuonPi::EventRecord record {};
+    record.rising_ns = static_cast<std::int64_t>(tm.rising.tv_sec) * 1000000000LL + tm.rising.tv_nsec;
+    record.falling_ns = static_cast<std::int64_t>(tm.falling.tv_sec) * 1000000000LL + tm.falling.tv_nsec;
+    record.accuracy_ns = tm.accuracy_ns;
+    record.counter = tm.evtCounter;
+    record.flags = (tm.valid ? MuonPi::EventRecord::VALID : 0)
+        | (tm.utcAvailable ? MuonPi::EventRecord::UTC_AVAILABLE : 0)
+        | (tm.risingValid ? MuonPi::EventRecord::RISING_VALID : 0)
+        | (tm.fallingValid ? MuonPi::EventRecord::FALLING_VALID : 0);
+    record.timeBase = tm.timeBase;
+    emit eventRecord(record);
+
+    // the mqtt upload keeps the text line: rising falling timeAcc counter valid timeBase utcAvailable
+    const QString eventText { QString::fromStdString(record.toText()) };
+    emit eventMessage(eventText);
 
     if (!tm.risingValid || !tm.fallingValid) {
         qDebug() << "detected timemark message with reconstructed edge time (" << QString((tm.risingValid) ? "falling" : "rising") << ")";
-        qDebug() << "msg:" << QString::fromStdString(tempStream.str());
+        qDebug() << "msg:" << eventText;
     }
 
+    if (!connectionManager->isSubscribed(TcpMessageGroup::TIMEMARKS)) {
+        return;
+    }
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_TIMEMARK);
-    (*tcpMessage.dStream) << tm;
+    tcpMessage.stream() << tm;
     emit sendTcpMessage(tcpMessage);
 }
 
 void Daemon::updateOledDisplay()
 {
-    if (!oled->devicePresent())
-        return;
-    oled->clearDisplay();
-    oled->setCursor(0, 2);
-    oled->print("*Cosmic Shower Det.*\n");
-    oled->printf("Rates %4.1f %4.1f /s\n", getRateFromCounts(AND_RATE), getRateFromCounts(XOR_RATE));
-    oled->printf("temp %4.2f %cC\n", lm75->getTemperature(), DEGREE_CHARCODE);
-    oled->printf("%d(%d) Sats ", nrVisibleSats().toInt(), nrSats().toInt(), DEGREE_CHARCODE);
-    oled->printf("%s\n", FIX_TYPE_STRINGS[fixStatus().toInt()].toStdString().c_str());
-    oled->display();
+    // the lines are composed here, drawing and the bus transfer run as low priority transaction
+    // only the characters which changed since the last update are redrawn and transferred
+    // the degree sign is a character of the display font, so the lines are formatted as plain bytes
+    char line[3][32];
+    std::snprintf(line[0], sizeof(line[0]), "Rates %4.1f %4.1f /s", getRateFromCounts(AND_RATE), getRateFromCounts(XOR_RATE));
+    std::snprintf(line[1], sizeof(line[1]), "temp %4.2f %cC", lastTemperature, DEGREE_CHARCODE);
+    std::snprintf(line[2], sizeof(line[2]), "%d(%d) Sats %s", nrVisibleSats().toInt(), nrSats().toInt(), FIX_TYPE_STRINGS[fixStatus().toInt()].toStdString().c_str());
+    std::array<std::string, 4> lines { "*Cosmic Shower Det.*", line[0], line[1], line[2] };
+    Adafruit_SSD1306* display { oled };
+    i2cScheduler.post(MuonPi::I2cScheduler::Priority::Low, [display, lines = std::move(lines)]() {
+        if (!display->devicePresent())
+            return;
+        display->setLineOrigin(0, 2);
+        for (std::size_t i = 0; i < lines.size(); i++) {
+            display->printLine(i, lines[i]);
+        }
+        display->display();
+    });
 }
 
 void Daemon::startRateScan(uint8_t channel)
@@ -2462,7 +2743,7 @@ void Daemon::startRateScan(uint8_t channel)
 
 void Daemon::doRateScanIteration(RateScanInfo* info)
 {
-    uint currCounter = propertyMap["events"]().toUInt();
+    uint currCounter = propertyMap[propertyHandle.events]().toUInt();
     uint diffCount = currCounter - info->lastEvtCounter;
     info->lastEvtCounter = static_cast<quint16>(currCounter);
 
@@ -0,0 +1,42 @@
+#include "hardware/adcsampler.h"
+#include "hardware/i2c/ads1115.h"
+#include "hardware/i2cscheduler.h"
+
+#include <utility>
+
+AdcSampler::AdcSampler(ADS1115* adc, MuonPi::I2cScheduler* scheduler, QObject* parent)
+    : QObject(parent)
+    , m_adc { adc }
+    , m_scheduler { scheduler }
+{
+}
+
+void AdcSampler::samplePeak()
+{
+    const unsigned int channel { 0 };
+    if (m_adc == nullptr || (m_adc->getStatus() & i2cDevice::MODE_UNREACHABLE)) {
+        return;
+    }
+    ADS1115* adc { m_adc };
+    m_scheduler->post(
+        MuonPi::I2cScheduler::Priority::High,
+        [adc, channel]() {
+            const float voltage { static_cast<float>(adc->readVoltage(channel)) };
+            return std::make_pair(voltage, adc->getLastConvTime());
+        },
+        this,
+        [this](const std::pair<float, double>& result) { emit peakSampled(result.first, result.second); });
+}
+
+void AdcSampler::sampleChannel(quint8 channel)
+{
+    if (m_adc == nullptr || (m_adc->getStatus() & i2cDevice::MODE_UNREACHABLE)) {
+        return;
+    }
+    ADS1115* adc { m_adc };
+    m_scheduler->post(
+        MuonPi::I2cScheduler::Priority::High,
+        [adc, channel]() { return adc->readVoltage(channel); },
+        this,
+        [this, channel](float voltage) { emit channelSampled(channel, voltage); });
+}
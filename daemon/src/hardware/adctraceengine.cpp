@@ -0,0 +1,85 @@
+#include "hardware/adctraceengine.h"
+#include "hardware/i2c/ads1115.h"
+
+#include <config.h>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QThread>
+
+#include <algorithm>
+
+namespace {
+constexpr unsigned int trace_channel { 0 };
+}
+
+AdcTraceEngine::AdcTraceEngine(ADS1115* adc, QObject* parent)
+    : QObject(parent)
+    , m_adc { adc }
+    , m_buffer(MuonPi::Config::Hardware::ADC::buffer_size, 0)
+{
+}
+
+void AdcTraceEngine::run(quint32 generation)
+{
+    // stale requests and requests while already running are ignored
+    if (m_adc == nullptr || generation != m_generation.load() || m_running.exchange(true)) {
+        return;
+    }
+    // a stop() between the checks above
+    if (generation != m_generation.load()) {
+        m_running.store(false);
+        return;
+    }
+    const unsigned int singleShotRate { m_adc->getRate() };
+    m_adc->setRate(MuonPi::Config::Hardware::ADC::trace_rate);
+    if (!m_adc->startContinuous(trace_channel)) {
+        qWarning() << "could not start continuous adc conversions, no traces are recorded";
+        m_adc->setRate(singleShotRate);
+        m_running.store(false);
+        return;
+    }
+    const std::uint64_t posttrigger { static_cast<std::uint64_t>(MuonPi::Config::Hardware::ADC::buffer_size - MuonPi::Config::Hardware::ADC::pretrigger) };
+    std::uint64_t written { 0 };
+    std::uint64_t captureEnd { 0 };
+    // a trigger from before the start belongs to no trace
+    m_triggered.store(false);
+    while (m_running.load() && !QThread::currentThread()->isInterruptionRequested()) {
+        std::int16_t value { 0 };
+        if (!m_adc->readContinuous(value)) {
+            continue;
+        }
+        m_buffer[written % m_buffer.size()] = value;
+        written++;
+        // further triggers during a capture are discarded
+        if (m_triggered.exchange(false) && captureEnd == 0) {
+            captureEnd = written + posttrigger - 1;
+        }
+        if (captureEnd != 0 && written >= captureEnd) {
+            capture(captureEnd);
+            captureEnd = 0;
+        }
+    }
+    m_adc->stopContinuous();
+    m_adc->setRate(singleShotRate);
+    m_running.store(false);
+}
+
+void AdcTraceEngine::capture(std::uint64_t end)
+{
+    const std::uint64_t length { std::min<std::uint64_t>(end, m_buffer.size()) };
+    const std::uint64_t triggerIndex { end - (m_buffer.size() - MuonPi::Config::Hardware::ADC::pretrigger) };
+    QByteArray trace;
+    trace.reserve(static_cast<int>(sizeof(quint16) + length * sizeof(double)));
+    QDataStream stream(&trace, QIODevice::WriteOnly);
+    stream << static_cast<quint16>(length);
+    float peak { 0.f };
+    for (std::uint64_t i = end - length; i < end; i++) {
+        const float voltage = m_adc->toVoltage(trace_channel, m_buffer[i % m_buffer.size()]);
+        stream << voltage;
+        if (i >= triggerIndex) {
+            peak = std::max(peak, voltage);
+        }
+    }
+    emit traceCaptured(trace, peak);
+}
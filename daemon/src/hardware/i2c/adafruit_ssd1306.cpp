@@ -122,9 +122,9 @@ inline void Adafruit_SSD1306::fastI2Cwrite(uint8_t d)
 {
     i2cDevice::write(&d, 1);
 }
-inline void Adafruit_SSD1306::fastI2Cwrite(char* tbuf, uint32_t len)
+inline bool Adafruit_SSD1306::fastI2Cwrite(char* tbuf, uint32_t len)
 {
-    i2cDevice::write((uint8_t*)tbuf, len);
+    return i2cDevice::write((uint8_t*)tbuf, len) == static_cast<int>(len);
 }
 
 #define _BV(bit) (1 << (bit))
@@ -156,6 +156,7 @@ void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color)
 
     // Get where to do the change in the buffer
     p = poledbuff + (x + (y / 8) * ssd1306_lcdwidth);
+    markDirty(y / 8, x, x);
 
     // x is which column
     if (color == WHITE)
@@ -217,6 +218,17 @@ bool Adafruit_SSD1306::init(uint8_t OLED_TYPE, int8_t RST)
     if (!poledbuff)
         return false;
 
+    if (poledshadow)
+        free(poledshadow);
+
+    poledshadow = (uint8_t*)malloc((ssd1306_lcdwidth * ssd1306_lcdheight / 8));
+    if (!poledshadow)
+        return false;
+
+    dirtyFirst.assign(ssd1306_lcdheight / 8, ssd1306_lcdwidth);
+    dirtyLast.assign(ssd1306_lcdheight / 8, -1);
+    fullRefresh = true;
+
     return (true);
 }
 
@@ -227,6 +239,11 @@ void Adafruit_SSD1306::close(void)
         free(poledbuff);
 
     poledbuff = NULL;
+
+    if (poledshadow)
+        free(poledshadow);
+
+    poledshadow = NULL;
 }
 
 void Adafruit_SSD1306::begin(void)
@@ -282,7 +299,8 @@ void Adafruit_SSD1306::begin(void)
     ssd1306_command(0x22, 0, 7);
     stopscroll();
 
-    // Empty uninitialized buffer
+    // Empty uninitialized buffer, the content of the display memory is unknown now
+    fullRefresh = true;
     clearDisplay();
     ssd1306_command(SSD_Display_On); //--turn on oled panel
 }
@@ -422,33 +440,94 @@ void Adafruit_SSD1306::ssd1306_data(uint8_t c)
 
 void Adafruit_SSD1306::display(void)
 {
-    ssd1306_command(SSD1306_SETLOWCOLUMN | 0x0); // low col = 0
-    ssd1306_command(SSD1306_SETHIGHCOLUMN | 0x0); // hi col = 0
-    ssd1306_command(SSD1306_SETSTARTLINE | 0x0); // line #0
-
-    uint16_t i = 0;
+    const int16_t pages = ssd1306_lcdheight / 8;
 
-    // pointer to OLED data buffer
-    uint8_t* p = poledbuff;
-
-    char buff[17];
-    uint8_t x;
+    // data bytes for one page at most plus the D/C control byte
+    std::array<char, max_lcdwidth + 1> buff;
+    bool failed = false;
 
     // Setup D/C to switch to data mode
     buff[0] = SSD_Data_Mode;
 
-    // loop trough all OLED buffer and
-    // send a bunch of 16 data byte in one xmission
-    for (i = 0; i < (ssd1306_lcdwidth * ssd1306_lcdheight / 8); i += 16) {
-        for (x = 1; x <= 16; x++)
-            buff[x] = *p++;
+    for (int16_t page = 0; page < pages; page++) {
+        int16_t first = (fullRefresh) ? 0 : dirtyFirst[page];
+        int16_t last = (fullRefresh) ? ssd1306_lcdwidth - 1 : dirtyLast[page];
+        dirtyFirst[page] = ssd1306_lcdwidth;
+        dirtyLast[page] = -1;
+
+        // pixels may have been redrawn with the same value, skip the columns which did not change
+        const uint8_t* p = poledbuff + page * ssd1306_lcdwidth;
+        uint8_t* shadow = poledshadow + page * ssd1306_lcdwidth;
+        if (!fullRefresh) {
+            while (first <= last && p[first] == shadow[first])
+                first++;
+            while (last >= first && p[last] == shadow[last])
+                last--;
+        }
+        if (first > last)
+            continue;
+
+        // in horizontal addressing mode the data fills the column/page window
+        ssd1306_command(0x21, first, last);
+        ssd1306_command(0x22, page, page);
+
+        memcpy(buff.data() + 1, p + first, last - first + 1);
+        if (!fastI2Cwrite(buff.data(), last - first + 2)) {
+            // the display content is unknown, the columns are transferred again with the next update
+            markDirty(page, first, last);
+            failed = true;
+            continue;
+        }
+        memcpy(shadow + first, p + first, last - first + 1);
+    }
+    fullRefresh = fullRefresh && failed;
+}
+
+void Adafruit_SSD1306::markDirty(int16_t page, int16_t first, int16_t last)
+{
+    if (first < dirtyFirst[page])
+        dirtyFirst[page] = first;
+    if (last > dirtyLast[page])
+        dirtyLast[page] = last;
+}
+
+void Adafruit_SSD1306::setLineOrigin(int16_t x, int16_t y)
+{
+    if (x == line_origin_x && y == line_origin_y)
+        return;
+    line_origin_x = x;
+    line_origin_y = y;
+    textLines.clear();
+}
 
-        fastI2Cwrite(buff, 17);
+void Adafruit_SSD1306::printLine(uint8_t line, const std::string& text)
+{
+    const int16_t y = line_origin_y + line * 8 * textsize;
+    if (line >= textLines.size())
+        textLines.resize(line + 1);
+    TextLine& cached = textLines[line];
+    if (!cached.valid) {
+        // whatever was drawn there before is unknown
+        fillRect(line_origin_x, y, width() - line_origin_x, 8 * textsize, BLACK);
+    }
+    const std::size_t length = (text.size() > cached.text.size()) ? text.size() : cached.text.size();
+    for (std::size_t i = 0; i < length; i++) {
+        const char c = (i < text.size()) ? text[i] : ' ';
+        const char previous = (i < cached.text.size()) ? cached.text[i] : ' ';
+        if (cached.valid && c == previous)
+            continue;
+        // the background color overwrites the previous character cell
+        drawChar(line_origin_x + i * 6 * textsize, y, c, textcolor, BLACK, textsize);
     }
+    cached.text = text;
+    cached.valid = true;
 }
 
 // clear everything (in the buffer)
 void Adafruit_SSD1306::clearDisplay(void)
 {
     memset(poledbuff, 0, (ssd1306_lcdwidth * ssd1306_lcdheight / 8));
+    for (std::size_t page = 0; page < dirtyFirst.size(); page++)
+        markDirty(page, 0, ssd1306_lcdwidth - 1);
+    textLines.clear();
 }
@@ -1,65 +1,75 @@
 #include "hardware/i2c/ads1115.h"
+#include <config.h>
+
+#include <chrono>
 /*
 * ADS1115 4ch 16 bit ADC
 */
 const double ADS1115::PGAGAINS[6] = { 6.144, 4.096, 2.048, 1.024, 0.512, 0.256 };
+const unsigned int ADS1115::RATES[8] = { 8, 16, 32, 64, 128, 250, 475, 860 };
 
 int16_t ADS1115::readADC(unsigned int channel)
 {
     uint8_t writeBuf[3]; // Buffer to store the 3 bytes that we write to the I2C device
     uint8_t readBuf[2]; // 2 byte buffer to store the data read from the I2C device
     int16_t val; // Stores the 16 bit value of our ADC conversion
-        //  uint8_t fDataRate = 0x07; // 860 SPS
-        //  uint8_t fDataRate = 0x01; // 16 SPS
-    uint8_t fDataRate = fRate & 0x07;
 
+    std::lock_guard<std::mutex> conversionLock(fConversionMutex);
     startTimer();
 
     // These three bytes are written to the ADS1115 to set the config register and start a conversion
-    writeBuf[0] = 0x01; // This sets the pointer register so that the following two bytes write to the config register
-    writeBuf[1] = 0x80; // OS bit
-    if (!fDiffMode)
-        writeBuf[1] |= 0x40; // single ended mode channels
-    writeBuf[1] |= (channel & 0x03) << 4; // channel select
-    writeBuf[1] |= 0x01; // single shot mode
-    writeBuf[1] |= ((uint8_t)fPga[channel]) << 1; // PGA gain select
-
-    // This sets the 8 LSBs of the config register (bits 7-0)
-    writeBuf[2] = 0x00; // enable ALERT/RDY pin
-    writeBuf[2] |= ((uint8_t)fDataRate) << 5;
+    configBytes(channel, true, writeBuf);
 
     // Initialize the buffer used to read data from the ADS1115 to 0
     readBuf[0] = 0;
     readBuf[1] = 0;
 
+    {
+        std::lock_guard<std::mutex> readyLock(fReadyMutex);
+        fReady = false;
+    }
+
     // Write writeBuf to the ADS1115, the 3 specifies the number of bytes we are writing,
     // this begins a single conversion
     write(writeBuf, 3);
 
-    // Wait for the conversion to complete, this requires bit 15 to change from 0->1
-    int nloops = 0;
-    while ((readBuf[0] & 0x80) == 0 && nloops * fReadWaitDelay / 1000 < 1000) // readBuf[0] contains 8 MSBs of config register, AND with 10000000 to select bit 15
-    {
-        usleep(fReadWaitDelay);
-        read(readBuf, 2); // Read the config register into readBuf
-        nloops++;
+    // in continuous mode the ready pin may still pulse for the last continuous conversion, so poll instead
+    if (!fReadyInterrupt || fContinuous || !waitForConversion()) {
+        // Wait for the conversion to complete, this requires bit 15 to change from 0->1
+        int nloops = 0;
+        while ((readBuf[0] & 0x80) == 0 && nloops * fReadWaitDelay / 1000 < 1000) // readBuf[0] contains 8 MSBs of config register, AND with 10000000 to select bit 15
+        {
+            usleep(fReadWaitDelay);
+            read(readBuf, 2); // Read the config register into readBuf
+            nloops++;
+        }
+        if (nloops * fReadWaitDelay / 1000 >= 1000) {
+            if (fDebugLevel > 1)
+                printf("timeout!\n");
+            if (fContinuous)
+                write(fContinuousConfig, 3);
+            return INT16_MIN;
+        }
+        if (fDebugLevel > 2)
+            printf(" nr of busy adc loops: %d \n", nloops);
+        if (nloops > 1) {
+            fReadWaitDelay += (nloops - 1) * fReadWaitDelay / 10;
+            if (fDebugLevel > 1) {
+                printf(" read wait delay: %6.2f ms\n", fReadWaitDelay / 1000.);
+            }
+        }
     }
-    if (nloops * fReadWaitDelay / 1000 >= 1000) {
+
+    // Set pointer register to 0 and read the conversion register into readBuf with a repeated start,
+    // in continuous mode the conversions which were stopped by the single shot are resumed in the same transaction
+    uint8_t pointer = 0x00;
+    Message messages[3] = { { &pointer, 1, false }, { readBuf, 2, true }, { fContinuousConfig, 3, false } };
+    const int nrMessages { (fContinuous) ? 3 : 2 };
+    if (transfer(messages, nrMessages) != nrMessages) {
         if (fDebugLevel > 1)
-            printf("timeout!\n");
+            printf("conversion readout failed\n");
         return INT16_MIN;
     }
-    if (fDebugLevel > 2)
-        printf(" nr of busy adc loops: %d \n", nloops);
-    if (nloops > 1) {
-        fReadWaitDelay += (nloops - 1) * fReadWaitDelay / 10;
-        if (fDebugLevel > 1) {
-            printf(" read wait delay: %6.2f ms\n", fReadWaitDelay / 1000.);
-        }
-    }
-
-    // Set pointer register to 0 to read from the conversion register
-    readReg(0x00, readBuf, 2); // Read the contents of the conversion register into readBuf
 
     val = readBuf[0] << 8 | readBuf[1]; // Combine the two bytes of readBuf into a single 16 bit result
     fLastADCValue = val;
@@ -70,6 +80,115 @@ int16_t ADS1115::readADC(unsigned int channel)
     return val;
 }
 
+void ADS1115::configBytes(unsigned int channel, bool singleShot, uint8_t* buf) const
+{
+    buf[0] = 0x01; // This sets the pointer register so that the following two bytes write to the config register
+    buf[1] = (singleShot) ? 0x80 : 0x00; // OS bit, starts a single shot conversion
+    if (!fDiffMode)
+        buf[1] |= 0x40; // single ended mode channels
+    buf[1] |= (channel & 0x03) << 4; // channel select
+    if (singleShot)
+        buf[1] |= 0x01; // single shot mode
+    buf[1] |= ((uint8_t)fPga[channel & 0x03]) << 1; // PGA gain select
+
+    // This sets the 8 LSBs of the config register (bits 7-0)
+    buf[2] = 0x00; // enable ALERT/RDY pin
+    buf[2] |= ((uint8_t)(fRate & 0x07)) << 5;
+}
+
+std::chrono::microseconds ADS1115::conversionTimeout() const
+{
+    // the conversion time varies with the internal oscillator, allow for twice the nominal time
+    return std::chrono::microseconds(2000000 / RATES[fRate & 0x07] + MuonPi::Config::Hardware::ADC::ReadyInterrupt::timeout_margin);
+}
+
+bool ADS1115::waitForConversion()
+{
+    std::unique_lock<std::mutex> readyLock(fReadyMutex);
+    if (fReadyCondition.wait_for(readyLock, conversionTimeout(), [this] { return fReady; })) {
+        fConsecutiveReadyTimeouts = 0;
+        return true;
+    }
+    fReadyTimeouts++;
+    if (++fConsecutiveReadyTimeouts >= MuonPi::Config::Hardware::ADC::ReadyInterrupt::max_timeouts) {
+        fReadyInterrupt = false;
+        if (fDebugLevel > 0)
+            printf("ADS1115: no conversion ready interrupts received, falling back to polling\n");
+    }
+    return false;
+}
+
+void ADS1115::setRate(unsigned int rate)
+{
+    std::lock_guard<std::mutex> conversionLock(fConversionMutex);
+    fRate = rate & 0x07;
+}
+
+void ADS1115::setReadyInterrupt(bool enable)
+{
+    std::lock_guard<std::mutex> conversionLock(fConversionMutex);
+    fReadyInterrupt = enable;
+    fConsecutiveReadyTimeouts = 0;
+}
+
+void ADS1115::conversionReady()
+{
+    {
+        std::lock_guard<std::mutex> readyLock(fReadyMutex);
+        fReady = true;
+    }
+    fReadyCondition.notify_one();
+}
+
+bool ADS1115::startContinuous(unsigned int channel)
+{
+    std::lock_guard<std::mutex> conversionLock(fConversionMutex);
+    configBytes(channel, false, fContinuousConfig);
+    if (write(fContinuousConfig, 3) != 3) {
+        return false;
+    }
+    fContinuous = true;
+    return true;
+}
+
+void ADS1115::stopContinuous()
+{
+    std::lock_guard<std::mutex> conversionLock(fConversionMutex);
+    if (!fContinuous) {
+        return;
+    }
+    // back to the power-down single shot state
+    uint8_t writeBuf[3];
+    configBytes(fContinuousConfig[1] >> 4 & 0x03, true, writeBuf);
+    writeBuf[1] &= ~0x80;
+    write(writeBuf, 3);
+    fContinuous = false;
+}
+
+bool ADS1115::readContinuous(int16_t& adc)
+{
+    // the wait happens without holding the conversion lock, so single shots of other threads can take place meanwhile
+    bool ready { false };
+    if (fReadyInterrupt) {
+        std::unique_lock<std::mutex> readyLock(fReadyMutex);
+        ready = fReadyCondition.wait_for(readyLock, conversionTimeout(), [this] { return fReady; });
+        fReady = false;
+    }
+    if (!ready) {
+        usleep(1000000 / RATES[fRate & 0x07]);
+    }
+    std::lock_guard<std::mutex> conversionLock(fConversionMutex);
+    if (!fContinuous) {
+        return false;
+    }
+    uint8_t readBuf[2] { 0, 0 };
+    if (readReg(0x00, readBuf, 2) != 2) {
+        return false;
+    }
+    adc = readBuf[0] << 8 | readBuf[1];
+    return true;
+}
+
 bool ADS1115::setLowThreshold(int16_t thr)
 {
     uint8_t writeBuf[3]; // Buffer to store the 3 bytes that we write to the I2C device
@@ -79,19 +198,16 @@ bool ADS1115::setLowThreshold(int16_t thr)
     // These three bytes are written to the ADS1115 to set the Lo_thresh register
     writeBuf[0] = 0x02; // This sets the pointer register to Lo_thresh register
     writeBuf[1] = (thr & 0xff00) >> 8;
-    writeBuf[2] |= (thr & 0x00ff);
+    writeBuf[2] = (thr & 0x00ff);
 
     // Initialize the buffer used to read data from the ADS1115 to 0
     readBuf[0] = 0;
     readBuf[1] = 0;
 
-    // Write writeBuf to the ADS1115, the 3 specifies the number of bytes we are writing,
-    // this sets the Lo_thresh register
-    int n = write(writeBuf, 3);
-    if (n != 3)
-        return false;
-    n = read(readBuf, 2); // Read the same register into readBuf for verification
-    if (n != 2)
+    // Write writeBuf to the ADS1115, this sets the Lo_thresh register,
+    // and read the same register back into readBuf for verification after a repeated start
+    Message messages[2] = { { writeBuf, 3, false }, { readBuf, 2, true } };
+    if (transfer(messages, 2) != 2)
         return false;
 
     if ((readBuf[0] != writeBuf[1]) || (readBuf[1] != writeBuf[2]))
@@ -109,20 +225,16 @@ bool ADS1115::setHighThreshold(int16_t thr)
     // These three bytes are written to the ADS1115 to set the Hi_thresh register
     writeBuf[0] = 0x03; // This sets the pointer register to Hi_thresh register
     writeBuf[1] = (thr & 0xff00) >> 8;
-    writeBuf[2] |= (thr & 0x00ff);
+    writeBuf[2] = (thr & 0x00ff);
 
     // Initialize the buffer used to read data from the ADS1115 to 0
     readBuf[0] = 0;
     readBuf[1] = 0;
 
-    // Write writeBuf to the ADS1115, the 3 specifies the number of bytes we are writing,
-    // this sets the Hi_thresh register
-    int n = write(writeBuf, 3);
-    if (n != 3)
-        return false;
-
-    n = read(readBuf, 2); // Read the same register into readBuf for verification
-    if (n != 2)
+    // Write writeBuf to the ADS1115, this sets the Hi_thresh register,
+    // and read the same register back into readBuf for verification after a repeated start
+    Message messages[2] = { { writeBuf, 3, false }, { readBuf, 2, true } };
+    if (transfer(messages, 2) != 2)
         return false;
 
     if ((readBuf[0] != writeBuf[1]) || (readBuf[1] != writeBuf[2]))
@@ -1,16 +1,20 @@
 #include "hardware/i2c/i2cdevice.h"
 #include <algorithm>
+#include <config.h>
 #include <cstring>
 #include <fcntl.h> // open
 #include <iostream>
 #include <linux/i2c-dev.h> // I2C bus definitions for linux like systems
+#include <linux/i2c.h> // i2c_msg for combined transactions
 
 using namespace std;
 
 unsigned int i2cDevice::fNrDevices = 0;
-unsigned long int i2cDevice::fGlobalNrBytesRead = 0;
-unsigned long int i2cDevice::fGlobalNrBytesWritten = 0;
+std::atomic<unsigned long int> i2cDevice::fGlobalNrBytesRead { 0 };
+std::atomic<unsigned long int> i2cDevice::fGlobalNrBytesWritten { 0 };
+std::atomic<unsigned long int> i2cDevice::fGlobalNrSyscalls { 0 };
 std::vector<i2cDevice*> i2cDevice::fGlobalDeviceList;
+std::string i2cDevice::fDefaultBus { "/dev/i2c-1" };
 
 i2cDevice::i2cDevice()
 {
@@ -20,7 +24,8 @@ i2cDevice::i2cDevice()
     fNrBytesWritten = 0;
     fAddress = 0;
     fDebugLevel = DEFAULT_DEBUG_LEVEL;
-    fHandle = open("/dev/i2c-1", O_RDWR);
+    initLatencyHistogram();
+    fHandle = open(fDefaultBus.c_str(), O_RDWR);
     if (fHandle > 0) {
         fNrDevices++;
         fGlobalDeviceList.push_back(this);
@@ -33,6 +38,7 @@ i2cDevice::i2cDevice(const char* busAddress)
     fNrBytesRead = 0;
     fNrBytesWritten = 0;
     fDebugLevel = DEFAULT_DEBUG_LEVEL;
+    initLatencyHistogram();
     //opening the devicefile from the i2c driversection (open the device i2c)
     //"/dev/i2c-0" or "../i2c-1" for linux system. In our case
     fHandle = open(busAddress, O_RDWR);
@@ -49,9 +55,10 @@ i2cDevice::i2cDevice(uint8_t slaveAddress)
     fNrBytesRead = 0;
     fNrBytesWritten = 0;
     fDebugLevel = DEFAULT_DEBUG_LEVEL;
+    initLatencyHistogram();
     //opening the devicefile from the i2c driversection (open the device i2c)
     //"/dev/i2c-0" or "../i2c-1" for linux system. In our case
-    fHandle = open("/dev/i2c-1", O_RDWR);
+    fHandle = open(fDefaultBus.c_str(), O_RDWR);
     if (fHandle > 0) {
         //ioctl(fHandle, I2C_SLAVE, fAddress);
         setAddress(slaveAddress);
@@ -67,6 +74,7 @@ i2cDevice::i2cDevice(const char* busAddress, uint8_t slaveAddress)
     fNrBytesRead = 0;
     fNrBytesWritten = 0;
     fDebugLevel = DEFAULT_DEBUG_LEVEL;
+    initLatencyHistogram();
     //opening the devicefile from the i2c driversection (open the device i2c)
     //"/dev/i2c-0" or "../i2c-1" for linux system. In our case
     fHandle = open(busAddress, O_RDWR);
@@ -128,14 +136,16 @@ int i2cDevice::read(uint8_t* buf, int nBytes)
     //we want to read.
     if (fHandle <= 0 || (fMode & MODE_LOCKED))
         return 0;
+    fNrSyscalls++;
+    fGlobalNrSyscalls++;
     int nread = ::read(fHandle, buf, nBytes); //"::" declares that the functions does not call itself again, but instead
     if (nread > 0) {
         fNrBytesRead += nread;
         fGlobalNrBytesRead += nread;
-        fMode &= ~((uint8_t)MODE_UNREACHABLE);
+        fMode.fetch_and(static_cast<uint8_t>(~MODE_UNREACHABLE));
     } else if (nread <= 0) {
         fIOErrors++;
-        fMode |= MODE_UNREACHABLE;
+        fMode.fetch_or(MODE_UNREACHABLE);
     }
     return nread; //uses the read funktion with the set parameters of the bool function
 }
@@ -144,14 +154,16 @@ int i2cDevice::write(uint8_t* buf, int nBytes)
 {
     if (fHandle <= 0 || (fMode & MODE_LOCKED))
         return 0;
+    fNrSyscalls++;
+    fGlobalNrSyscalls++;
     int nwritten = ::write(fHandle, buf, nBytes);
     if (nwritten > 0) {
         fNrBytesWritten += nwritten;
         fGlobalNrBytesWritten += nwritten;
-        fMode &= ~((uint8_t)MODE_UNREACHABLE);
+        fMode.fetch_and(static_cast<uint8_t>(~MODE_UNREACHABLE));
     } else if (nwritten <= 0) {
         fIOErrors++;
-        fMode |= MODE_UNREACHABLE;
+        fMode.fetch_or(MODE_UNREACHABLE);
     }
     return nwritten;
 }
@@ -173,11 +185,69 @@ int i2cDevice::writeReg(uint8_t reg, uint8_t* buf, int nBytes)
 
 int i2cDevice::readReg(uint8_t reg, uint8_t* buf, int nBytes)
 {
+    Message messages[2] = { { &reg, 1, false }, { buf, (uint16_t)nBytes, true } };
+    int n = transfer(messages, 2);
+    if (n != 2)
+        return (n < 0) ? -1 : 0;
+    return nBytes;
+}
 
-    int n = write(&reg, 1);
-    if (n != 1)
+bool i2cDevice::combinedTransfersSupported()
+{
+    if (fCombinedSupport == CombinedSupport::Unknown) {
+        unsigned long funcs = 0;
+        fCombinedSupport = (ioctl(fHandle, I2C_FUNCS, &funcs) >= 0 && (funcs & I2C_FUNC_I2C))
+            ? CombinedSupport::Supported
+            : CombinedSupport::Unsupported;
+    }
+    return fCombinedSupport == CombinedSupport::Supported;
+}
+
+int i2cDevice::transfer(Message* messages, int nMessages)
+{
+    if (fHandle <= 0 || (fMode & MODE_LOCKED))
+        return 0;
+    if (nMessages <= 0 || nMessages > I2C_RDWR_IOCTL_MAX_MSGS)
+        return -1;
+    if (!combinedTransfersSupported()) {
+        for (int i = 0; i < nMessages; i++) {
+            int n = (messages[i].read) ? read(messages[i].buf, messages[i].length) : write(messages[i].buf, messages[i].length);
+            if (n != messages[i].length)
+                return -1;
+        }
+        return nMessages;
+    }
+
+    struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    unsigned long nRead = 0;
+    unsigned long nWritten = 0;
+    for (int i = 0; i < nMessages; i++) {
+        msgs[i].addr = fAddress;
+        msgs[i].flags = (messages[i].read) ? I2C_M_RD : 0;
+        msgs[i].len = messages[i].length;
+        msgs[i].buf = messages[i].buf;
+        if (messages[i].read)
+            nRead += messages[i].length;
+        else
+            nWritten += messages[i].length;
+    }
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = msgs;
+    data.nmsgs = nMessages;
+    fNrSyscalls++;
+    fGlobalNrSyscalls++;
+    int n = ioctl(fHandle, I2C_RDWR, &data);
+    if (n != nMessages) {
+        // the kernel does not tell which segment failed, so nothing is counted as transferred
+        fIOErrors++;
+        fMode.fetch_or(MODE_UNREACHABLE);
         return -1;
-    n = read(buf, nBytes);
+    }
+    fNrBytesRead += nRead;
+    fGlobalNrBytesRead += nRead;
+    fNrBytesWritten += nWritten;
+    fGlobalNrBytesWritten += nWritten;
+    fMode.fetch_and(static_cast<uint8_t>(~MODE_UNREACHABLE));
     return n;
 }
 
@@ -240,6 +310,49 @@ int16_t i2cDevice::readBytes(uint8_t regAddr, uint16_t length, uint8_t* data)
     return readReg(regAddr, data, length);
 }
 
+/** Read several blocks of registers in one combined transaction.
+* @param blocks Register addresses, lengths and buffers of the blocks
+* @param nBlocks Number of blocks
+* @return Status of operation (true = success)
+*/
+bool i2cDevice::readBytes(RegisterBlock* blocks, int nBlocks)
+{
+    if (nBlocks <= 0 || 2 * nBlocks > I2C_RDWR_IOCTL_MAX_MSGS)
+        return false;
+    Message messages[I2C_RDWR_IOCTL_MAX_MSGS];
+    for (int i = 0; i < nBlocks; i++) {
+        messages[2 * i] = { &blocks[i].reg, 1, false };
+        messages[2 * i + 1] = { blocks[i].data, blocks[i].length, true };
+    }
+    return (transfer(messages, 2 * nBlocks) == 2 * nBlocks);
+}
+
+/** Write several blocks of registers in one combined transaction.
+* The device has to accept a repeated start in place of the stop condition after each block.
+* @param blocks Register addresses, lengths and data of the blocks
+* @param nBlocks Number of blocks
+* @return Status of operation (true = success)
+*/
+bool i2cDevice::writeBytes(const RegisterBlock* blocks, int nBlocks)
+{
+    if (nBlocks <= 0 || nBlocks > I2C_RDWR_IOCTL_MAX_MSGS)
+        return false;
+    std::size_t size = 0;
+    for (int i = 0; i < nBlocks; i++)
+        size += blocks[i].length + 1;
+    std::vector<uint8_t> buf(size);
+    Message messages[I2C_RDWR_IOCTL_MAX_MSGS];
+    std::size_t offset = 0;
+    for (int i = 0; i < nBlocks; i++) {
+        // first byte of each segment is the register address
+        buf[offset] = blocks[i].reg;
+        std::copy(blocks[i].data, blocks[i].data + blocks[i].length, buf.begin() + offset + 1);
+        messages[i] = { &buf[offset], (uint16_t)(blocks[i].length + 1), false };
+        offset += blocks[i].length + 1;
+    }
+    return (transfer(messages, nBlocks) == nBlocks);
+}
+
 /** write a single bit in an 8-bit device register.
 * @param regAddr Register regAddr to write to
 * @param bitNum Bit position to write (0-7)
@@ -361,6 +474,30 @@ void i2cDevice::stopTimer()
     double elapsedTime = (fT2.tv_sec - fT1.tv_sec) * 1000.0; // sec to ms
     elapsedTime += (fT2.tv_usec - fT1.tv_usec) / 1000.0; // us to ms
     fLastTimeInterval = elapsedTime;
+    {
+        std::lock_guard<std::mutex> lock { fLatencyMutex };
+        fLatencyHistogram.fill(elapsedTime);
+    }
     if (fDebugLevel > 1)
         printf(" last transaction took: %6.2f ms\n", fLastTimeInterval);
 }
+
+void i2cDevice::initLatencyHistogram()
+{
+    fLatencyHistogram = Histogram("i2cLatency", MuonPi::Config::Hardware::I2C::latency_bins, 0., MuonPi::Config::Hardware::I2C::latency_max);
+    fLatencyHistogram.setUnit("ms");
+}
+
+Histogram i2cDevice::getLatencyHistogram() const
+{
+    std::lock_guard<std::mutex> lock { fLatencyMutex };
+    return fLatencyHistogram;
+}
+
+Histogram i2cDevice::pollLatencyHistogram()
+{
+    std::lock_guard<std::mutex> lock { fLatencyMutex };
+    Histogram histogram { fLatencyHistogram };
+    fLatencyHistogram.clearChanges();
+    return histogram;
+}
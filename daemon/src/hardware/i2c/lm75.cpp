@@ -15,7 +15,9 @@ int16_t LM75::readRaw()
     readBuf[0] = 0;
     readBuf[1] = 0;
 
-    read(readBuf, 2); // Read the config register into readBuf
+    // set the pointer to the temperature register and read it with a repeated start,
+    // so that the result does not depend on the previously selected register
+    readReg(0x00, readBuf, 2);
 
     val = ((int16_t)readBuf[0] << 8) | readBuf[1];
     fLastRawValue = val;
@@ -108,17 +108,75 @@ bool MCP4728::readChannel(uint8_t channel, DacChannel& channelData)
         return false;
     }
     uint8_t offs = (channelData.eeprom == false) ? 1 : 4;
-    channelData.vref = (buf[channel * 6 + offs] & 0x80) ? VREF_2V : VREF_VDD;
-    channelData.pd = (buf[channel * 6 + offs] & 0x60) >> 5;
-    channelData.gain = (buf[channel * 6 + offs] & 0x10) ? GAIN2 : GAIN1;
-    channelData.value = (uint16_t)(buf[channel * 6 + offs] & 0x0f) << 8;
-    channelData.value |= (uint16_t)(buf[channel * 6 + offs + 1] & 0xff);
+    decodeChannel(buf + channel * 6 + offs, channelData);
 
     stopTimer();
 
     return true;
 }
 
+bool MCP4728::readChannels(DacChannel* dacChannels, DacChannel* eepromChannels)
+{
+    startTimer();
+
+    // the read sequence returns 3 bytes output register and 3 bytes eeprom for each channel
+    uint8_t buf[24];
+    if (read(buf, 24) != 24) {
+        stopTimer();
+        return false;
+    }
+    for (int channel = 0; channel < 4; channel++) {
+        dacChannels[channel].eeprom = false;
+        decodeChannel(buf + channel * 6 + 1, dacChannels[channel]);
+        if (eepromChannels != nullptr) {
+            eepromChannels[channel].eeprom = true;
+            decodeChannel(buf + channel * 6 + 4, eepromChannels[channel]);
+        }
+    }
+
+    stopTimer();
+
+    return true;
+}
+
+bool MCP4728::storeChannels(const DacChannel* channels)
+{
+    for (int channel = 0; channel < 4; channel++) {
+        if (channels[channel].value > 0xfff) {
+            // error number of bits exceeding 12
+            return false;
+        }
+    }
+    startTimer();
+    // sequential write command 01010 starting at channel A, UDAC bit =1
+    // the device programs the eeprom of all channels in one write cycle
+    uint8_t buf[9];
+    buf[0] = 0b01010001;
+    for (int channel = 0; channel < 4; channel++) {
+        const DacChannel& channelData = channels[channel];
+        buf[1 + channel * 2] = ((uint8_t)channelData.vref) << 7; // Vref PD1 PD0 Gx (gain) D11 D10 D9 D8
+        buf[1 + channel * 2] |= (channelData.pd & 0x03) << 5;
+        buf[1 + channel * 2] |= (uint8_t)(channelData.gain & 0x01) << 4;
+        buf[1 + channel * 2] |= (uint8_t)((channelData.value & 0xf00) >> 8);
+        buf[2 + channel * 2] = (uint8_t)(channelData.value & 0xff); // D7 D6 D5 D4 D3 D2 D1 D0
+    }
+    if (write(buf, 9) != 9) {
+        stopTimer();
+        return false;
+    }
+    stopTimer();
+    return true;
+}
+
+void MCP4728::decodeChannel(const uint8_t* buf, DacChannel& channelData)
+{
+    channelData.vref = (buf[0] & 0x80) ? VREF_2V : VREF_VDD;
+    channelData.pd = (buf[0] & 0x60) >> 5;
+    channelData.gain = (buf[0] & 0x10) ? GAIN2 : GAIN1;
+    channelData.value = (uint16_t)(buf[0] & 0x0f) << 8;
+    channelData.value |= (uint16_t)(buf[1] & 0xff);
+}
+
 float MCP4728::code2voltage(const DacChannel& channelData)
 {
     float vref = (channelData.vref == VREF_2V) ? 2.048 : VDD;
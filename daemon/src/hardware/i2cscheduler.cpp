@@ -0,0 +1,64 @@
+#include "hardware/i2cscheduler.h"
+
+namespace MuonPi {
+
+I2cScheduler::I2cScheduler()
+    : m_thread { &I2cScheduler::run, this }
+{
+}
+
+I2cScheduler::~I2cScheduler()
+{
+    stop();
+}
+
+void I2cScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_quit = true;
+    }
+    m_condition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::size_t I2cScheduler::pending() const
+{
+    std::lock_guard<std::mutex> lock { m_mutex };
+    return m_queue.size();
+}
+
+void I2cScheduler::enqueue(Priority priority, std::function<void()> work)
+{
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        if (m_quit) {
+            return;
+        }
+        m_queue.push(Transaction { priority, m_sequence++, std::move(work) });
+    }
+    m_condition.notify_one();
+}
+
+void I2cScheduler::run()
+{
+    for (;;) {
+        std::function<void()> work {};
+        {
+            std::unique_lock<std::mutex> lock { m_mutex };
+            m_condition.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+            if (m_quit) {
+                // discarding the transactions breaks the promises of submitted ones
+                m_queue = decltype(m_queue) {};
+                return;
+            }
+            work = std::move(const_cast<Transaction&>(m_queue.top()).work);
+            m_queue.pop();
+        }
+        work();
+    }
+}
+
+} // namespace MuonPi
@@ -5,11 +5,18 @@
 #include "logengine.h"
 #include "logparameter.h"
 
+#include <algorithm>
+
 static QString dateStringNow()
 {
     return QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd_hh-mm-ss");
 }
 
+static QString averageString(double value, const QString& unit)
+{
+    return QString::number(value, 'f', 7) + " " + unit;
+}
+
 LogEngine::LogEngine(QObject* parent)
     : QObject(parent)
 {
@@ -34,6 +41,24 @@ void LogEngine::onLogParameterReceived(const LogParameter& logpar)
     if (logpar.logType() == LogParameter::LOG_NEVER) {
         return;
     }
+    if (logpar.isNumeric() && (logpar.logType() == LogParameter::LOG_AVERAGE || logpar.logType() == LogParameter::LOG_LATEST)) {
+        NumericLogData& data = numericLogData[logpar.name()];
+        const double value { logpar.number() };
+        if (data.count == 0) {
+            data.min = data.max = value;
+        } else {
+            data.min = std::min(data.min, value);
+            data.max = std::max(data.max, value);
+        }
+        data.sum += value;
+        data.last = value;
+        data.count++;
+        data.logType = logpar.logType();
+        if (data.unit != logpar.unit()) {
+            data.unit = logpar.unit();
+        }
+        return;
+    }
     if (logpar.logType() == LogParameter::LOG_EVERY) {
         // directly log to file since LOG_EVERY attribute is set
         // no need to store in buffer, just return after logging
@@ -66,10 +91,16 @@ void LogEngine::onLogInterval()
     emit sendLogString(dateStringNow() + " softwareVersionString " + QString::fromStdString(MuonPi::Version::software.string()));
     emit sendLogString(dateStringNow() + " hardwareVersionString " + QString::fromStdString(MuonPi::Version::hardware.string()));
 
+    // both maps are sorted by name, the numeric parameters are merged into the loop below
+    // so the lines keep the order of the parameter names
+    auto numericIt = numericLogData.begin();
     // loop over the map with all accumulated parameters since last log reminder
     // no increment here since we erase and invalidate iterators within the loop
     for (auto it = logData.begin(); it != logData.end();) {
         QString name = it.key();
+        for (; numericIt != numericLogData.end() && numericIt.key() < name; ++numericIt) {
+            logNumeric(numericIt.key(), numericIt.value());
+        }
         QVector<LogParameter> parVector = it.value();
         // check if name string is set but no entry exists. This should not happen
         if (parVector.isEmpty()) {
@@ -105,7 +136,7 @@ void LogEngine::onLogInterval()
             }
             if (ok) {
                 sum /= parVector.size();
-                emit sendLogString(dateStringNow() + " " + QString(name + " " + QString::number(sum, 'f', 7) + " " + unitString));
+                emit sendLogString(dateStringNow() + " " + QString(name + " " + averageString(sum, unitString)));
             }
             it = logData.erase(it);
         } else if (parVector.back().logType() == LogParameter::LOG_ONCE) {
@@ -143,5 +174,27 @@ void LogEngine::onLogInterval()
         } else
             ++it;
     }
+    for (; numericIt != numericLogData.end(); ++numericIt) {
+        logNumeric(numericIt.key(), numericIt.value());
+    }
     onceLogFlag = false;
 }
+
+void LogEngine::logNumeric(const QString& name, NumericLogData& data)
+{
+    if (data.count == 0) {
+        return;
+    }
+    if (data.logType == LogParameter::LOG_AVERAGE) {
+        emit sendLogString(dateStringNow() + " " + name + " " + averageString(data.sum / data.count, data.unit));
+        if (MuonPi::Config::Log::min_max) {
+            emit sendLogString(dateStringNow() + " " + name + "Min " + averageString(data.min, data.unit));
+            emit sendLogString(dateStringNow() + " " + name + "Max " + averageString(data.max, data.unit));
+        }
+    } else {
+        emit sendLogString(dateStringNow() + " " + name + " " + LogParameter::formatNumber(data.last, data.unit));
+    }
+    // keep the entry, so the next interval does not have to allocate it again
+    data.sum = 0.;
+    data.count = 0;
+}
@@ -156,6 +156,19 @@ int main(int argc, char* argv[])
         QCoreApplication::translate("main", "dump raw gps device (NMEA) output to stdout"));
     parser.addOption(dumpRawOption);
 
+    // capture and replay of the raw u-blox input
+    QCommandLineOption captureOption("capture",
+        QCoreApplication::translate("main", "capture the raw serial input of the gps device into <file>"),
+        QCoreApplication::translate("main", "file"));
+    parser.addOption(captureOption);
+    QCommandLineOption replayOption("replay",
+        QCoreApplication::translate("main", "replay the gps device input from the capture <file> instead of the serial port"),
+        QCoreApplication::translate("main", "file"));
+    parser.addOption(replayOption);
+    QCommandLineOption replayFastOption("replay-fast",
+        QCoreApplication::translate("main", "replay the capture as fast as possible instead of with the original timing"));
+    parser.addOption(replayFastOption);
+
     // show GNSS configs
     QCommandLineOption showGnssConfigOption("c",
         QCoreApplication::translate("main", "configure standard ubx protocol messages at start"));
@@ -314,6 +327,43 @@ int main(int argc, char* argv[])
     } catch (const libconfig::SettingNotFoundException&) {
     }
 
+    try {
+        daemonConfig.gpioEventFlushWindow = cfg.lookup("gpio_event_flush_window");
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        daemonConfig.gpioEventBatchSize = cfg.lookup("gpio_event_batch_size");
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        std::string mqttHost = cfg.lookup("mqtt_host");
+        daemonConfig.mqtt.host = mqttHost;
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        daemonConfig.mqtt.port = cfg.lookup("mqtt_port");
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        daemonConfig.mqtt.batch_size = cfg.lookup("mqtt_batch_size");
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        daemonConfig.mqtt.batch_latency = cfg.lookup("mqtt_batch_latency");
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
+    try {
+        std::string mqttJournalFile = cfg.lookup("mqtt_journal_file");
+        daemonConfig.mqtt.journal_file = QString::fromStdString(mqttJournalFile);
+    } catch (const libconfig::SettingNotFoundException&) {
+    }
+
     // setup all variables for ublox module manager, then make the object run
     if (!args.empty() && args.at(0) != "") {
         daemonConfig.gpsdevname = args.at(0);
@@ -340,6 +390,12 @@ int main(int argc, char* argv[])
                  << QString("0x%1").arg(reinterpret_cast<std::uint64_t>(QCoreApplication::instance()->thread()));
     }
     daemonConfig.dumpRaw = parser.isSet(dumpRawOption);
+    daemonConfig.ubxCaptureFile = parser.value(captureOption);
+    daemonConfig.ubxReplayFile = parser.value(replayOption);
+    daemonConfig.ubxReplayUnpaced = parser.isSet(replayFastOption);
+    if (!daemonConfig.ubxCaptureFile.isEmpty() && !daemonConfig.ubxReplayFile.isEmpty()) {
+        qWarning() << "capture and replay of the gps device input are exclusive, will only replay";
+    }
     if (parser.isSet(baudrateOption)) {
         daemonConfig.baudrate = parser.value(baudrateOption).toInt(&ok);
         if (!ok || daemonConfig.baudrate < 0) {
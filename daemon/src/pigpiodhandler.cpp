@@ -1,6 +1,7 @@
 #include <QDebug>
 #include <QPointer>
 #include <cmath>
+#include <cstdlib>
 #include <config.h>
 #include <exception>
 #include "utility/gpio_mapping.h"
@@ -17,64 +18,6 @@ static int pi = -1;
 static int spiHandle = -1;
 static QPointer<PigpiodHandler> pigHandlerAddress; // QPointer automatically clears itself if pigHandler object is destroyed
 
-template <typename T>
-inline static T sqr(T x) { return x * x; }
-
-/*
- linear regression algorithm
- taken from:
-   http://stackoverflow.com/questions/5083465/fast-efficient-least-squares-fit-algorithm-in-c
- parameters:
-  n = number of data points
-  xarray,yarray  = arrays of data
-  *offs = output intercept
-  *slope  = output slope
- */
-void calcLinearCoefficients(int n, quint64* xarray, qint64* yarray,
-    double* offs, double* slope, int arrayIndex = 0)
-{
-    if (n < 3)
-        return;
-
-    long double sumx = 0.0L; /* sum of x                      */
-    long double sumx2 = 0.0L; /* sum of x**2                   */
-    long double sumxy = 0.0L; /* sum of x * y                  */
-    long double sumy = 0.0L; /* sum of y                      */
-    long double sumy2 = 0.0L; /* sum of y**2                   */
-
-    int ix = arrayIndex;
-    if (ix == 0)
-        ix = n - 1;
-    else
-        ix--;
-
-    quint64 offsx = xarray[ix];
-    qint64 offsy = yarray[ix];
-
-    int i;
-    for (i = 0; i < n; i++) {
-        sumx += xarray[i] - offsx;
-        sumx2 += sqr(xarray[i] - offsx);
-        sumxy += (xarray[i] - offsx) * (yarray[i] - offsy);
-        sumy += (yarray[i] - offsy);
-        sumy2 += sqr(yarray[i] - offsy);
-    }
-
-    double denom = (n * sumx2 - sqr(sumx));
-    if (denom == 0) {
-        // singular matrix. can't solve the problem.
-        *slope = 0.;
-        *offs = 0.;
-        return;
-    }
-
-    long double m = (n * sumxy - sumx * sumy) / denom;
-    long double b = (sumy * sumx2 - sumx * sumxy) / denom;
-
-    *slope = (double)m;
-    *offs = (double)(b + offsy);
-}
-
 /* This is the central interrupt routine for all registered GPIO pins
  *
  */
@@ -92,6 +35,13 @@ static void cbFunction(int user_pi, unsigned int user_gpio,
 
     QPointer<PigpiodHandler> pigpioHandler = pigHandlerAddress;
 
+    // the end of an adc conversion is reported regardless of inhibit and pileup, the conversion waits for it.
+    // it is no detector event and is not forwarded to the event queue
+    if (gpioPinInfo(user_gpio).flags & GpioPinInfo::ADC_READY_SIGNAL) {
+        emit pigpioHandler->adcConversionReady();
+        return;
+    }
+
     if (pigpioHandler->isInhibited())
         return;
 
@@ -122,58 +72,46 @@ static void cbFunction(int user_pi, unsigned int user_gpio,
     try {
         // allow only registered signals to be processed here
         // if gpio pin fired which is not in GPIO_PIN list, return immediately
-        auto it = std::find_if(GPIO_PINMAP.cbegin(), GPIO_PINMAP.cend(),
-            [&user_gpio](const std::pair<GPIO_PIN, unsigned int>& val) {
-                if (val.second == user_gpio)
-                    return true;
-                return false;
-            });
-        if (it == GPIO_PINMAP.end())
+        const GpioPinInfo pinInfo = gpioPinInfo(user_gpio);
+        if (pinInfo.signal == UNDEFINED_PIN)
             return;
 
-        QDateTime now = QDateTime::currentDateTimeUtc();
+        // the tick is extended with the same overflow counter as the clock measurement, so that the model applies
+        const MuonPi::GpioClockModel& clockModel { pigpioHandler->clockModel() };
+        const uint64_t extendedTick { clockModel.extend(tick) };
+        const int64_t utc_ns { clockModel.toUtcNs(extendedTick) };
 
-        if (user_gpio == GPIO_PINMAP[pigpioHandler->samplingTriggerSignal]) {
+        if (pinInfo.flags & GpioPinInfo::SAMPLING_TRIGGER) {
+            QDateTime now = QDateTime::currentDateTimeUtc();
             if (pigpioHandler->lastSamplingTime.msecsTo(now) >= MuonPi::Config::Hardware::ADC::deadtime) {
                 emit pigpioHandler->samplingTrigger();
                 pigpioHandler->lastSamplingTime = now;
             }
-            quint64 nsecsElapsed = pigpioHandler->elapsedEventTimer.nsecsElapsed();
             pigpioHandler->elapsedEventTimer.start();
-            emit pigpioHandler->eventInterval((tick - lastTriggerTick) * 1000);
+            if (pigpioHandler->legacyEventSignals()) {
+                emit pigpioHandler->eventInterval((tick - lastTriggerTick) * 1000);
+            }
             lastTriggerTick = tick;
         }
 
-        if (user_gpio == GPIO_PINMAP[TIMEPULSE]) {
+        if (pinInfo.flags & GpioPinInfo::TIMEPULSE_SIGNAL) {
             struct timespec ts;
             clock_gettime(CLOCK_REALTIME, &ts);
-            quint64 timestamp = pigpioHandler->gpioTickOverflowCounter + tick;
-            quint64 t0 = pigpioHandler->startOfProgram.toMSecsSinceEpoch();
-
-            long double meanDiff = pigpioHandler->clockMeasurementOffset;
-
-            long double dx = timestamp - pigpioHandler->lastTimeMeasurementTick;
-            long double dy = pigpioHandler->clockMeasurementSlope * dx;
-            meanDiff += dy;
-
-            qint64 meanDiffInt = (qint64)meanDiff;
-            double meanDiffFrac = (meanDiff - (qint64)meanDiff);
-            timestamp += meanDiffInt; // add diff to real time
-            long int ts_sec = timestamp / 1000000 + (t0 / 1000); // conv. us to s
-            long int ts_nsec = 1000 * (timestamp % 1000000) + (t0 % 1000) * 1000000L;
-            ts_nsec += (long int)(1000. * meanDiffFrac);
-
-            long double ppsOffs = (ts_sec - ts.tv_sec) + ts_nsec * 1e-9;
-            if (std::fabs(ppsOffs) < 3600.) {
-                qint32 t_diff_us = (double)(ppsOffs)*1e6;
-                emit pigpioHandler->timePulseDiff(t_diff_us);
+            if (utc_ns != 0) {
+                const qint64 ppsOffs_ns { utc_ns - static_cast<qint64>(ts.tv_sec) * 1000000000LL };
+                if (std::llabs(ppsOffs_ns) < 3600LL * 1000000000LL) {
+                    emit pigpioHandler->timePulseDiff(static_cast<qint32>(ppsOffs_ns / 1000));
+                }
             }
         }
-        
-        emit pigpioHandler->signal(user_gpio);
-         
+
         // level gives the information if it is up or down (only important if trigger is
         // at both: rising and falling edge)
+        pigpioHandler->enqueueEvent(GpioEvent { extendedTick, utc_ns, static_cast<uint8_t>(user_gpio), static_cast<uint8_t>(level) });
+
+        if (pigpioHandler->legacyEventSignals()) {
+            emit pigpioHandler->signal(user_gpio);
+        }
     } catch (std::exception& e) {
         pigpioHandler = 0;
         pigpio_stop(pi);
@@ -213,6 +151,22 @@ PigpiodHandler::PigpiodHandler(QVector<unsigned int> gpioPins, unsigned int spi_
     gpioClockTimeMeasurementTimer.start();
 }
 
+void PigpiodHandler::enqueueEvent(const GpioEvent& event)
+{
+    m_eventBuffer.push(event);
+    // notify the consumer only once per batch: the flag is cleared by acknowledgeEvents()
+    // when the consumer starts draining, so at most one queued signal is pending at any time
+    if (!m_eventsPending.exchange(true, std::memory_order_acq_rel)) {
+        emit eventsAvailable();
+    }
+}
+
+void PigpiodHandler::setSamplingTriggerSignal(GPIO_PIN signalName)
+{
+    samplingTriggerSignal = signalName;
+    setGpioSamplingTrigger(signalName);
+}
+
 void PigpiodHandler::setInput(unsigned int gpio)
 {
     if (isInitialised)
@@ -361,44 +315,19 @@ void PigpiodHandler::measureGpioClockTime()
     if (!isInitialised)
         return;
     static uint32_t oldTick = 0;
-    const int N = MuonPi::Config::Hardware::GPIO::Clock::Measurement::buffer_size;
-    static int nrSamples = 0;
-    static int arrayIndex = 0;
-    static qint64 diff_array[N];
-    static quint64 tick_array[N];
-    struct timespec tp, tp1, tp2;
-
-    quint64 t0 = startOfProgram.toMSecsSinceEpoch();
+    struct timespec tp1, tp2;
 
+    // bracket the tick readout with two system time readings and take the midpoint
     clock_gettime(CLOCK_REALTIME, &tp1);
     uint32_t tick = get_current_tick(pi);
     clock_gettime(CLOCK_REALTIME, &tp2);
 
-    qint64 dt = tp2.tv_sec - tp1.tv_sec;
-    dt *= 1000000000LL;
-    dt += (tp2.tv_nsec - tp1.tv_nsec);
-    dt /= 2000;
-
-    tp = tp1;
+    const qint64 t1_ns { static_cast<qint64>(tp1.tv_sec) * 1000000000LL + tp1.tv_nsec };
+    const qint64 t2_ns { static_cast<qint64>(tp2.tv_sec) * 1000000000LL + tp2.tv_nsec };
 
     if (tick < oldTick) {
         gpioTickOverflowCounter = gpioTickOverflowCounter + UINT32_MAX + 1;
     }
     oldTick = tick;
-    quint64 nr_usecs = ((quint64)tp.tv_sec * 1000 - t0) * 1000;
-    nr_usecs += tp.tv_nsec / 1000 + dt;
-    diff_array[arrayIndex] = (qint64)(nr_usecs - gpioTickOverflowCounter) - tick;
-    tick_array[arrayIndex] = (quint64)gpioTickOverflowCounter + tick;
-    lastTimeMeasurementTick = (quint64)gpioTickOverflowCounter + tick;
-    if (++arrayIndex >= N) {
-        arrayIndex = 0;
-    }
-    if (nrSamples < N)
-        nrSamples++;
-
-    double offs = 0.;
-    double slope = 0.;
-    calcLinearCoefficients(nrSamples, tick_array, diff_array, &offs, &slope, arrayIndex);
-    clockMeasurementSlope = slope;
-    clockMeasurementOffset = offs;
+    m_clockModel.addSample(gpioTickOverflowCounter + tick, t1_ns + (t2_ns - t1_ns) / 2);
 }
@@ -1,6 +1,7 @@
 #include <QDebug>
 #include <QEventLoop>
 #include <QThread>
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <muondetector_structs.h>
@@ -22,6 +23,11 @@ void QtSerialUblox::closeAll()
         serialPort->flush();
         serialPort->close();
     }
+    if (!m_replayTimer.isNull()) {
+        m_replayTimer->stop();
+    }
+    // writes the remaining buffered data of the capture
+    m_capture.reset();
 }
 
 std::string QtSerialUblox::toStdString(unsigned char* data, int dataSize)
@@ -44,6 +50,7 @@ QtSerialUblox::QtSerialUblox(const QString serialPortName, int newTimeout, int b
     showout = newShowout;
     showin = newShowin;
     timeout = newTimeout;
+    registerUbxHandlers();
 }
 
 void QtSerialUblox::makeConnection()
@@ -53,6 +60,10 @@ void QtSerialUblox::makeConnection()
     if (verbose > 4) {
         qInfo() << this->thread()->objectName() << " thread id (pid): " << syscall(SYS_gettid);
     }
+    if (!m_replayFile.isEmpty()) {
+        startReplay();
+        return;
+    }
     if (!serialPort.isNull()) {
         serialPort.clear();
     }
@@ -74,68 +85,100 @@ void QtSerialUblox::makeConnection()
     connect(ackTimer, &QTimer::timeout, this, &QtSerialUblox::ackTimeout);
     connect(serialPort, &QSerialPort::readyRead, this, &QtSerialUblox::onReadyRead);
     serialPort->clear(QSerialPort::AllDirections);
+    if (!m_captureFile.isEmpty()) {
+        m_capture = std::make_unique<MuonPi::UbxCaptureWriter>(m_captureFile.toStdString());
+        if (m_capture->isOpen()) {
+            emit toConsole(QString("capturing the serial input to %1\n").arg(m_captureFile));
+        } else {
+            emit toConsole(QString("could not open capture file %1\n").arg(m_captureFile));
+            m_capture.reset();
+        }
+    }
     if (verbose == 1) {
         emit toConsole("rising               falling               accEst valid timebase utc\n");
     }
 }
 
-void QtSerialUblox::sendQueuedMsg(bool afterTimeout)
+void QtSerialUblox::sendQueuedMsg()
 {
-    if (afterTimeout) {
-        if (msgWaitingForAck == nullptr) {
-            return;
-        }
-        if (++sendRetryCounter >= MAX_SEND_RETRIES) {
-            sendRetryCounter = 0;
-            ackTimer->stop();
-            delete msgWaitingForAck;
-            msgWaitingForAck = nullptr;
-            if (verbose > 1)
-                emit toConsole("sendQueuedMsg: deleted message after 5 timeouts\n");
-            sendQueuedMsg();
-            return;
-        }
-        ackTimer->start(timeout);
-        sendUBX(*msgWaitingForAck);
-        if (verbose > 1)
-            emit toConsole("sendQueuedMsg: repeated resend after timeout\n");
+    // fill the window of outstanding commands, the ACKs are collected asynchronously
+    while (!outMsgBuffer.empty() && m_inFlight.size() < MuonPi::Config::Hardware::Ublox::max_commands_in_flight) {
+        PendingCommand command {};
+        command.msg = std::move(outMsgBuffer.front());
+        outMsgBuffer.pop();
+        command.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        sendUBX(command.msg);
+        m_inFlight.push_back(std::move(command));
+        if (verbose > 2)
+            emit toConsole(QString("sendQueuedMsg: sent fresh message, %1 in flight\n").arg(m_inFlight.size()));
+    }
+    restartAckTimer();
+}
+
+void QtSerialUblox::restartAckTimer()
+{
+    if (ackTimer.isNull()) {
         return;
     }
-    if (outMsgBuffer.empty()) {
+    if (m_inFlight.empty()) {
+        ackTimer->stop();
         return;
     }
-    if (msgWaitingForAck) {
-        if (verbose > 1) {
-            emit toConsole("tried to send queued message but ack for previous message not yet received\n");
-        }
-        return;
+    auto earliest = m_inFlight.front().deadline;
+    for (const auto& command : m_inFlight) {
+        earliest = std::min(earliest, command.deadline);
     }
-    msgWaitingForAck = new UbxMessage;
-    *msgWaitingForAck = outMsgBuffer.front();
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(earliest - std::chrono::steady_clock::now());
     ackTimer->setSingleShot(true);
-    ackTimer->start(timeout);
-    sendUBX(*msgWaitingForAck);
-    if (verbose > 2)
-        emit toConsole("sendQueuedMsg: sent fresh message\n");
-    outMsgBuffer.pop();
+    ackTimer->start(std::max<int>(0, remaining.count()));
 }
 
 void QtSerialUblox::ackTimeout()
 {
-    if (msgWaitingForAck == nullptr) {
-        return;
-    }
-    if (verbose > 1) {
-        std::stringstream tempStream;
-        tempStream << "ack timeout, trying to resend message 0x" << std::setfill('0') << std::setw(2) << hex
-                   << ((msgWaitingForAck->msgID & 0xff00) >> 8) << " 0x" << std::setfill('0') << std::setw(2) << hex << (msgWaitingForAck->msgID & 0x00ff);
-        for (unsigned int i = 0; i < msgWaitingForAck->data.length(); i++) {
-            tempStream << " 0x" << std::setfill('0') << std::setw(2) << hex << (int)(msgWaitingForAck->data[i]);
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (it->deadline > now) {
+            ++it;
+            continue;
+        }
+        if (++it->retries >= MAX_SEND_RETRIES) {
+            if (verbose > 1) {
+                emit toConsole(QString("ackTimeout: deleted message 0x%1 after %2 timeouts\n")
+                                   .arg(it->msg.msgID, 4, 16, QChar('0'))
+                                   .arg(MAX_SEND_RETRIES));
+            }
+            it = m_inFlight.erase(it);
+            continue;
+        }
+        if (verbose > 1) {
+            std::stringstream tempStream;
+            tempStream << "ack timeout, trying to resend message 0x" << std::setfill('0') << std::setw(2) << hex
+                       << ((it->msg.msgID & 0xff00) >> 8) << " 0x" << std::setfill('0') << std::setw(2) << hex << (it->msg.msgID & 0x00ff);
+            for (unsigned int i = 0; i < it->msg.data.length(); i++) {
+                tempStream << " 0x" << std::setfill('0') << std::setw(2) << hex << (int)(it->msg.data[i]);
+            }
+            tempStream << endl;
+            emit toConsole(QString::fromStdString(tempStream.str()));
         }
-        tempStream << endl;
-        emit toConsole(QString::fromStdString(tempStream.str()));
+        it->deadline = now + std::chrono::milliseconds(timeout);
+        sendUBX(it->msg);
+        ++it;
     }
-    sendQueuedMsg(true);
+    // expired messages may have freed slots in the window
+    sendQueuedMsg();
+}
+
+void QtSerialUblox::completePoll(uint16_t msgID)
+{
+    // polls of non-CFG messages are not acknowledged, the answer itself completes the request
+    auto it = std::find_if(m_inFlight.begin(), m_inFlight.end(), [msgID](const PendingCommand& command) {
+        return command.msg.msgID == msgID && command.msg.data.empty();
+    });
+    if (it == m_inFlight.end()) {
+        return;
+    }
+    m_inFlight.erase(it);
+    sendQueuedMsg();
 }
 
 void QtSerialUblox::onReadyRead()
@@ -145,95 +188,101 @@ void QtSerialUblox::onReadyRead()
         return;
     }
     QByteArray temp = serialPort->readAll();
-    if (dumpRaw) {
-        emit toConsole(QString(temp));
-    }
-    for (int i = 0; i < temp.size(); i++) {
-        m_buffer += temp.data()[i];
-    }
-    UbxMessage message;
-    while (scanUnknownMessage(m_buffer, message)) {
-        // so it found a message therefore we can now process the message
-        if (showin) {
-            std::stringstream tempStream;
-            tempStream << " in: ";
-            int classID = (int)((message.msgID & 0xff00) >> 8);
-            int msgID = (int)(message.msgID & 0xff);
-            tempStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << classID;
-            tempStream << " 0x" << std::setfill('0') << std::setw(2) << std::hex << msgID << " ";
-            for (std::string::size_type i = 0; i < message.data.length(); i++) {
-                tempStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << (int)(message.data[i]) << " ";
-            }
-            tempStream << "\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
-        }
-        processMessage(message);
+    if (m_capture) {
+        m_capture->append(temp.constData(), temp.size());
     }
+    ingest(temp);
 }
 
-bool QtSerialUblox::scanUnknownMessage(string& buffer, UbxMessage& message)
-{ // gets the (maybe not finished) buffer and checks for messages in it that make sense
-    if (buffer.size() < 9)
-        return false;
-    std::string refstr = "";
-    // refstr are the first two hex numbers defining the header of an ubx message
-    refstr += static_cast<unsigned char>(0xb5);
-    refstr += 0x62;
-    std::size_t found = buffer.find(refstr);
-    std::string mess = "";
-    if (found != string::npos) {
-        mess = buffer.substr(found, buffer.size());
-        // discard everything before start of the message
-        buffer.erase(0, found);
-    } else {
-        // discard everything before the start of a NMEA message, too
-        // to ensure that buffer won't grow too big
-        if (discardAllNMEA) {
-            std::string beginNMEA = "$";
-            found = 0;
-            while (found != string::npos) {
-                found = buffer.find(beginNMEA);
-                if (found == string::npos) {
-                    break;
-                }
-                buffer.erase(0, found + 1);
-            }
-        }
-        return false;
-    }
-    message.msgID = (uint16_t)mess[2] << 8;
-    message.msgID += (uint16_t)mess[3];
-    if (mess.size() < 8)
-        return false;
-    int len = (int)(mess[4]);
-    len += ((int)(mess[5])) << 8;
-    if (((long int)mess.size() - 8) < len) {
-        found = buffer.find(refstr, 2);
-        if (found != string::npos) {
-            if (verbose > 1) {
+void QtSerialUblox::ingest(const QByteArray& temp)
+{
+    if (dumpRaw) {
+        emit toConsole(QString(temp));
+    }
+    const char* data = temp.constData();
+    std::size_t remaining = temp.size();
+    while (remaining > 0) {
+        // the framer only accepts as many bytes as fit into its ring buffer,
+        // so drain complete frames before writing the rest
+        const std::size_t written = m_framer.write(data, remaining);
+        data += written;
+        remaining -= written;
+        MuonPi::UbxFramer::Frame frame;
+        while (m_framer.next(frame)) {
+            // so it found a message therefore we can now process the message
+            if (showin) {
                 std::stringstream tempStream;
-                tempStream << "received faulty UBX string:\n " << dec;
-                for (std::string::size_type i = 0; i < found; i++)
-                    tempStream
-                        << setw(2) << hex << "0x" << (int)buffer[i] << " ";
-                tempStream << endl;
+                tempStream << " in: ";
+                int classID = (int)((frame.msgID & 0xff00) >> 8);
+                int msgID = (int)(frame.msgID & 0xff);
+                tempStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << classID;
+                tempStream << " 0x" << std::setfill('0') << std::setw(2) << std::hex << msgID << " ";
+                for (std::string_view::size_type i = 0; i < frame.payload.length(); i++) {
+                    tempStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << (int)(uint8_t)(frame.payload[i]) << " ";
+                }
+                tempStream << "\n";
                 emit toConsole(QString::fromStdString(tempStream.str()));
             }
-            buffer.erase(0, found);
+            processMessage(frame.msgID, frame.payload);
         }
-        return false;
     }
-    buffer.erase(0, len + 8);
+    const MuonPi::UbxFramer::Statistics& stats = m_framer.statistics();
+    if (stats.checksumErrors + stats.resyncs != m_reportedStreamErrors) {
+        m_reportedStreamErrors = stats.checksumErrors + stats.resyncs;
+        if (verbose > 1) {
+            emit toConsole(QString("received faulty UBX data: %1 checksum errors, %2 resyncs, %3 oversized frames so far\n")
+                               .arg(stats.checksumErrors)
+                               .arg(stats.resyncs)
+                               .arg(stats.oversizedFrames));
+        }
+        emit UBXStreamErrors(stats.checksumErrors, stats.resyncs);
+    }
+}
 
-    unsigned char chkA;
-    unsigned char chkB;
-    calcChkSum(mess.substr(0, len + 6), &chkA, &chkB);
-    if (mess[len + 6] == chkA && mess[len + 7] == chkB) {
-        message.data = mess.substr(6, len);
-        return true;
+void QtSerialUblox::startReplay()
+{
+    m_replay = std::make_unique<MuonPi::UbxCaptureReader>(m_replayFile.toStdString());
+    if (!m_replay->isOpen()) {
+        emit toConsole(QString("could not open capture file %1 for replay\n").arg(m_replayFile));
+        m_replay.reset();
+        return;
     }
+    emit toConsole(QString("replaying capture file %1 %2\n")
+                       .arg(m_replayFile)
+                       .arg((m_replaySpeed == ReplaySpeed::WireSpeed) ? "at wire speed" : "as fast as possible"));
+    m_replayTimer = new QTimer(this);
+    m_replayTimer->setSingleShot(true);
+    m_replayTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_replayTimer, &QTimer::timeout, this, &QtSerialUblox::replayNext);
+    m_replayStart = std::chrono::steady_clock::now();
+    m_replayPending = m_replay->next(m_replayChunk);
+    replayNext();
+}
 
-    return false;
+void QtSerialUblox::replayNext()
+{
+    if (!m_replay) {
+        return;
+    }
+    // return to the event loop regularly, so that the emitted signals are delivered while replaying
+    std::size_t processed { 0 };
+    while (m_replayPending) {
+        if (m_replaySpeed == ReplaySpeed::WireSpeed) {
+            const auto wait { m_replayStart + m_replayChunk.time - std::chrono::steady_clock::now() };
+            if (wait > std::chrono::steady_clock::duration::zero()) {
+                m_replayTimer->start(static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(wait).count()));
+                return;
+            }
+        } else if (processed++ >= MuonPi::Config::Hardware::Ublox::Replay::batch) {
+            m_replayTimer->start(0);
+            return;
+        }
+        ingest(QByteArray::fromRawData(m_replayChunk.data.data(), static_cast<int>(m_replayChunk.data.size())));
+        m_replayPending = m_replay->next(m_replayChunk);
+    }
+    emit toConsole(QString("replay of capture file %1 finished\n").arg(m_replayFile));
+    m_replay.reset();
+    emit replayFinished();
 }
 
 bool QtSerialUblox::sendUBX(uint16_t msgID, const std::string& payload, uint16_t nBytes)
@@ -251,25 +300,26 @@ bool QtSerialUblox::sendUBX(uint16_t msgID, const std::string& payload, uint16_t
     calcChkSum(s, &chkA, &chkB);
     s += chkA;
     s += chkB;
+    if (!m_replayFile.isEmpty()) {
+        // there is no device to talk to while replaying a capture, the message is discarded
+        return true;
+    }
     if (!serialPort.isNull()) {
         QByteArray block(s.c_str(), s.size());
-        if (serialPort->write(block)) {
-            if (serialPort->waitForBytesWritten(timeout)) {
-                if (showout) {
-                    std::stringstream tempStream;
-                    tempStream << "out: ";
-                    for (std::string::size_type i = 2; i < s.length(); i++) {
-                        tempStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << (int)s[i] << " ";
-                    }
-                    tempStream << "\n";
-                    emit toConsole(QString::fromStdString(tempStream.str()));
+        // QSerialPort buffers the data and writes it from the event loop, so this does not block
+        if (serialPort->write(block) == block.size()) {
+            if (showout) {
+                std::stringstream tempStream;
+                tempStream << "out: ";
+                for (std::string::size_type i = 2; i < s.length(); i++) {
+                    tempStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << (int)s[i] << " ";
                 }
-                return true;
-            } else {
-                emit toConsole("wait for bytes written timeout while trying to write to serialPort");
+                tempStream << "\n";
+                emit toConsole(QString::fromStdString(tempStream.str()));
             }
+            return true;
         } else {
-            emit toConsole("error writing to serialPort");
+            emit toConsole("error writing to serialPort: " + serialPort->errorString() + "\n");
         }
     } else {
         emit toConsole("error: serialPort not instantiated");
@@ -517,9 +567,7 @@ void QtSerialUblox::pollMsg(uint16_t msgID)
         msg.msgID = msgID;
         msg.data = toStdString(temp, 1);
         outMsgBuffer.push(msg);
-        if (!msgWaitingForAck) {
-            sendQueuedMsg();
-        }
+        sendQueuedMsg();
         break;
     case UBX_MON_VER:
         // the VER message apparently does not confirm reception with an ACK
@@ -549,11 +597,14 @@ auto QtSerialUblox::getProtVersion() -> double
 
 void QtSerialUblox::enqueueMsg(uint16_t msgID, const std::string& payload)
 {
+    if (!m_replayFile.isEmpty()) {
+        // there is no device to talk to while replaying a capture, a command would never be acknowledged
+        // and the ACKs in the capture belong to the commands of the recorded session
+        return;
+    }
     UbxMessage newMessage;
     newMessage.msgID = msgID;
     newMessage.data = payload;
     outMsgBuffer.push(newMessage);
-    if (!msgWaitingForAck) {
-        sendQueuedMsg();
-    }
+    sendQueuedMsg();
 }
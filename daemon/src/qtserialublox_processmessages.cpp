@@ -1,11 +1,14 @@
 #include "utility/custom_io_operators.h"
+#include "utility/ubx_payload.h"
 #include "utility/unixtime_from_gps.h"
 #include "qtserialublox.h"
 
 #include <muondetector_structs.h>
 #include <ublox_messages.h>
 
+#include <QMetaMethod>
 #include <QThread>
+#include <algorithm>
 #include <cctype>
 #include <iomanip>
 #include <sstream>
@@ -14,370 +17,223 @@ using namespace std;
 
 const uint8_t usedPort = 1; // this is the uart port. (0 = i2c; 1 = uart; 2 = usb; 3 = isp;)
     // see u-blox8-M8_Receiver... pdf documentation site 170
-// all about processing different ubx-messages:
-void QtSerialUblox::processMessage(const UbxMessage& msg)
+namespace {
+const char* ubxClassName(uint8_t classID)
 {
-    uint8_t classID = (msg.msgID & 0xff00) >> 8;
-    uint8_t messageID = msg.msgID & 0xff;
-    std::vector<GnssSatellite> sats;
-    std::stringstream tempStream;
-    uint16_t ackedMsgID;
     switch (classID) {
-    case 0x05: // UBX-ACK
-        if (msg.data.size() < 2) {
-            emit toConsole("received UBX-ACK message but data is corrupted\n");
-            break;
-        }
-        if (!msgWaitingForAck) {
-            if (verbose > 1) {
-                tempStream << "received ACK message but no message is waiting for Ack (msgID: 0x";
-                tempStream << std::setfill('0') << std::setw(2) << std::hex << (int)msg.data[0] << " 0x"
-                           << std::setfill('0') << std::setw(2) << std::hex << (int)msg.data[1] << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            break;
-        }
-        if (verbose > 2) {
-            if (messageID == 1)
-                tempStream << "received UBX-ACK-ACK message about msgID: 0x";
-            else
-                tempStream << "received UBX-ACK-NACK message about msgID: 0x";
-            tempStream << std::setfill('0') << std::setw(2) << std::hex << (int)msg.data[0] << " 0x"
-                       << std::setfill('0') << std::setw(2) << std::hex << (int)msg.data[1] << "\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
-        }
-        ackedMsgID = (uint16_t)(msg.data[0]) << 8 | msg.data[1];
-        if (ackedMsgID != msgWaitingForAck->msgID) {
-            if (verbose > 1) {
-                tempStream << "received unexpected UBX-ACK message about msgID: 0x";
-                tempStream << std::setfill('0') << std::setw(2) << std::hex << (int)msg.data[0] << " 0x"
-                           << std::setfill('0') << std::setw(2) << std::hex << (int)msg.data[1] << "\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            break;
-        }
-        switch (messageID) {
-        case 0x00:
-            emit UBXReceivedAckNak(msgWaitingForAck->msgID,
-                (uint16_t)(msgWaitingForAck->data[0]) << 8
-                    | msgWaitingForAck->data[1]);
-            break;
-        default:
-            break;
-        }
-        ackTimer->stop();
-        delete msgWaitingForAck;
-        msgWaitingForAck = 0;
-        if (verbose > 2)
-            emit toConsole("processMessage: deleted message after ACK/NACK\n");
-        sendQueuedMsg();
-        break;
-    case 0x01: // UBX-NAV
-        switch (messageID) {
-        case 0x03:
-            if (verbose > 2) {
-                tempStream << "received UBX-NAV-STATUS message (0x" << std::hex << std::setfill('0') << std::setw(2)
-                           << (int)classID << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXNavStatus(msg.data);
-            break;
-        case 0x04:
-            if (verbose > 2) {
-                tempStream << "received UBX-NAV-DOP message (0x" << std::hex << std::setfill('0') << std::setw(2)
-                           << (int)classID << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXNavDOP(msg.data);
-            break;
-        case 0x20:
-            if (verbose > 2) {
-                tempStream << "received UBX-NAV-TIMEGPS message (0x" << std::hex << std::setfill('0') << std::setw(2)
-                           << (int)classID << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXNavTimeGPS(msg.data);
-            break;
-        case 0x21:
-            if (verbose > 2) {
-                tempStream << "received UBX-NAV-TIMEUTC message (0x" << std::hex << std::setw(2)
-                           << (int)classID << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXNavTimeUTC(msg.data);
-            break;
-        case 0x22:
-            if (verbose > 2) {
-                tempStream << "received UBX-NAV-CLOCK message (0x" << std::hex << std::setfill('0') << std::setw(2)
-                           << (int)classID << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXNavClock(msg.data);
-            break;
-        case 0x30:
-            sats = UBXNavSVinfo(msg.data, true);
-            if (verbose > 2) {
-                tempStream << "received UBX-NAV-SVINFO message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                tempStream << "nr sats = " << sats.size() << "\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            emit gpsPropertyUpdatedGnss(sats, m_satList.updateAge());
-            m_satList = sats;
-            break;
-        case 0x35:
-            sats = UBXNavSat(msg.data, true);
-            if (verbose > 2) {
-                tempStream << "received UBX-NAV-SAT message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            emit gpsPropertyUpdatedGnss(sats, m_satList.updateAge());
-            m_satList = sats;
-            break;
-        case 0x02:
-            if (verbose > 2) {
-                tempStream << "received UBX-NAV-POSLLH message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            geodeticPos = UBXNavPosLLH(msg.data);
-            emit gpsPropertyUpdatedGeodeticPos(geodeticPos());
-            break;
-        default:
-            if (verbose > 2) {
-                tempStream << "received unhandled UBX-NAV message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-        }
-        break;
-    case 0x02: // UBX-RXM
-        if (verbose > 2) {
-            tempStream << "received unhandled UBX-RXM message\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
-        }
-        break;
-    case 0x0b: // UBX-AID
-        if (verbose > 2) {
-            tempStream << "received unhandled UBX-AID message\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
-        }
-        break;
-    case 0x06: // UBX-CFG
-        switch (messageID) {
-        case 0x01: // UBX-CFG-MSG   (message configuration)
-            emit UBXreceivedMsgRateCfg(
-                (((uint16_t)msg.data[0]) << 8) | ((uint16_t)msg.data[1]),
-                (uint8_t)(msg.data[2 + usedPort]));
-            // 2: port 0 (i2c); 3: port 1 (uart); 4: port 2 (usb); 5: port 3 (isp)
-            break;
-        case 0x13: // UBX-CFG-ANT
-            if (verbose > 2) {
-                tempStream << "received UBX-CFG-ANT message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXCfgAnt(msg.data);
-            break;
-        case 0x24: // UBX-CFG-NAV5
-            if (verbose > 2) {
-                tempStream << "received UBX-CFG-NAV5 message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXCfgNav5(msg.data);
-            break;
-        case 0x23: // UBX-CFG-NAVX5
-            if (verbose > 2) {
-                tempStream << "received UBX-CFG-NAVX5 message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXCfgNavX5(msg.data);
-            break;
-        case 0x31: // UBX-CFG-TP5
-            if (verbose > 2) {
-                tempStream << "received UBX-CFG-TP5 message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXCfgTP5(msg.data);
-            break;
-        case 0x3e: // UBX-CFG-GNSS
-            if (verbose > 2) {
-                tempStream << "received UBX-CFG-GNSS message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXCfgGNSS(msg.data);
-            break;
-        default:
-            if (verbose > 2) {
-                tempStream << "received unhandled UBX-CFG message:";
-                for (std::string::size_type i = 0; i < msg.data.size(); i++) {
-                    tempStream << " 0x" << std::setfill('0') << std::setw(2) << std::hex << (int)msg.data[i];
-                }
-                tempStream << "\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-        }
-        break;
-    case 0x10: // UBX-ESF
-        if (verbose > 2) {
-            tempStream << "received unhandled UBX-ESF message\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
-        }
-        break;
-    case 0x28: // UBX-HNR
-        if (verbose > 2) {
-            tempStream << "received unhandled UBX-HNR message\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
-        }
-        break;
-    case 0x04: // UBX-INF
-        switch (messageID) {
-        default:
-            if (verbose > 2) {
-                tempStream << "received unhandled UBX-INF message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-        }
-        break;
-    case 0x21: // UBX-LOG
+    case 0x01:
+        return "NAV";
+    case 0x02:
+        return "RXM";
+    case 0x04:
+        return "INF";
+    case 0x05:
+        return "ACK";
+    case 0x06:
+        return "CFG";
+    case 0x09:
+        return "UPD";
+    case 0x0a:
+        return "MON";
+    case 0x0b:
+        return "AID";
+    case 0x0d:
+        return "TIM";
+    case 0x10:
+        return "ESF";
+    case 0x13:
+        return "MGA";
+    case 0x21:
+        return "LOG";
+    case 0x27:
+        return "SEC";
+    case 0x28:
+        return "HNR";
+    default:
+        return nullptr;
+    }
+}
+} // namespace
+
+void QtSerialUblox::registerUbxHandlers()
+{
+    // minimum payload lengths as given in the u-blox M8 protocol specification
+    auto add = [this](uint16_t msgID, const char* name, std::size_t minLength, std::function<void(std::string_view)> decode) {
+        UbxHandler handler {};
+        handler.name = name;
+        handler.minLength = minLength;
+        handler.decode = std::move(decode);
+        m_ubxHandlers.emplace(msgID, std::move(handler));
+    };
+    add(UBX_NAK, "ACK-NAK", 2, [this](std::string_view msg) { UBXAckNak(UBX_NAK, msg); });
+    add(UBX_ACK, "ACK-ACK", 2, [this](std::string_view msg) { UBXAckNak(UBX_ACK, msg); });
+    add(UBX_NAV_STATUS, "NAV-STATUS", 16, [this](std::string_view msg) { UBXNavStatus(msg); });
+    add(UBX_NAV_DOP, "NAV-DOP", 18, [this](std::string_view msg) { UBXNavDOP(msg); });
+    add(UBX_NAV_TIMEGPS, "NAV-TIMEGPS", 16, [this](std::string_view msg) { UBXNavTimeGPS(msg); });
+    add(UBX_NAV_TIMEUTC, "NAV-TIMEUTC", 20, [this](std::string_view msg) { UBXNavTimeUTC(msg); });
+    add(UBX_NAV_CLOCK, "NAV-CLOCK", 20, [this](std::string_view msg) { UBXNavClock(msg); });
+    add(UBX_NAV_SVINFO, "NAV-SVINFO", 8, [this](std::string_view msg) {
+        std::vector<GnssSatellite> sats = UBXNavSVinfo(msg, true);
         if (verbose > 2) {
-            tempStream << "received unhandled UBX-LOG message\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
+            emit toConsole("nr sats = " + QString::number(sats.size()) + "\n");
         }
-        break;
-    case 0x13: // UBX-MGA
+        emit gpsPropertyUpdatedGnss(sats, m_satList.updateAge());
+        m_satList = sats;
+    });
+    add(UBX_NAV_SAT, "NAV-SAT", 8, [this](std::string_view msg) {
+        std::vector<GnssSatellite> sats = UBXNavSat(msg, true);
+        emit gpsPropertyUpdatedGnss(sats, m_satList.updateAge());
+        m_satList = sats;
+    });
+    add(UBX_NAV_POSLLH, "NAV-POSLLH", 28, [this](std::string_view msg) {
+        geodeticPos = UBXNavPosLLH(msg);
+        emit gpsPropertyUpdatedGeodeticPos(geodeticPos());
+    });
+    add(UBX_CFG_MSG, "CFG-MSG", 2 + usedPort + 1, [this](std::string_view msg) {
+        // 2: port 0 (i2c); 3: port 1 (uart); 4: port 2 (usb); 5: port 3 (isp)
+        emit UBXreceivedMsgRateCfg(
+            (((uint16_t)(uint8_t)msg[0]) << 8) | ((uint16_t)(uint8_t)msg[1]),
+            (uint8_t)(msg[2 + usedPort]));
+    });
+    add(UBX_CFG_ANT, "CFG-ANT", 4, [this](std::string_view msg) { UBXCfgAnt(msg); });
+    add(UBX_CFG_NAV5, "CFG-NAV5", 36, [this](std::string_view msg) { UBXCfgNav5(msg); });
+    add(UBX_CFG_NAVX5, "CFG-NAVX5", 40, [this](std::string_view msg) { UBXCfgNavX5(msg); });
+    add(UBX_CFG_TP5, "CFG-TP5", 32, [this](std::string_view msg) { UBXCfgTP5(msg); });
+    add(UBX_CFG_GNSS, "CFG-GNSS", 4, [this](std::string_view msg) { UBXCfgGNSS(msg); });
+    add(UBX_MON_RXBUF, "MON-RXBUF", 24, [this](std::string_view msg) { UBXMonRx(msg); });
+    add(UBX_MON_TXBUF, "MON-TXBUF", 28, [this](std::string_view msg) { UBXMonTx(msg); });
+    add(UBX_MON_HW, "MON-HW", 60, [this](std::string_view msg) { UBXMonHW(msg); });
+    add(UBX_MON_HW2, "MON-HW2", 28, [this](std::string_view msg) { UBXMonHW2(msg); });
+    add(UBX_MON_VER, "MON-VER", 40, [this](std::string_view msg) { UBXMonVer(msg); });
+    add(UBX_TIM_TP, "TIM-TP", 16, [this](std::string_view msg) { UBXTimTP(msg); });
+    add(UBX_TIM_TM2, "TIM-TM2", MuonPi::Ublox::TimTm2::size, [this](std::string_view msg) { UBXTimTM2(msg); });
+}
+
+// all about processing different ubx-messages:
+void QtSerialUblox::processMessage(uint16_t msgID, std::string_view payload)
+{
+    const uint8_t classID = (msgID & 0xff00) >> 8;
+    const uint8_t messageID = msgID & 0xff;
+    if (!m_inFlight.empty() && classID != 0x05 && classID != 0x06) {
+        completePoll(msgID);
+    }
+    auto it = m_ubxHandlers.find(msgID);
+    if (it == m_ubxHandlers.end()) {
+        m_unhandledMessages++;
         if (verbose > 2) {
-            tempStream << "received unhandled UBX-MGA message\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
-        }
-        break;
-    case 0x0a: // UBX-MON
-        switch (messageID) {
-        case (UBX_MON_RXBUF & 0xff):
-            if (verbose > 2) {
-                tempStream << "received UBX-MON-RXBUF message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXMonRx(msg.data);
-            break;
-        case (UBX_MON_TXBUF & 0xff):
-            if (verbose > 2) {
-                tempStream << "received UBX-MON-TXBUF message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXMonTx(msg.data);
-            break;
-        case 0x09:
-            if (verbose > 2) {
-                tempStream << "received UBX-MON-HW message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXMonHW(msg.data);
-            break;
-        case 0x0b:
-            if (verbose > 2) {
-                tempStream << "received UBX-MON-HW2 message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXMonHW2(msg.data);
-            break;
-        case 0x04:
-            if (verbose > 2) {
-                tempStream << "received UBX-MON-VER message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXMonVer(msg.data);
-            break;
-        default:
-            if (verbose > 2) {
-                tempStream << "received unhandled UBX-MON message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
+            std::stringstream tempStream;
+            const char* className = ubxClassName(classID);
+            if (className != nullptr) {
+                tempStream << "received unhandled UBX-" << className << " message";
+            } else {
+                tempStream << "received unknown UBX message";
             }
-        }
-        break;
-    case 0x27: // UBX-SEC
-        if (verbose > 2) {
-            tempStream << "received unhandled UBX-SEC message\n";
+            tempStream << " (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
+                       << " 0x" << std::setw(2) << (int)messageID << ")\n";
             emit toConsole(QString::fromStdString(tempStream.str()));
         }
-        break;
-    case 0x0d: // UBX-TIM
-        switch (messageID) {
-        case 0x01: // UBX-TIM-TP
-            if (verbose > 2) {
-                tempStream << "received UBX-TIM-TP message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID << " 0x"
-                           << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXTimTP(msg.data);
-            break;
-        case 0x03: // UBX-TIM-TM2
-            if (verbose > 2) {
-                tempStream << "received UBX-TIM-TM2 message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID << " 0x"
-                           << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
-            UBXTimTM2(msg.data);
-            break;
-        default:
-            if (verbose > 2) {
-                tempStream << "received unhandled UBX-TIM message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                           << " 0x" << std::hex << (int)messageID << ")\n";
-                emit toConsole(QString::fromStdString(tempStream.str()));
-            }
+        return;
+    }
+    UbxHandler& handler = it->second;
+    if (payload.size() < handler.minLength) {
+        handler.shortPayloads++;
+        if (verbose > 1) {
+            emit toConsole(QString("received UBX-%1 message but data is corrupted (%2 of %3 bytes)\n")
+                               .arg(handler.name)
+                               .arg(payload.size())
+                               .arg(handler.minLength));
         }
-        break;
-    case 0x09: // UBX-UPD
-        if (verbose > 2) {
-            tempStream << "received unhandled UBX-UPD message\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
+        return;
+    }
+    if (verbose > 2) {
+        std::stringstream tempStream;
+        tempStream << "received UBX-" << handler.name << " message (0x" << std::hex << std::setfill('0') << std::setw(2)
+                   << (int)classID << " 0x" << std::setw(2) << (int)messageID << ")\n";
+        emit toConsole(QString::fromStdString(tempStream.str()));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    handler.decode(payload);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    handler.hits++;
+    handler.totalTime += elapsed;
+    handler.maxTime = std::max(handler.maxTime, elapsed);
+}
+
+void QtSerialUblox::reportMessageStatistics()
+{
+    std::stringstream tempStream;
+    tempStream << "*** UBX message statistics:\n";
+    tempStream << " message        hits  short  mean (us)   max (us)\n";
+    std::vector<std::pair<uint16_t, const UbxHandler*>> handlers;
+    for (const auto& [msgID, handler] : m_ubxHandlers) {
+        handlers.emplace_back(msgID, &handler);
+    }
+    std::sort(handlers.begin(), handlers.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [msgID, handler] : handlers) {
+        if (handler->hits == 0 && handler->shortPayloads == 0) {
+            continue;
         }
-        break;
-    default:
-        if (verbose > 2) {
-            tempStream << "received unknown UBX message (0x" << std::hex << std::setfill('0') << std::setw(2) << (int)classID
-                       << " 0x" << std::hex << (int)messageID << ")\n";
-            emit toConsole(QString::fromStdString(tempStream.str()));
+        const double mean { (handler->hits > 0) ? 1e-3 * handler->totalTime.count() / handler->hits : 0. };
+        tempStream << " " << std::left << std::setw(12) << handler->name << std::right
+                   << std::setw(8) << handler->hits
+                   << std::setw(7) << handler->shortPayloads
+                   << std::fixed << std::setprecision(1)
+                   << std::setw(11) << mean
+                   << std::setw(11) << 1e-3 * handler->maxTime.count() << "\n";
+    }
+    tempStream << " unhandled: " << m_unhandledMessages << "\n";
+    emit toConsole(QString::fromStdString(tempStream.str()));
+}
+
+void QtSerialUblox::UBXAckNak(uint16_t ackMsgID, std::string_view msg)
+{
+    std::stringstream tempStream;
+    const uint16_t ackedMsgID = MuonPi::Ublox::read<uint8_t>(msg, 0) << 8 | MuonPi::Ublox::read<uint8_t>(msg, 1);
+    if (verbose > 2) {
+        if (ackMsgID == UBX_ACK)
+            tempStream << "received UBX-ACK-ACK message about msgID: 0x";
+        else
+            tempStream << "received UBX-ACK-NACK message about msgID: 0x";
+        tempStream << std::setfill('0') << std::setw(4) << std::hex << ackedMsgID << "\n";
+        emit toConsole(QString::fromStdString(tempStream.str()));
+    }
+    // the oldest outstanding message with this msgID is the one being acknowledged
+    auto it = std::find_if(m_inFlight.begin(), m_inFlight.end(), [ackedMsgID](const PendingCommand& command) {
+        return command.msg.msgID == ackedMsgID;
+    });
+    if (it == m_inFlight.end()) {
+        if (verbose > 1) {
+            std::stringstream unexpectedStream;
+            unexpectedStream << "received unexpected UBX-ACK message about msgID: 0x";
+            unexpectedStream << std::setfill('0') << std::setw(4) << std::hex << ackedMsgID << "\n";
+            emit toConsole(QString::fromStdString(unexpectedStream.str()));
         }
-        break;
+        return;
+    }
+    if (ackMsgID == UBX_NAK) {
+        const std::string& data = it->msg.data;
+        emit UBXReceivedAckNak(it->msg.msgID,
+            (data.size() >= 2) ? ((uint16_t)(uint8_t)(data[0]) << 8 | (uint8_t)data[1]) : 0);
     }
+    m_inFlight.erase(it);
+    if (verbose > 2)
+        emit toConsole("processMessage: deleted message after ACK/NACK\n");
+    sendQueuedMsg();
 }
 
-bool QtSerialUblox::UBXTimTP(const std::string& msg)
+bool QtSerialUblox::UBXTimTP(std::string_view msg)
 {
     // parse all fields
     // TP time of week, ms
-    uint32_t towMS = (int)msg[0];
-    towMS += ((int)msg[1]) << 8;
-    towMS += ((int)msg[2]) << 16;
-    towMS += ((int)msg[3]) << 24;
+    uint32_t towMS = MuonPi::Ublox::read<uint32_t>(msg, 0);
     // TP time of week, sub ms
-    uint32_t towSubMS = (int)msg[4];
-    towSubMS += ((int)msg[5]) << 8;
-    towSubMS += ((int)msg[6]) << 16;
-    towSubMS += ((int)msg[7]) << 24;
+    uint32_t towSubMS = MuonPi::Ublox::read<uint32_t>(msg, 4);
     // quantization error
-    int32_t qErr = (int)msg[8];
-    qErr += ((int)msg[9]) << 8;
-    qErr += ((int)msg[10]) << 16;
-    qErr += ((int)msg[11]) << 24;
+    int32_t qErr = MuonPi::Ublox::read<int32_t>(msg, 8);
     emit gpsPropertyUpdatedInt32(qErr, TPQuantErr.updateAge(), 'e');
     TPQuantErr = qErr;
     // week number
-    uint16_t week = (int)msg[12];
-    week += ((int)msg[13]) << 8;
+    uint16_t week = MuonPi::Ublox::read<uint16_t>(msg, 12);
     // flags
     uint8_t flags = msg[14];
     // ref info
@@ -457,47 +313,19 @@ bool QtSerialUblox::UBXTimTP(const std::string& msg)
     return true;
 }
 
-bool QtSerialUblox::UBXTimTM2(const std::string& msg)
+bool QtSerialUblox::UBXTimTM2(std::string_view msg)
 {
-    // parse all fields
-    // channel
-    uint8_t ch = msg[0];
-    // flags
-    uint8_t flags = msg[1];
-    // rising edge counter
-    uint16_t count = (int)msg[2]; // 16 bit counter
-    count += ((int)msg[3]) << 8;
-    // week number of last rising edge
-    uint16_t wnR = (int)msg[4];
-    wnR += ((int)msg[5]) << 8;
-    // week number of last falling edge
-    uint16_t wnF = (int)msg[6];
-    wnF += ((int)msg[7]) << 8;
-    // time of week of rising edge, ms
-    uint32_t towMsR = (int)msg[8];
-    towMsR += ((int)msg[9]) << 8;
-    towMsR += ((int)msg[10]) << 16;
-    towMsR += ((int)msg[11]) << 24;
-    // time of week of rising edge, sub ms
-    uint32_t towSubMsR = (int)msg[12];
-    towSubMsR += ((int)msg[13]) << 8;
-    towSubMsR += ((int)msg[14]) << 16;
-    towSubMsR += ((int)msg[15]) << 24;
-    // time of week of falling edge, ms
-    uint32_t towMsF = (int)msg[16];
-    towMsF += ((int)msg[17]) << 8;
-    towMsF += ((int)msg[18]) << 16;
-    towMsF += ((int)msg[19]) << 24;
-    // time of week of falling edge, sub ms
-    uint32_t towSubMsF = (int)msg[20];
-    towSubMsF += ((int)msg[21]) << 8;
-    towSubMsF += ((int)msg[22]) << 16;
-    towSubMsF += ((int)msg[23]) << 24;
-    // accuracy estimate
-    uint32_t accEst = (int)msg[24];
-    accEst += ((int)msg[25]) << 8;
-    accEst += ((int)msg[26]) << 16;
-    accEst += ((int)msg[27]) << 24;
+    const MuonPi::Ublox::TimTm2 tm2 { MuonPi::Ublox::TimTm2::decode(msg) };
+    const uint8_t ch = tm2.ch;
+    const uint8_t flags = tm2.flags;
+    const uint16_t count = tm2.count;
+    const uint16_t wnR = tm2.wnR;
+    const uint16_t wnF = tm2.wnF;
+    const uint32_t towMsR = tm2.towMsR;
+    const uint32_t towSubMsR = tm2.towSubMsR;
+    const uint32_t towMsF = tm2.towMsF;
+    const uint32_t towSubMsF = tm2.towSubMsF;
+    const uint32_t accEst = tm2.accEst;
 
     double sr = towMsR / 1000.;
     sr = sr - towMsR / 1000;
@@ -510,8 +338,8 @@ bool QtSerialUblox::UBXTimTM2(const std::string& msg)
     // second in current week (falling), ns of timestamp in current second (falling),
     // accuracy (ns), rising edge counter, rising/falling edge (1/0), time valid (GNSS fix)
 
-    std::stringstream tempStream;
     if (verbose > 2) {
+        std::stringstream tempStream;
         tempStream << "*** UBX-TimTM2 message:" << endl;
         tempStream << " channel         : " << dec << (int)ch << endl;
         tempStream << " rising edge ctr : " << dec << count << endl;
@@ -555,26 +383,34 @@ bool QtSerialUblox::UBXTimTM2(const std::string& msg)
         emit toConsole(QString::fromStdString(tempStream.str()));
     }
 
-    tempStream.clear();
-    if (flags & 0x80) {
-        // if new rising edge
-        tempStream << unixtime_from_gps(wnR, towMsR / 1000, (long int)(sr * 1e9 + towSubMsR));
-    } else {
-        tempStream << ".................... ";
-    }
-    if (flags & 0x04) {
-        // if new falling edge
-        tempStream << unixtime_from_gps(wnF, towMsF / 1000, (long int)(sr * 1e9 + towSubMsF));
-    } else {
-        tempStream << ".................... ";
-    }
-    tempStream << accEst
-               << " " << count
-               << " " << ((flags & 0x40) >> 6)
-               << " " << setfill('0') << setw(1) << ((flags & 0x18) >> 3)
-               << " " << ((flags & 0x20) >> 5);
-    if (verbose > 1) {
-        emit toConsole(QString::fromStdString(tempStream.str()) + "\n");
+    // the one-line summary is only needed for the console or a connected consumer
+    const bool summaryConnected { isSignalConnected(QMetaMethod::fromSignal(&QtSerialUblox::timTM2)) };
+    if (verbose > 1 || summaryConnected) {
+        std::stringstream summaryStream;
+        if (flags & 0x80) {
+            // if new rising edge
+            summaryStream << unixtime_from_gps(wnR, towMsR / 1000, (long int)(sr * 1e9 + towSubMsR));
+        } else {
+            summaryStream << ".................... ";
+        }
+        if (flags & 0x04) {
+            // if new falling edge
+            summaryStream << unixtime_from_gps(wnF, towMsF / 1000, (long int)(sr * 1e9 + towSubMsF));
+        } else {
+            summaryStream << ".................... ";
+        }
+        summaryStream << accEst
+                      << " " << count
+                      << " " << ((flags & 0x40) >> 6)
+                      << " " << setfill('0') << setw(1) << ((flags & 0x18) >> 3)
+                      << " " << ((flags & 0x20) >> 5);
+        const QString summary { QString::fromStdString(summaryStream.str()) };
+        if (verbose > 1) {
+            emit toConsole(summary + "\n");
+        }
+        if (summaryConnected) {
+            emit timTM2(summary);
+        }
     }
 
     struct timespec ts_r = unixtime_from_gps(wnR, towMsR / 1000, (long int)(sr * 1e9 + towSubMsR));
@@ -648,16 +484,13 @@ bool QtSerialUblox::UBXTimTM2(const std::string& msg)
     return true;
 }
 
-std::vector<GnssSatellite> QtSerialUblox::UBXNavSat(const std::string& msg, bool allSats)
+std::vector<GnssSatellite> QtSerialUblox::UBXNavSat(std::string_view msg, bool allSats)
 {
     std::vector<GnssSatellite> satList;
     // UBX-NAV-SAT: satellite information
     // parse all fields
     // GPS time of week
-    uint32_t iTOW = (int)msg[0];
-    iTOW += ((int)msg[1]) << 8;
-    iTOW += ((int)msg[2]) << 16;
-    iTOW += ((int)msg[3]) << 24;
+    uint32_t iTOW = MuonPi::Ublox::read<uint32_t>(msg, 0);
     // version
     uint8_t version = msg[4];
     uint8_t numSvs = msg[5];
@@ -683,16 +516,11 @@ std::vector<GnssSatellite> QtSerialUblox::UBXNavSat(const std::string& msg, bool
         uint8_t satId = msg[n + 1];
         uint8_t cnr = msg[n + 2];
         int8_t elev = msg[n + 3];
-        int16_t azim = msg[n + 4];
-        azim += msg[n + 5] << 8;
-        int16_t _prRes = msg[n + 6];
-        _prRes += msg[n + 7] << 8;
+        int16_t azim = MuonPi::Ublox::read<int16_t>(msg, n + 4);
+        int16_t _prRes = MuonPi::Ublox::read<int16_t>(msg, n + 6);
         float prRes = _prRes / 10.;
 
-        flags = (int)msg[n + 8];
-        flags += ((int)msg[n + 9]) << 8;
-        flags += ((int)msg[n + 10]) << 16;
-        flags += ((int)msg[n + 11]) << 24;
+        flags = MuonPi::Ublox::read<uint32_t>(msg, n + 8);
         if (gnssId > 7)
             gnssId = 7;
         GnssSatellite sat(gnssId, satId, cnr, elev, azim, prRes, flags);
@@ -724,16 +552,13 @@ std::vector<GnssSatellite> QtSerialUblox::UBXNavSat(const std::string& msg, bool
     return satList;
 }
 
-std::vector<GnssSatellite> QtSerialUblox::UBXNavSVinfo(const std::string& msg, bool allSats)
+std::vector<GnssSatellite> QtSerialUblox::UBXNavSVinfo(std::string_view msg, bool allSats)
 {
     std::vector<GnssSatellite> satList;
     // UBX-NAV-SVINFO: satellite information
     // parse all fields
     // GPS time of week
-    uint32_t iTOW = (int)msg[0];
-    iTOW += ((int)msg[1]) << 8;
-    iTOW += ((int)msg[2]) << 16;
-    iTOW += ((int)msg[3]) << 24;
+    uint32_t iTOW = MuonPi::Ublox::read<uint32_t>(msg, 0);
     // version
     uint8_t numSvs = msg[4];
     uint8_t globFlags = msg[5];
@@ -759,12 +584,8 @@ std::vector<GnssSatellite> QtSerialUblox::UBXNavSVinfo(const std::string& msg, b
         uint8_t quality = msg[n + 3];
         uint8_t cnr = msg[n + 4];
         int8_t elev = msg[n + 5];
-        int16_t azim = msg[n + 6];
-        azim += msg[n + 7] << 8;
-        int32_t prRes = msg[n + 8];
-        prRes += msg[n + 9] << 8;
-        prRes += msg[n + 10] << 16;
-        prRes += msg[n + 11] << 24;
+        int16_t azim = MuonPi::Ublox::read<int16_t>(msg, n + 6);
+        int32_t prRes = MuonPi::Ublox::read<int32_t>(msg, n + 8);
 
         bool used = false;
         if (flags & 0x01)
@@ -829,7 +650,7 @@ std::vector<GnssSatellite> QtSerialUblox::UBXNavSVinfo(const std::string& msg, b
     return satList;
 }
 
-void QtSerialUblox::UBXCfgGNSS(const string& msg)
+void QtSerialUblox::UBXCfgGNSS(std::string_view msg)
 {
     // UBX-CFG-GNSS: GNSS configuration
     // parse all fields
@@ -861,10 +682,7 @@ void QtSerialUblox::UBXCfgGNSS(const string& msg)
         config.gnssId = msg[4 + 8 * i];
         config.resTrkCh = msg[5 + 8 * i];
         config.maxTrkCh = msg[6 + 8 * i];
-        config.flags = msg[8 + 8 * i];
-        config.flags |= (int)msg[9 + 8 * i] << 8;
-        config.flags |= (int)msg[10 + 8 * i] << 16;
-        config.flags |= (int)msg[11 + 8 * i] << 24;
+        config.flags = MuonPi::Ublox::read<uint32_t>(msg, 8 + 8 * i);
         if (verbose > 2) {
             std::stringstream tempStream;
             tempStream << "   " << i << ":   GNSS name : "
@@ -911,22 +729,15 @@ void QtSerialUblox::onSetGnssConfig(const std::vector<GnssConfigStruct>& gnssCon
     free(data);
 }
 
-void QtSerialUblox::UBXCfgNav5(const string& msg)
+void QtSerialUblox::UBXCfgNav5(std::string_view msg)
 {
     // UBX CFG-NAV5: satellite information
     // parse all fields
-    uint16_t mask = msg[0];
-    mask |= (int)msg[1] << 8;
+    uint16_t mask = MuonPi::Ublox::read<uint16_t>(msg, 0);
     uint8_t dynModel = msg[2];
     uint8_t fixMode = msg[3];
-    int32_t fixedAlt = msg[4];
-    fixedAlt |= (int)msg[5] << 8;
-    fixedAlt |= (int)msg[6] << 16;
-    fixedAlt |= (int)msg[7] << 24;
-    uint32_t fixedAltVar = msg[8];
-    fixedAltVar |= (int)msg[9] << 8;
-    fixedAltVar |= (int)msg[10] << 16;
-    fixedAltVar |= (int)msg[11] << 24;
+    int32_t fixedAlt = MuonPi::Ublox::read<int32_t>(msg, 4);
+    uint32_t fixedAltVar = MuonPi::Ublox::read<uint32_t>(msg, 8);
     int8_t minElev = msg[12];
     uint8_t cnoThreshNumSVs = msg[24];
     uint8_t cnoThresh = msg[25];
@@ -956,26 +767,17 @@ void QtSerialUblox::setDynamicModel(uint8_t model)
     enqueueMsg(UBX_CFG_NAV5, str);
 }
 
-void QtSerialUblox::UBXNavStatus(const string& msg)
+void QtSerialUblox::UBXNavStatus(std::string_view msg)
 {
     // UBX-NAV_STATUS: RX status information
     // parse all fields
-    uint32_t iTOW = (int)msg[0];
-    iTOW += ((int)msg[1]) << 8;
-    iTOW += ((int)msg[2]) << 16;
-    iTOW += ((int)msg[3]) << 24;
+    uint32_t iTOW = MuonPi::Ublox::read<uint32_t>(msg, 0);
 
     uint8_t gpsFix = msg[4];
     uint8_t flags = msg[5];
     uint8_t flags2 = msg[7];
-    uint32_t ttff = msg[8];
-    ttff |= (int)msg[9] << 8;
-    ttff |= (int)msg[10] << 16;
-    ttff |= (int)msg[11] << 24;
-    uint32_t msss = msg[12];
-    msss |= (int)msg[13] << 8;
-    msss |= (int)msg[14] << 16;
-    msss |= (int)msg[15] << 24;
+    uint32_t ttff = MuonPi::Ublox::read<uint32_t>(msg, 8);
+    uint32_t msss = MuonPi::Ublox::read<uint32_t>(msg, 12);
 
     emit gpsPropertyUpdatedUint8(gpsFix, fix.updateAge(), 'f');
     fix = gpsFix;
@@ -995,62 +797,38 @@ void QtSerialUblox::UBXNavStatus(const string& msg)
     }
 }
 
-GeodeticPos QtSerialUblox::UBXNavPosLLH(const string& msg)
+GeodeticPos QtSerialUblox::UBXNavPosLLH(std::string_view msg)
 {
     GeodeticPos pos;
     // GPS time of week
-    uint32_t iTOW = (unsigned int)msg[0];
-    iTOW += ((unsigned int)msg[1]) << 8;
-    iTOW += ((unsigned int)msg[2]) << 16;
-    iTOW += ((unsigned int)msg[3]) << 24;
+    uint32_t iTOW = MuonPi::Ublox::read<uint32_t>(msg, 0);
     pos.iTOW = iTOW;
     // longitude in 1e-7 precision
-    int32_t lon = (int)msg[4];
-    lon += ((int)msg[5]) << 8;
-    lon += ((int)msg[6]) << 16;
-    lon += ((int)msg[7]) << 24;
+    int32_t lon = MuonPi::Ublox::read<int32_t>(msg, 4);
     pos.lon = lon;
     // latitude in 1e-7 precision
-    int32_t lat = (int)msg[8];
-    lat += ((int)msg[9]) << 8;
-    lat += ((int)msg[10]) << 16;
-    lat += ((int)msg[11]) << 24;
+    int32_t lat = MuonPi::Ublox::read<int32_t>(msg, 8);
     pos.lat = lat;
     // height above ellipsoid
-    int32_t height = (int)msg[12];
-    height += ((int)msg[13]) << 8;
-    height += ((int)msg[14]) << 16;
-    height += ((int)msg[15]) << 24;
+    int32_t height = MuonPi::Ublox::read<int32_t>(msg, 12);
     pos.height = height;
     // height above main sea-level
-    int32_t hMSL = (int)msg[16];
-    hMSL += ((int)msg[17]) << 8;
-    hMSL += ((int)msg[18]) << 16;
-    hMSL += ((int)msg[19]) << 24;
+    int32_t hMSL = MuonPi::Ublox::read<int32_t>(msg, 16);
     pos.hMSL = hMSL;
     // horizontal accuracy estimate
-    uint32_t hAcc = (unsigned int)msg[20];
-    hAcc += ((unsigned int)msg[21]) << 8;
-    hAcc += ((unsigned int)msg[22]) << 16;
-    hAcc += ((unsigned int)msg[23]) << 24;
+    uint32_t hAcc = MuonPi::Ublox::read<uint32_t>(msg, 20);
     pos.hAcc = hAcc;
     // vertical accuracy estimate
-    uint32_t vAcc = (unsigned int)msg[24];
-    vAcc += ((unsigned int)msg[25]) << 8;
-    vAcc += ((unsigned int)msg[26]) << 16;
-    vAcc += ((unsigned int)msg[27]) << 24;
+    uint32_t vAcc = MuonPi::Ublox::read<uint32_t>(msg, 24);
     pos.vAcc = vAcc;
     return pos;
 }
 
-void QtSerialUblox::UBXNavClock(const std::string& msg)
+void QtSerialUblox::UBXNavClock(std::string_view msg)
 {
     // parse all fields
     // GPS time of week
-    uint32_t iTOW = (int)msg[0];
-    iTOW += ((int)msg[1]) << 8;
-    iTOW += ((int)msg[2]) << 16;
-    iTOW += ((int)msg[3]) << 24;
+    uint32_t iTOW = MuonPi::Ublox::read<uint32_t>(msg, 0);
     // clock bias
     if (verbose > 3) {
         std::stringstream tempStream;
@@ -1060,30 +838,18 @@ void QtSerialUblox::UBXNavClock(const std::string& msg)
         tempStream << "clkB[3]=" << std::setfill('0') << std::setw(2) << std::hex << (int)msg[7];
         emit toConsole(QString::fromStdString(tempStream.str()));
     }
-    int32_t clkB = (int)msg[4];
-    clkB += ((int)msg[5]) << 8;
-    clkB += ((int)msg[6]) << 16;
-    clkB += ((int)msg[7]) << 24;
+    int32_t clkB = MuonPi::Ublox::read<int32_t>(msg, 4);
     // clock drift
-    int32_t clkD = (int)msg[8];
-    clkD += ((int)msg[9]) << 8;
-    clkD += ((int)msg[10]) << 16;
-    clkD += ((int)msg[11]) << 24;
+    int32_t clkD = MuonPi::Ublox::read<int32_t>(msg, 8);
     //mutex.lock();
     emit gpsPropertyUpdatedInt32(clkD, clkDrift.updateAge(), 'd');
     emit gpsPropertyUpdatedInt32(clkB, clkBias.updateAge(), 'b');
     clkDrift = clkD;
     clkBias = clkB;
     // time accuracy estimate
-    uint32_t tAcc = (int)msg[12];
-    tAcc += ((int)msg[13]) << 8;
-    tAcc += ((int)msg[14]) << 16;
-    tAcc += ((int)msg[15]) << 24;
+    uint32_t tAcc = MuonPi::Ublox::read<uint32_t>(msg, 12);
     // freq accuracy estimate
-    uint32_t fAcc = (int)msg[16];
-    fAcc += ((int)msg[17]) << 8;
-    fAcc += ((int)msg[18]) << 16;
-    fAcc += ((int)msg[19]) << 24;
+    uint32_t fAcc = MuonPi::Ublox::read<uint32_t>(msg, 16);
 
     emit gpsPropertyUpdatedUint32(tAcc, timeAccuracy.updateAge(), 'a');
     timeAccuracy = tAcc;
@@ -1108,31 +874,21 @@ void QtSerialUblox::UBXNavClock(const std::string& msg)
     }
 }
 
-void QtSerialUblox::UBXNavTimeGPS(const std::string& msg)
+void QtSerialUblox::UBXNavTimeGPS(std::string_view msg)
 {
     // parse all fields
     // GPS time of week
-    uint32_t iTOW = (int)msg[0];
-    iTOW += ((int)msg[1]) << 8;
-    iTOW += ((int)msg[2]) << 16;
-    iTOW += ((int)msg[3]) << 24;
+    uint32_t iTOW = MuonPi::Ublox::read<uint32_t>(msg, 0);
 
-    int32_t fTOW = (int)msg[4];
-    fTOW += ((int)msg[5]) << 8;
-    fTOW += ((int)msg[6]) << 16;
-    fTOW += ((int)msg[7]) << 24;
+    int32_t fTOW = MuonPi::Ublox::read<int32_t>(msg, 4);
 
-    uint16_t wnR = (int)msg[8];
-    wnR += ((int)msg[9]) << 8;
+    uint16_t wnR = MuonPi::Ublox::read<uint16_t>(msg, 8);
 
     int8_t leapS = (int)msg[10];
     uint8_t flags = (int)msg[11];
 
     // time accuracy estimate
-    uint32_t tAcc = (int)msg[12];
-    tAcc += ((int)msg[13]) << 8;
-    tAcc += ((int)msg[14]) << 16;
-    tAcc += ((int)msg[15]) << 24;
+    uint32_t tAcc = MuonPi::Ublox::read<uint32_t>(msg, 12);
 
     double sr = iTOW / 1000.;
     sr = sr - iTOW / 1000;
@@ -1177,31 +933,21 @@ void QtSerialUblox::UBXNavTimeGPS(const std::string& msg)
     }
 }
 
-void QtSerialUblox::UBXNavTimeUTC(const std::string& msg)
+void QtSerialUblox::UBXNavTimeUTC(std::string_view msg)
 {
     // parse all fields
     // GPS time of week
-    uint32_t iTOW = (int)msg[0];
-    iTOW += ((int)msg[1]) << 8;
-    iTOW += ((int)msg[2]) << 16;
-    iTOW += ((int)msg[3]) << 24;
+    uint32_t iTOW = MuonPi::Ublox::read<uint32_t>(msg, 0);
 
     // time accuracy estimate
-    uint32_t tAcc = (int)msg[4];
-    tAcc += ((int)msg[5]) << 8;
-    tAcc += ((int)msg[6]) << 16;
-    tAcc += ((int)msg[7]) << 24;
+    uint32_t tAcc = MuonPi::Ublox::read<uint32_t>(msg, 4);
     emit gpsPropertyUpdatedUint32(tAcc, timeAccuracy.updateAge(), 'a');
     timeAccuracy = tAcc;
     timeAccuracy.lastUpdate = std::chrono::system_clock::now();
 
-    int32_t nano = (int)msg[8];
-    nano += ((int)msg[9]) << 8;
-    nano += ((int)msg[10]) << 16;
-    nano += ((int)msg[11]) << 24;
+    int32_t nano = MuonPi::Ublox::read<int32_t>(msg, 8);
 
-    uint16_t year = (int)msg[12];
-    year += ((int)msg[13]) << 8;
+    uint16_t year = MuonPi::Ublox::read<uint16_t>(msg, 12);
 
     uint16_t month = (int)msg[14];
     uint16_t day = (int)msg[15];
@@ -1271,17 +1017,15 @@ void QtSerialUblox::UBXNavTimeUTC(const std::string& msg)
     }
 }
 
-void QtSerialUblox::UBXMonHW(const std::string& msg)
+void QtSerialUblox::UBXMonHW(std::string_view msg)
 {
     // parse all fields
     // noise
-    uint16_t noisePerMS = (int)msg[16];
-    noisePerMS += ((int)msg[17]) << 8;
+    uint16_t noisePerMS = MuonPi::Ublox::read<uint16_t>(msg, 16);
     noise = noisePerMS;
 
     // agc
-    uint16_t agcCnt = (int)msg[18];
-    agcCnt += ((int)msg[19]) << 8;
+    uint16_t agcCnt = MuonPi::Ublox::read<uint16_t>(msg, 18);
     agc = agcCnt;
 
     uint8_t antStatus = msg[20];
@@ -1322,7 +1066,7 @@ void QtSerialUblox::UBXMonHW(const std::string& msg)
     emit gpsMonHW(hw);
 }
 
-void QtSerialUblox::UBXMonHW2(const std::string& msg)
+void QtSerialUblox::UBXMonHW2(std::string_view msg)
 {
     // parse all fields
     // I/Q offset and magnitude information of front-end
@@ -1332,15 +1076,9 @@ void QtSerialUblox::UBXMonHW2(const std::string& msg)
     uint8_t magQ = msg[3];
 
     uint8_t cfgSrc = msg[4];
-    uint32_t lowLevCfg = msg[8];
-    lowLevCfg |= msg[9] << 8;
-    lowLevCfg |= msg[10] << 16;
-    lowLevCfg |= msg[11] << 24;
+    uint32_t lowLevCfg = MuonPi::Ublox::read<uint32_t>(msg, 8);
 
-    uint32_t postStatus = msg[20];
-    postStatus |= msg[21] << 8;
-    postStatus |= msg[22] << 16;
-    postStatus |= msg[23] << 24;
+    uint32_t postStatus = MuonPi::Ublox::read<uint32_t>(msg, 20);
 
     if (verbose > 3) {
         std::stringstream tempStream;
@@ -1357,7 +1095,7 @@ void QtSerialUblox::UBXMonHW2(const std::string& msg)
     emit gpsMonHW2(hw2);
 }
 
-void QtSerialUblox::UBXMonVer(const std::string& msg)
+void QtSerialUblox::UBXMonVer(std::string_view msg)
 {
     // parse all fields
     std::string hwString = "";
@@ -1381,7 +1119,7 @@ void QtSerialUblox::UBXMonVer(const std::string& msg)
     std::vector<std::string> result;
     std::string::size_type i = 0;
     while (i != std::string::npos && i < msg.size()) {
-        std::string s = msg.substr(i, msg.find((char)0x00, i + 1) - i + 1);
+        std::string s { msg.substr(i, msg.find((char)0x00, i + 1) - i + 1) };
         while (s.size() && s[0] == 0x00) {
             s.erase(0, 1);
         }
@@ -1410,7 +1148,7 @@ void QtSerialUblox::UBXMonVer(const std::string& msg)
     emit gpsVersion(QString::fromStdString(swString), QString::fromStdString(hwString), QString::fromStdString(fProtVersionString));
 }
 
-void QtSerialUblox::UBXMonTx(const std::string& msg)
+void QtSerialUblox::UBXMonTx(std::string_view msg)
 {
     // parse all fields
     // nr bytes pending
@@ -1421,8 +1159,7 @@ void QtSerialUblox::UBXMonTx(const std::string& msg)
     uint8_t tPeakUsage;
 
     for (int i = 0; i < 6; i++) {
-        pending[i] = msg[2 * i];
-        pending[i] |= (uint16_t)msg[2 * i + 1] << 8;
+        pending[i] = MuonPi::Ublox::read<uint16_t>(msg, 2 * i);
         usage[i] = msg[i + 12];
         peakUsage[i] = msg[i + 18];
     }
@@ -1463,7 +1200,7 @@ void QtSerialUblox::UBXMonTx(const std::string& msg)
     }
 }
 
-void QtSerialUblox::UBXMonRx(const std::string& msg)
+void QtSerialUblox::UBXMonRx(std::string_view msg)
 {
     // parse all fields
     // nr bytes pending
@@ -1474,8 +1211,7 @@ void QtSerialUblox::UBXMonRx(const std::string& msg)
     uint8_t tPeakUsage = 0;
 
     for (int i = 0; i < 6; i++) {
-        pending[i] = msg[2 * i];
-        pending[i] |= (uint16_t)msg[2 * i + 1] << 8;
+        pending[i] = MuonPi::Ublox::read<uint16_t>(msg, 2 * i);
         usage[i] = msg[i + 12];
         peakUsage[i] = msg[i + 18];
         tUsage += usage[i];
@@ -1509,21 +1245,18 @@ void QtSerialUblox::UBXMonRx(const std::string& msg)
     }
 }
 
-void QtSerialUblox::UBXCfgNavX5(const std::string& msg)
+void QtSerialUblox::UBXCfgNavX5(std::string_view msg)
 {
     // parse all fields
     uint8_t version = msg[0];
-    uint16_t mask1 = msg[1];
-    mask1 |= msg[2] << 8;
+    uint16_t mask1 = MuonPi::Ublox::read<uint16_t>(msg, 1);
     uint8_t minSVs = msg[10];
     uint8_t maxSVs = msg[11];
     uint8_t minCNO = msg[12];
     uint8_t iniFix3D = msg[14];
-    uint16_t wknRollover = msg[18];
-    wknRollover |= msg[19] << 8;
+    uint16_t wknRollover = MuonPi::Ublox::read<uint16_t>(msg, 18);
     uint8_t aopCfg = msg[27];
-    uint16_t aopOrbMaxErr = msg[30];
-    aopOrbMaxErr |= msg[31] << 8;
+    uint16_t aopOrbMaxErr = MuonPi::Ublox::read<uint16_t>(msg, 30);
     if (verbose > 2) {
         std::stringstream tempStream;
         tempStream << "*** UBX-MON-NAVX5 message:" << endl;
@@ -1539,13 +1272,11 @@ void QtSerialUblox::UBXCfgNavX5(const std::string& msg)
     }
 }
 
-void QtSerialUblox::UBXCfgAnt(const std::string& msg)
+void QtSerialUblox::UBXCfgAnt(std::string_view msg)
 {
     // parse all fields
-    uint16_t flags = msg[0];
-    flags |= msg[1] << 8;
-    uint16_t pins = msg[2];
-    pins |= msg[3] << 8;
+    uint16_t flags = MuonPi::Ublox::read<uint16_t>(msg, 0);
+    uint16_t pins = MuonPi::Ublox::read<uint16_t>(msg, 2);
     if (verbose > 2) {
         std::stringstream tempStream;
         tempStream << "*** UBX-CFG-ANT message:" << endl;
@@ -1563,40 +1294,20 @@ void QtSerialUblox::UBXCfgAnt(const std::string& msg)
     }
 }
 
-void QtSerialUblox::UBXCfgTP5(const std::string& msg)
+void QtSerialUblox::UBXCfgTP5(std::string_view msg)
 {
     UbxTimePulseStruct tp;
     // parse all fields
     tp.tpIndex = msg[0];
     tp.version = msg[1];
-    tp.antCableDelay = msg[4];
-    tp.antCableDelay |= msg[5] << 8;
-    tp.rfGroupDelay = msg[6];
-    tp.rfGroupDelay |= msg[7] << 8;
-    tp.freqPeriod = msg[8];
-    tp.freqPeriod |= msg[9] << 8;
-    tp.freqPeriod |= msg[10] << 16;
-    tp.freqPeriod |= msg[11] << 24;
-    tp.freqPeriodLock = msg[12];
-    tp.freqPeriodLock |= msg[13] << 8;
-    tp.freqPeriodLock |= msg[14] << 16;
-    tp.freqPeriodLock |= msg[15] << 24;
-    tp.pulseLenRatio = msg[16];
-    tp.pulseLenRatio |= msg[17] << 8;
-    tp.pulseLenRatio |= msg[18] << 16;
-    tp.pulseLenRatio |= msg[19] << 24;
-    tp.pulseLenRatioLock = msg[20];
-    tp.pulseLenRatioLock |= msg[21] << 8;
-    tp.pulseLenRatioLock |= msg[22] << 16;
-    tp.pulseLenRatioLock |= msg[23] << 24;
-    tp.userConfigDelay = msg[24];
-    tp.userConfigDelay |= msg[25] << 8;
-    tp.userConfigDelay |= msg[26] << 16;
-    tp.userConfigDelay |= msg[27] << 24;
-    tp.flags = msg[28];
-    tp.flags |= msg[29] << 8;
-    tp.flags |= msg[30] << 16;
-    tp.flags |= msg[31] << 24;
+    tp.antCableDelay = MuonPi::Ublox::read<int16_t>(msg, 4);
+    tp.rfGroupDelay = MuonPi::Ublox::read<int16_t>(msg, 6);
+    tp.freqPeriod = MuonPi::Ublox::read<uint32_t>(msg, 8);
+    tp.freqPeriodLock = MuonPi::Ublox::read<uint32_t>(msg, 12);
+    tp.pulseLenRatio = MuonPi::Ublox::read<uint32_t>(msg, 16);
+    tp.pulseLenRatioLock = MuonPi::Ublox::read<uint32_t>(msg, 20);
+    tp.userConfigDelay = MuonPi::Ublox::read<int32_t>(msg, 24);
+    tp.flags = MuonPi::Ublox::read<uint32_t>(msg, 28);
     bool isFreq = tp.flags & 0x08;
     bool isLength = tp.flags & 0x10;
 
@@ -1700,38 +1411,28 @@ void QtSerialUblox::UBXSetCfgTP5(const UbxTimePulseStruct& tp)
     enqueueMsg(UBX_CFG_TP5, toStdString(msg, 32));
 }
 
-void QtSerialUblox::UBXNavDOP(const string& msg)
+void QtSerialUblox::UBXNavDOP(std::string_view msg)
 {
     // UBX-NAV-DOP: dilution of precision values
     UbxDopStruct d;
 
     // parse all fields
-    uint32_t iTOW = (int)msg[0];
-    iTOW += ((int)msg[1]) << 8;
-    iTOW += ((int)msg[2]) << 16;
-    iTOW += ((int)msg[3]) << 24;
+    uint32_t iTOW = MuonPi::Ublox::read<uint32_t>(msg, 0);
 
     // geometric DOP
-    d.gDOP = msg[4];
-    d.gDOP |= msg[5] << 8;
+    d.gDOP = MuonPi::Ublox::read<uint16_t>(msg, 4);
     // position DOP
-    d.pDOP = msg[6];
-    d.pDOP |= msg[7] << 8;
+    d.pDOP = MuonPi::Ublox::read<uint16_t>(msg, 6);
     // time DOP
-    d.tDOP = msg[8];
-    d.tDOP |= msg[9] << 8;
+    d.tDOP = MuonPi::Ublox::read<uint16_t>(msg, 8);
     // vertical DOP
-    d.vDOP = msg[10];
-    d.vDOP |= msg[11] << 8;
+    d.vDOP = MuonPi::Ublox::read<uint16_t>(msg, 10);
     // horizontal DOP
-    d.hDOP = msg[12];
-    d.hDOP |= msg[13] << 8;
+    d.hDOP = MuonPi::Ublox::read<uint16_t>(msg, 12);
     // northing DOP
-    d.nDOP = msg[14];
-    d.nDOP |= msg[15] << 8;
+    d.nDOP = MuonPi::Ublox::read<uint16_t>(msg, 14);
     // easting DOP
-    d.eDOP = msg[16];
-    d.eDOP |= msg[17] << 8;
+    d.eDOP = MuonPi::Ublox::read<uint16_t>(msg, 16);
 
     emit UBXReceivedDops(d);
 
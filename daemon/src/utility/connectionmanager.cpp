@@ -0,0 +1,186 @@
+#include "utility/connectionmanager.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QVector>
+
+ConnectionManager::ConnectionManager(int verbose, QObject* parent)
+    : QObject(parent)
+    , m_verbose { verbose }
+{
+}
+
+void ConnectionManager::addConnection(qintptr socketDescriptor)
+{
+    auto* connection { new TcpConnection(static_cast<int>(socketDescriptor), m_verbose, 15000, 5000, this) };
+    connect(connection, &TcpConnection::receivedTcpMessage, this, &ConnectionManager::onReceivedTcpMessage);
+    connect(connection, &TcpConnection::toConsole, this, &ConnectionManager::toConsole);
+    connect(connection, &TcpConnection::madeConnection, this, &ConnectionManager::madeConnection);
+    connect(connection, &TcpConnection::connectionTimeout, this, &ConnectionManager::connectionTimeout);
+    connect(connection, &TcpConnection::connectionTimeout, this, [this, connection]() { removeConnection(connection); });
+    connect(connection, &TcpConnection::finished, this, [this, connection]() { removeConnection(connection); });
+    // clients which do not know about subscriptions get everything, as before
+    m_clients.insert(connection, Client {});
+    updateSubscriptions();
+    connection->receiveConnection();
+    if (m_verbose > 3) {
+        qDebug() << "tcp clients connected:" << m_clients.size();
+    }
+    emit histogramsSubscribed();
+}
+
+void ConnectionManager::removeConnection(TcpConnection* connection)
+{
+    if (m_clients.remove(connection) == 0) {
+        return;
+    }
+    updateSubscriptions();
+    connection->deleteLater();
+    if (m_verbose > 3) {
+        qDebug() << "tcp clients connected:" << m_clients.size();
+    }
+    if (m_closing && m_clients.empty()) {
+        emit finished();
+    }
+}
+
+void ConnectionManager::updateSubscriptions()
+{
+    quint32 groups { TcpMessageGroup::NONE };
+    for (const Client& client : qAsConst(m_clients)) {
+        groups |= client.groups;
+    }
+    m_subscribedGroups.store(groups);
+    m_clientCount.store(m_clients.size());
+}
+
+void ConnectionManager::sendTcpMessage(TcpMessage tcpMessage)
+{
+    const quint32 group { TcpMessageGroup::of(tcpMessage.getMsgID()) };
+    // a connection may close while sending, so the recipients are collected first
+    QVector<TcpConnection*> recipients {};
+    recipients.reserve(m_clients.size());
+    for (auto it = m_clients.cbegin(); it != m_clients.cend(); ++it) {
+        if (group == TcpMessageGroup::NONE || (it.value().groups & group)) {
+            recipients.push_back(it.key());
+        }
+    }
+    for (auto* connection : recipients) {
+        connection->sendTcpMessage(tcpMessage);
+    }
+}
+
+void ConnectionManager::sendHistogram(TcpMessage tcpMessage, QString name, quint32 version)
+{
+    QVector<TcpConnection*> recipients {};
+    for (auto it = m_clients.cbegin(); it != m_clients.cend(); ++it) {
+        if ((it.value().groups & TcpMessageGroup::HISTOGRAMS) && it.value().histogramVersions.value(name, 0) != version) {
+            recipients.push_back(it.key());
+        }
+    }
+    for (auto* connection : recipients) {
+        const bool sent { connection->sendTcpMessage(tcpMessage) };
+        auto it = m_clients.find(connection);
+        if (it == m_clients.end()) {
+            continue;
+        }
+        if (sent) {
+            it.value().histogramVersions.insert(name, version);
+        } else {
+            // dropped under backpressure, the next delta finds the client out of sync
+            it.value().histogramVersions.remove(name);
+        }
+    }
+}
+
+void ConnectionManager::sendHistogramDelta(TcpMessage tcpMessage, QString name, quint32 baseVersion, quint32 version)
+{
+    QVector<TcpConnection*> recipients {};
+    bool resync { false };
+    for (auto it = m_clients.cbegin(); it != m_clients.cend(); ++it) {
+        if (!(it.value().groups & TcpMessageGroup::HISTOGRAMS)) {
+            continue;
+        }
+        if (it.value().histogramVersions.value(name, 0) == baseVersion) {
+            recipients.push_back(it.key());
+        } else {
+            resync = true;
+        }
+    }
+    for (auto* connection : recipients) {
+        const bool sent { connection->sendTcpMessage(tcpMessage) };
+        auto it = m_clients.find(connection);
+        if (it == m_clients.end()) {
+            continue;
+        }
+        if (sent) {
+            it.value().histogramVersions.insert(name, version);
+        } else {
+            it.value().histogramVersions.remove(name);
+            resync = true;
+        }
+    }
+    if (resync) {
+        emit histogramResyncRequired(name);
+    }
+}
+
+void ConnectionManager::closeAll()
+{
+    if (m_closing) {
+        return;
+    }
+    m_closing = true;
+    if (m_clients.empty()) {
+        emit finished();
+        return;
+    }
+    // every connection finishes within the close timeout, see TcpConnection::closeThisConnection
+    const QList<TcpConnection*> connections { m_clients.keys() };
+    for (auto* connection : connections) {
+        connection->closeThisConnection();
+    }
+}
+
+void ConnectionManager::onReceivedTcpMessage(TcpMessage tcpMessage)
+{
+    auto* connection { qobject_cast<TcpConnection*>(sender()) };
+    const TCP_MSG_KEY msgID { static_cast<TCP_MSG_KEY>(tcpMessage.getMsgID()) };
+    if (msgID == TCP_MSG_KEY::MSG_SUBSCRIPTION) {
+        quint32 groups { TcpMessageGroup::NONE };
+        tcpMessage.stream() >> groups;
+        auto it = m_clients.find(connection);
+        if (it != m_clients.end()) {
+            const bool histograms { (groups & TcpMessageGroup::HISTOGRAMS) != 0 };
+            const bool subscribed { histograms && !(it.value().groups & TcpMessageGroup::HISTOGRAMS) };
+            it.value().groups = groups;
+            if (!histograms || subscribed) {
+                it.value().histogramVersions.clear();
+            }
+            updateSubscriptions();
+            if (subscribed) {
+                emit histogramsSubscribed();
+            }
+        }
+        return;
+    }
+    if (msgID == TCP_MSG_KEY::MSG_HISTOGRAM_REQUEST) {
+        // the client lost track of the histogram, only it gets the full histogram again
+        QString name;
+        tcpMessage.stream() >> name;
+        auto it = m_clients.find(connection);
+        if (it != m_clients.end()) {
+            it.value().histogramVersions.remove(name);
+            emit histogramResyncRequired(name);
+        }
+        return;
+    }
+    if (msgID == TCP_MSG_KEY::MSG_QUIT_CONNECTION) {
+        // only the client which sent the message is closed, other clients from the same host stay connected
+        if (m_clients.contains(connection)) {
+            connection->closeThisConnection();
+        }
+        return;
+    }
+    emit receivedTcpMessage(tcpMessage);
+}
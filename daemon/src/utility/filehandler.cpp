@@ -21,11 +21,14 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 using namespace CryptoPP;
 
 const unsigned long int lftpUploadTimeout = MuonPi::Config::Upload::timeout; // in msecs
 const int uploadReminderInterval = MuonPi::Config::Upload::reminder; // in minutes
 const int logReminderInterval = MuonPi::Config::Log::interval; // in minutes
+const int syncReminderInterval = MuonPi::Config::Storage::sync_interval; // in msecs
 
 static std::string SHA256HashString(std::string aString)
 {
@@ -92,6 +95,7 @@ FileHandler::FileHandler(const QString& userName, const QString& passWord, quint
     lastUploadDateTime = QDateTime(QDate::currentDate(), QTime(0, 0, 0, 0), Qt::TimeSpec::UTC);
     dailyUploadTime = QTime(11, 11, 11, 111);
     fileSize = fileSizeMB;
+    m_eventBuffer.resize(std::max(MuonPi::Config::Storage::event_buffer_size, MuonPi::EventRecord::size));
     QDir temp;
     QString fullPath = +"/var/muondetector/";
     hashedMacAddress = QString(QCryptographicHash::hash(getMacAddressByteArray(), QCryptographicHash::Sha224).toHex());
@@ -130,6 +134,11 @@ FileHandler::FileHandler(const QString& userName, const QString& passWord, quint
     }
 }
 
+FileHandler::~FileHandler()
+{
+    closeFiles();
+}
+
 QString FileHandler::getCurrentDataFileName() const
 {
     if (dataFile == nullptr)
@@ -188,6 +197,11 @@ void FileHandler::start()
     uploadReminder->setSingleShot(false);
     connect(uploadReminder, &QTimer::timeout, this, &FileHandler::onUploadRemind);
     uploadReminder->start();
+    QTimer* syncReminder = new QTimer(this);
+    syncReminder->setInterval(syncReminderInterval);
+    syncReminder->setSingleShot(false);
+    connect(syncReminder, &QTimer::timeout, this, &FileHandler::onSyncRemind);
+    syncReminder->start();
     // open files that are currently written
     openFiles();
     emit mqttConnect(username, password);
@@ -212,6 +226,11 @@ void FileHandler::onUploadRemind()
     }
 }
 
+void FileHandler::onSyncRemind()
+{
+    flushEventBuffer(true);
+}
+
 // DATA SAVING
 bool FileHandler::openFiles(bool writeHeader)
 {
@@ -248,10 +267,20 @@ bool FileHandler::openFiles(bool writeHeader)
     }
     if (!dataFile->isOpen() || !logFile->isOpen())
         return false;
+    if (!writeHeader && dataFile->size() > 0 && !hasEventRecordHeader()) {
+        // the data file was started in another format, do not append records to it
+        qDebug() << "data file " << currentWorkingFilePath << " is not an event record file, starting a new one";
+        return switchFiles();
+    }
     // write header
+    if (writeHeader || dataFile->size() == 0) {
+        char header[MuonPi::EventRecord::file_header_size];
+        MuonPi::EventRecord::serializeFileHeader(header);
+        dataFile->write(header, sizeof(header));
+        dataFile->flush();
+        m_dataUnsynced = true;
+    }
     if (writeHeader) {
-        QTextStream dataOut(dataFile);
-        dataOut << "#unix_timestamp_rising(s)  unix_timestamp_trailing(s)  time_accuracy(ns)  valid  timebase(0=gps,2=utc)  utc_available\n";
         QTextStream logOut(logFile);
         logOut << "#log parameters: time<YYYY-MM-DD_hh-mm-ss>  parname   value  unit\n";
     }
@@ -259,8 +288,44 @@ bool FileHandler::openFiles(bool writeHeader)
     return true;
 }
 
+bool FileHandler::hasEventRecordHeader()
+{
+    if (dataFile == nullptr || !dataFile->isOpen()) {
+        return false;
+    }
+    char header[MuonPi::EventRecord::file_header_size];
+    const qint64 position = dataFile->pos();
+    dataFile->seek(0);
+    const qint64 n = dataFile->read(header, sizeof(header));
+    dataFile->seek(position);
+    return (n == sizeof(header)) && (MuonPi::EventRecord::checkFileHeader(header) == MuonPi::EventRecord::format_version);
+}
+
+void FileHandler::flushEventBuffer(bool sync)
+{
+    if (dataFile == nullptr || !dataFile->isOpen()) {
+        return;
+    }
+    if (m_eventBufferFill > 0) {
+        if (dataFile->write(m_eventBuffer.data(), m_eventBufferFill) != static_cast<qint64>(m_eventBufferFill)) {
+            qDebug() << "error writing event records to " << currentWorkingFilePath << ": " << dataFile->errorString();
+        }
+        m_eventBufferFill = 0;
+        dataFile->flush();
+        m_dataUnsynced = true;
+    }
+    if (!sync || !m_dataUnsynced) {
+        return;
+    }
+    if (::fdatasync(dataFile->handle()) != 0) {
+        qDebug() << "fdatasync failed on " << currentWorkingFilePath;
+    }
+    m_dataUnsynced = false;
+}
+
 void FileHandler::closeFiles()
 {
+    flushEventBuffer(true);
     if (dataFile != nullptr) {
         if (dataFile->isOpen()) {
             dataFile->close();
@@ -331,13 +396,16 @@ bool FileHandler::readFileInformation()
     return true;
 }
 
-void FileHandler::writeToDataFile(const QString& data)
+void FileHandler::writeEventRecord(const MuonPi::EventRecord& record)
 {
     if (dataFile == nullptr) {
         return;
     }
-    QTextStream out(dataFile);
-    out << data << "\n";
+    if (m_eventBufferFill + MuonPi::EventRecord::size > m_eventBuffer.size()) {
+        flushEventBuffer();
+    }
+    record.serialize(m_eventBuffer.data() + m_eventBufferFill);
+    m_eventBufferFill += MuonPi::EventRecord::size;
 }
 
 void FileHandler::writeToLogFile(const QString& log)
@@ -395,6 +463,31 @@ bool FileHandler::uploadDataFile(QString fileName)
     return true;
 }
 
+bool FileHandler::convertDataFileToText(const QString& binaryPath, const QString& textPath)
+{
+    QFile binaryFile(binaryPath);
+    if (!binaryFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    char header[MuonPi::EventRecord::file_header_size];
+    if (binaryFile.read(header, sizeof(header)) != sizeof(header) || MuonPi::EventRecord::checkFileHeader(header) != MuonPi::EventRecord::format_version) {
+        return false;
+    }
+    QFile textFile(textPath);
+    if (!textFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "could not open " << textPath << " for the text conversion of " << binaryPath;
+        return false;
+    }
+    QTextStream out(&textFile);
+    out << MuonPi::EventRecord::text_header << "\n";
+    char record[MuonPi::EventRecord::size];
+    while (binaryFile.read(record, sizeof(record)) == sizeof(record)) {
+        out << QString::fromStdString(MuonPi::EventRecord::deserialize(record).toText()) << "\n";
+    }
+    out.flush();
+    return textFile.error() == QFileDevice::NoError;
+}
+
 bool FileHandler::uploadRecentDataFiles()
 {
     readFileInformation();
@@ -412,10 +505,21 @@ bool FileHandler::uploadRecentDataFiles()
         lftp_rc_file.write("set ssl:verify-certificate no\n");
         lftp_rc_file.close();
     }
+    // the server expects the text format, binary data files are converted under the same name before the upload
+    QDir textDir(configPath + "uploadText/");
+    if (!textDir.exists()) {
+        textDir.mkpath(".");
+    }
     for (auto& fileName : notUploadedFilesNames) {
         QString filePath = dataFolderPath + fileName;
         if (filePath != currentWorkingFilePath && filePath != currentWorkingLogPath) {
-            if (!uploadDataFile(filePath)) {
+            const QString textPath = textDir.filePath(fileName);
+            const bool converted = convertDataFileToText(filePath, textPath);
+            const bool uploaded = uploadDataFile(converted ? textPath : filePath);
+            if (converted) {
+                QFile::remove(textPath);
+            }
+            if (!uploaded) {
                 qDebug() << "failed to upload recent files";
                 return false;
             }
@@ -0,0 +1,234 @@
+#include "utility/gpio_clock_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MuonPi {
+
+namespace Measurement = Config::Hardware::GPIO::Clock::Measurement;
+
+GpioClockModel::GpioClockModel(std::size_t window)
+    : m_samples(std::max<std::size_t>(window, 3))
+{
+}
+
+bool GpioClockModel::addSample(std::uint64_t tick, std::int64_t utc_ns)
+{
+    const Sample sample { tick, utc_ns - 1000 * static_cast<std::int64_t>(tick) };
+    if (m_count == 0) {
+        m_originTick = sample.tick;
+        m_originOffset = sample.offset;
+    }
+    const double x { static_cast<double>(static_cast<std::int64_t>(sample.tick - m_originTick)) };
+    const double y { static_cast<double>(sample.offset - m_originOffset) };
+
+    if (m_count >= Measurement::min_samples && m_sxx > 0.) {
+        const double predicted { m_meanY + m_sxy / m_sxx * (x - m_meanX) };
+        const double tolerance { std::max(Measurement::outlier_threshold * residualSigma(), Measurement::outlier_floor) };
+        if (std::fabs(y - predicted) > tolerance) {
+            m_rejected++;
+            if (++m_consecutiveOutliers <= Measurement::max_consecutive_outliers) {
+                return false;
+            }
+            // the system clock was stepped (e.g. by ntp), start over with the new relation
+            reset();
+            return addSample(tick, utc_ns);
+        }
+    }
+    m_consecutiveOutliers = 0;
+
+    if (m_count == m_samples.size()) {
+        const Sample& oldest { m_samples[m_next] };
+        remove(static_cast<double>(static_cast<std::int64_t>(oldest.tick - m_originTick)),
+            static_cast<double>(oldest.offset - m_originOffset));
+    }
+    m_samples[m_next] = sample;
+    m_next = (m_next + 1) % m_samples.size();
+    add(x, y);
+
+    if (++m_sinceRebase >= m_samples.size()) {
+        rebase();
+    }
+    publish();
+    return true;
+}
+
+void GpioClockModel::reset()
+{
+    m_next = 0;
+    m_count = 0;
+    m_sinceRebase = 0;
+    m_consecutiveOutliers = 0;
+    m_meanX = m_meanY = 0.;
+    m_sxx = m_sxy = m_syy = 0.;
+    // the tick epoch is still known, extend() stays usable
+    publish(Coefficients { 0, 0, 0., 0., 0., m_current.latestTick, false });
+}
+
+void GpioClockModel::add(double x, double y)
+{
+    m_count++;
+    const double n { static_cast<double>(m_count) };
+    const double dx { x - m_meanX };
+    const double dy { y - m_meanY };
+    m_meanX += dx / n;
+    m_meanY += dy / n;
+    m_sxx += dx * (x - m_meanX);
+    m_sxy += dx * (y - m_meanY);
+    m_syy += dy * (y - m_meanY);
+}
+
+void GpioClockModel::remove(double x, double y)
+{
+    if (m_count <= 1) {
+        m_count = 0;
+        m_meanX = m_meanY = 0.;
+        m_sxx = m_sxy = m_syy = 0.;
+        return;
+    }
+    m_count--;
+    const double n { static_cast<double>(m_count) };
+    const double dx { x - m_meanX };
+    const double dy { y - m_meanY };
+    m_meanX -= dx / n;
+    m_meanY -= dy / n;
+    m_sxx -= dx * (x - m_meanX);
+    m_sxy -= dx * (y - m_meanY);
+    m_syy -= dy * (y - m_meanY);
+}
+
+void GpioClockModel::rebase()
+{
+    const std::size_t stored { m_count };
+    const Sample& newest { m_samples[(m_next + m_samples.size() - 1) % m_samples.size()] };
+    m_originTick = newest.tick;
+    m_originOffset = newest.offset;
+    m_count = 0;
+    m_meanX = m_meanY = 0.;
+    m_sxx = m_sxy = m_syy = 0.;
+    // before the first wrap-around the samples occupy the start of the buffer, afterwards all of it
+    for (std::size_t i = 0; i < stored; i++) {
+        const Sample& sample { m_samples[i] };
+        add(static_cast<double>(static_cast<std::int64_t>(sample.tick - m_originTick)),
+            static_cast<double>(sample.offset - m_originOffset));
+    }
+    m_sinceRebase = 0;
+}
+
+double GpioClockModel::residualSigma() const
+{
+    if (m_count <= 2 || m_sxx <= 0.) {
+        return 0.;
+    }
+    const double sse { m_syy - m_sxy * m_sxy / m_sxx };
+    return std::sqrt(std::max(sse, 0.) / static_cast<double>(m_count - 2));
+}
+
+void GpioClockModel::publish()
+{
+    Coefficients coefficients {};
+    coefficients.originTick = m_originTick;
+    coefficients.originOffset = m_originOffset;
+    coefficients.slope = (m_count >= 2 && m_sxx > 0.) ? m_sxy / m_sxx : 0.;
+    coefficients.intercept = m_meanY - coefficients.slope * m_meanX;
+    coefficients.latestTick = m_samples[(m_next + m_samples.size() - 1) % m_samples.size()].tick;
+    if (m_count > 2 && m_sxx > 0.) {
+        const double dx { static_cast<double>(static_cast<std::int64_t>(coefficients.latestTick - m_originTick)) - m_meanX };
+        coefficients.uncertainty = residualSigma() * std::sqrt(1. / static_cast<double>(m_count) + dx * dx / m_sxx);
+    }
+    coefficients.valid = (m_count >= Measurement::min_samples);
+    publish(coefficients);
+}
+
+void GpioClockModel::publish(const Coefficients& coefficients)
+{
+    // the slot after the current one is overwritten, readers of the current slot are not disturbed
+    const std::size_t next { (m_publishedIndex.load(std::memory_order_relaxed) + 1) % published_slots };
+    m_published[next].store(coefficients);
+    m_publishedIndex.store(next, std::memory_order_release);
+    m_current = coefficients;
+}
+
+GpioClockModel::Coefficients GpioClockModel::published() const
+{
+    Coefficients coefficients {};
+    while (!m_published[m_publishedIndex.load(std::memory_order_acquire)].load(coefficients)) {
+    }
+    return coefficients;
+}
+
+void GpioClockModel::PublishedCoefficients::store(const Coefficients& coefficients)
+{
+    const std::uint32_t seq { sequence.load(std::memory_order_relaxed) };
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    originTick.store(coefficients.originTick, std::memory_order_relaxed);
+    originOffset.store(coefficients.originOffset, std::memory_order_relaxed);
+    intercept.store(coefficients.intercept, std::memory_order_relaxed);
+    slope.store(coefficients.slope, std::memory_order_relaxed);
+    uncertainty.store(coefficients.uncertainty, std::memory_order_relaxed);
+    latestTick.store(coefficients.latestTick, std::memory_order_relaxed);
+    valid.store(coefficients.valid, std::memory_order_relaxed);
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool GpioClockModel::PublishedCoefficients::load(Coefficients& coefficients) const
+{
+    const std::uint32_t seq { sequence.load(std::memory_order_acquire) };
+    if (seq & 1) {
+        return false;
+    }
+    coefficients.originTick = originTick.load(std::memory_order_relaxed);
+    coefficients.originOffset = originOffset.load(std::memory_order_relaxed);
+    coefficients.intercept = intercept.load(std::memory_order_relaxed);
+    coefficients.slope = slope.load(std::memory_order_relaxed);
+    coefficients.uncertainty = uncertainty.load(std::memory_order_relaxed);
+    coefficients.latestTick = latestTick.load(std::memory_order_relaxed);
+    coefficients.valid = valid.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) == seq;
+}
+
+bool GpioClockModel::valid() const
+{
+    return published().valid;
+}
+
+std::int64_t GpioClockModel::toUtcNs(std::uint64_t tick) const
+{
+    const Coefficients coefficients { published() };
+    if (!coefficients.valid) {
+        return 0;
+    }
+    const double x { static_cast<double>(static_cast<std::int64_t>(tick - coefficients.originTick)) };
+    return 1000 * static_cast<std::int64_t>(tick) + coefficients.originOffset
+        + std::llround(coefficients.intercept + coefficients.slope * x);
+}
+
+std::uint64_t GpioClockModel::extend(std::uint32_t tick) const
+{
+    const std::uint64_t latest { published().latestTick };
+    const std::int32_t diff { static_cast<std::int32_t>(tick - static_cast<std::uint32_t>(latest)) };
+    if (diff < 0 && latest < static_cast<std::uint64_t>(-static_cast<std::int64_t>(diff))) {
+        return tick;
+    }
+    return latest + static_cast<std::uint64_t>(static_cast<std::int64_t>(diff));
+}
+
+double GpioClockModel::uncertainty() const
+{
+    return published().uncertainty;
+}
+
+double GpioClockModel::drift() const
+{
+    // a tick clock running fast makes the offset decrease
+    return -1000. * published().slope;
+}
+
+std::size_t GpioClockModel::rejectedSamples() const
+{
+    return m_rejected;
+}
+
+} // namespace MuonPi
@@ -3,3 +3,100 @@
 #include <map>
 
 std::map<GPIO_PIN, unsigned int> GPIO_PINMAP = GPIO_PINMAP_VERSIONS[MuonPi::Version::hardware.major];
+
+namespace {
+
+using GpioPinTableSet = std::array<GpioPinTable, GPIO_SIGNAL_COUNT + 1>;
+
+constexpr std::size_t triggerIndex(GPIO_PIN samplingTrigger)
+{
+    return (samplingTrigger < GPIO_SIGNAL_COUNT) ? static_cast<std::size_t>(samplingTrigger) : GPIO_SIGNAL_COUNT;
+}
+
+template <std::size_t N>
+constexpr GpioPinTable makeGpioPinTable(const std::array<GpioPinAssignment, N>& assignments, GPIO_PIN samplingTrigger)
+{
+    GpioPinTable table {};
+    for (std::size_t i = 0; i < N; i++) {
+        const GpioPinAssignment& assignment = assignments[i];
+        if (assignment.signal == UNDEFINED_PIN || assignment.bcm >= GPIO_BCM_PIN_COUNT) {
+            continue;
+        }
+        GpioPinInfo& info = table[assignment.bcm];
+        if (assignment.signal < info.signal) {
+            info.signal = assignment.signal;
+        }
+        switch (assignment.signal) {
+        case TIMEPULSE:
+            info.flags |= GpioPinInfo::TIMEPULSE_SIGNAL;
+            break;
+        case EVT_XOR:
+            info.flags |= GpioPinInfo::RATE_XOR;
+            break;
+        case EVT_AND:
+            info.flags |= GpioPinInfo::RATE_AND;
+            break;
+        case TDC_INTB:
+            info.flags |= GpioPinInfo::TDC_INTERRUPT;
+            break;
+        case ADC_READY:
+            info.flags |= GpioPinInfo::ADC_READY_SIGNAL;
+            break;
+        default:
+            break;
+        }
+        if (assignment.signal == samplingTrigger) {
+            info.flags |= GpioPinInfo::SAMPLING_TRIGGER;
+        }
+    }
+    return table;
+}
+
+template <std::size_t N>
+constexpr GpioPinTableSet makeGpioPinTableSet(const std::array<GpioPinAssignment, N>& assignments)
+{
+    GpioPinTableSet tables {};
+    for (std::size_t trigger = 0; trigger < GPIO_SIGNAL_COUNT; trigger++) {
+        tables[trigger] = makeGpioPinTable(assignments, static_cast<GPIO_PIN>(trigger));
+    }
+    tables[GPIO_SIGNAL_COUNT] = makeGpioPinTable(assignments, UNDEFINED_PIN);
+    return tables;
+}
+
+constexpr std::array<GpioPinTableSet, MAX_HW_VER + 1> GPIO_PIN_TABLES {
+    makeGpioPinTableSet(GPIO_PIN_ASSIGNMENTS_V0),
+    makeGpioPinTableSet(GPIO_PIN_ASSIGNMENTS_V1),
+    makeGpioPinTableSet(GPIO_PIN_ASSIGNMENTS_V2),
+    makeGpioPinTableSet(GPIO_PIN_ASSIGNMENTS_V3)
+};
+
+static_assert(GPIO_PIN_TABLES[3][EVT_XOR][27].signal == EVT_XOR, "inconsistent gpio lookup table");
+static_assert(GPIO_PIN_TABLES[3][EVT_XOR][27].flags == (GpioPinInfo::RATE_XOR | GpioPinInfo::SAMPLING_TRIGGER), "inconsistent gpio lookup table");
+static_assert(GPIO_PIN_TABLES[1][EVT_AND][20].signal == PREAMP_1, "inconsistent gpio lookup table");
+
+std::atomic<unsigned int> currentHardwareVersion { MuonPi::Version::hardware.major };
+std::atomic<GPIO_PIN> currentSamplingTrigger { EVT_XOR };
+
+void selectGpioPinTable(unsigned int hwVersion, GPIO_PIN samplingTrigger)
+{
+    if (hwVersion > MAX_HW_VER) {
+        hwVersion = 0;
+    }
+    GPIO_PIN_TABLE.store(&GPIO_PIN_TABLES[hwVersion][triggerIndex(samplingTrigger)], std::memory_order_release);
+}
+
+} // namespace
+
+std::atomic<const GpioPinTable*> GPIO_PIN_TABLE { &GPIO_PIN_TABLES[MuonPi::Version::hardware.major][EVT_XOR] };
+
+void setGpioHardwareVersion(unsigned int hwVersion)
+{
+    currentHardwareVersion.store(hwVersion);
+    selectGpioPinTable(hwVersion, currentSamplingTrigger.load());
+}
+
+void setGpioSamplingTrigger(GPIO_PIN samplingTrigger)
+{
+    currentSamplingTrigger.store(samplingTrigger);
+    selectGpioPinTable(currentHardwareVersion.load(), samplingTrigger);
+}
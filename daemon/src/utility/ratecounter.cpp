@@ -0,0 +1,92 @@
+#include "utility/ratecounter.h"
+
+#include <algorithm>
+
+namespace MuonPi {
+
+RateCounter::RateCounter(const std::vector<std::size_t>& windows, std::uint64_t binWidth)
+    : m_windows { windows }
+    , m_sums(windows.size(), 0)
+    , m_binWidth { std::max<std::uint64_t>(binWidth, 1) }
+{
+    for (auto& window : m_windows) {
+        window = std::max<std::size_t>(window, 1);
+    }
+    const std::size_t capacity { m_windows.empty() ? 1 : *std::max_element(m_windows.begin(), m_windows.end()) };
+    m_bins.resize(capacity, 0);
+}
+
+void RateCounter::add(std::uint64_t tick, std::uint32_t count)
+{
+    advance(tick);
+    m_bins[m_currentBin % m_bins.size()] += count;
+    for (auto& sum : m_sums) {
+        sum += count;
+    }
+}
+
+void RateCounter::advance(std::uint64_t tick)
+{
+    const std::uint64_t bin { tick / m_binWidth };
+    if (!m_started) {
+        m_started = true;
+        m_firstBin = bin;
+        m_currentBin = bin;
+        return;
+    }
+    if (bin <= m_currentBin) {
+        return;
+    }
+    const std::size_t capacity { m_bins.size() };
+    if (bin - m_currentBin >= capacity) {
+        // the whole buffer expired, nothing to carry over
+        std::fill(m_bins.begin(), m_bins.end(), 0);
+        std::fill(m_sums.begin(), m_sums.end(), 0);
+        m_currentBin = bin;
+        return;
+    }
+    for (std::uint64_t next { m_currentBin + 1 }; next <= bin; next++) {
+        for (std::size_t i = 0; i < m_windows.size(); i++) {
+            if (next >= m_firstBin + m_windows[i]) {
+                // the bin dropping out of this window. For the longest window this is the slot
+                // which is reused below, so it has to be subtracted before clearing it.
+                m_sums[i] -= m_bins[(next - m_windows[i]) % capacity];
+            }
+        }
+        m_bins[next % capacity] = 0;
+    }
+    m_currentBin = bin;
+}
+
+double RateCounter::rate(std::size_t window, std::uint64_t tick)
+{
+    if (window >= m_windows.size() || !m_started) {
+        return 0.;
+    }
+    advance(tick);
+    const std::uint64_t coveredBins { std::min<std::uint64_t>(m_windows[window], m_currentBin - m_firstBin + 1) };
+    const std::uint64_t binStart { m_currentBin * m_binWidth };
+    const std::uint64_t partial { (tick > binStart) ? (tick - binStart) : 0 };
+    const std::uint64_t span { (coveredBins - 1) * m_binWidth + partial };
+    if (span == 0) {
+        return 0.;
+    }
+    return 1e6 * static_cast<double>(m_sums[window]) / static_cast<double>(span);
+}
+
+std::uint64_t RateCounter::counts(std::size_t window) const
+{
+    if (window >= m_sums.size()) {
+        return 0;
+    }
+    return m_sums[window];
+}
+
+void RateCounter::clear()
+{
+    std::fill(m_bins.begin(), m_bins.end(), 0);
+    std::fill(m_sums.begin(), m_sums.end(), 0);
+    m_started = false;
+}
+
+} // namespace MuonPi
@@ -0,0 +1,168 @@
+#include "utility/ubx_capture.h"
+
+#include <cstring>
+
+namespace MuonPi {
+
+namespace Capture = Config::Hardware::Ublox::Capture;
+
+static void appendVarint(std::vector<char>& buffer, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+UbxCaptureWriter::UbxCaptureWriter(const std::string& fileName)
+{
+    m_file = std::fopen(fileName.c_str(), "wb");
+    if (m_file == nullptr) {
+        return;
+    }
+    m_last = std::chrono::steady_clock::now();
+    const auto startTime { static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count()) };
+    char header[UbxCapture::header_size];
+    std::memcpy(header, UbxCapture::magic, sizeof(UbxCapture::magic));
+    for (std::size_t i = 0; i < sizeof(startTime); i++) {
+        header[sizeof(UbxCapture::magic) + i] = static_cast<char>((startTime >> (8 * i)) & 0xff);
+    }
+    if (std::fwrite(header, 1, sizeof(header), m_file) != sizeof(header)) {
+        std::fclose(m_file);
+        m_file = nullptr;
+        return;
+    }
+    m_buffer.reserve(Capture::block_size);
+    m_writing.reserve(Capture::block_size);
+    m_thread = std::thread(&UbxCaptureWriter::run, this);
+}
+
+UbxCaptureWriter::~UbxCaptureWriter()
+{
+    if (m_file == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_stop = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+    std::fclose(m_file);
+}
+
+bool UbxCaptureWriter::append(const char* data, std::size_t size)
+{
+    if (m_file == nullptr || size == 0) {
+        return false;
+    }
+    const auto now { std::chrono::steady_clock::now() };
+    bool blockFull { false };
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        // two varints of at most 10 bytes each
+        if (m_buffer.size() + size + 20 > Capture::max_buffered) {
+            m_droppedChunks.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        appendVarint(m_buffer, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - m_last).count()));
+        appendVarint(m_buffer, size);
+        m_buffer.insert(m_buffer.end(), data, data + size);
+        m_last = now;
+        blockFull = (m_buffer.size() >= Capture::block_size);
+    }
+    m_chunks.fetch_add(1, std::memory_order_relaxed);
+    m_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (blockFull) {
+        m_condition.notify_one();
+    }
+    return true;
+}
+
+void UbxCaptureWriter::run()
+{
+    std::unique_lock<std::mutex> lock { m_mutex };
+    for (;;) {
+        m_condition.wait_for(lock, std::chrono::milliseconds(Capture::flush_interval), [this] {
+            return m_stop || m_buffer.size() >= Capture::block_size;
+        });
+        if (!m_buffer.empty()) {
+            // the buffers are swapped, so that append() can continue while the block is written
+            m_buffer.swap(m_writing);
+            lock.unlock();
+            if (std::fwrite(m_writing.data(), 1, m_writing.size(), m_file) != m_writing.size() || std::fflush(m_file) != 0) {
+                m_writeErrors.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_writing.clear();
+            lock.lock();
+        }
+        if (m_stop && m_buffer.empty()) {
+            return;
+        }
+    }
+}
+
+UbxCaptureReader::UbxCaptureReader(const std::string& fileName)
+{
+    m_file = std::fopen(fileName.c_str(), "rb");
+    if (m_file == nullptr) {
+        return;
+    }
+    unsigned char header[UbxCapture::header_size];
+    if (std::fread(header, 1, sizeof(header), m_file) != sizeof(header)
+        || std::memcmp(header, UbxCapture::magic, sizeof(UbxCapture::magic)) != 0) {
+        std::fclose(m_file);
+        m_file = nullptr;
+        return;
+    }
+    std::uint64_t startTime { 0 };
+    for (std::size_t i = 0; i < sizeof(startTime); i++) {
+        startTime |= static_cast<std::uint64_t>(header[sizeof(UbxCapture::magic) + i]) << (8 * i);
+    }
+    m_startTime = static_cast<std::int64_t>(startTime);
+}
+
+UbxCaptureReader::~UbxCaptureReader()
+{
+    if (m_file != nullptr) {
+        std::fclose(m_file);
+    }
+}
+
+bool UbxCaptureReader::readVarint(std::uint64_t& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        const int byte { std::fgetc(m_file) };
+        if (byte == EOF) {
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UbxCaptureReader::next(Chunk& chunk)
+{
+    if (m_file == nullptr) {
+        return false;
+    }
+    std::uint64_t delta { 0 };
+    std::uint64_t size { 0 };
+    if (!readVarint(delta) || !readVarint(size) || size > Capture::max_buffered) {
+        return false;
+    }
+    chunk.data.resize(size);
+    if (std::fread(chunk.data.data(), 1, size, m_file) != size) {
+        return false;
+    }
+    m_time += std::chrono::microseconds(delta);
+    chunk.time = m_time;
+    return true;
+}
+
+} // namespace MuonPi
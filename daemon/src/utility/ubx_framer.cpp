@@ -0,0 +1,149 @@
+#include "utility/ubx_framer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace MuonPi {
+
+UbxFramer::UbxFramer(std::size_t capacity)
+{
+    std::size_t size { 64 };
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_buffer.resize(size);
+    m_mask = size - 1;
+}
+
+std::size_t UbxFramer::write(const char* data, std::size_t size)
+{
+    const std::size_t count { std::min(size, capacity() - (m_head - m_tail)) };
+    const std::size_t offset { m_head & m_mask };
+    const std::size_t first { std::min(count, capacity() - offset) };
+    std::memcpy(m_buffer.data() + offset, data, first);
+    std::memcpy(m_buffer.data(), data + first, count - first);
+    m_head += count;
+    return count;
+}
+
+bool UbxFramer::next(Frame& frame)
+{
+    while (m_scan < m_head) {
+        const std::uint8_t byte { at(m_scan) };
+        switch (m_state) {
+        case State::Sync1:
+            m_scan++;
+            if (byte == sync_char_1) {
+                m_state = State::Sync2;
+            } else {
+                m_tail = m_scan;
+                m_statistics.discardedBytes++;
+            }
+            break;
+        case State::Sync2:
+            if (byte == sync_char_2) {
+                m_scan++;
+                m_chkA = m_chkB = 0;
+                m_state = State::Class;
+            } else {
+                // drop the first sync char, the current byte may start a new frame
+                m_tail = m_scan;
+                m_statistics.discardedBytes++;
+                m_state = State::Sync1;
+            }
+            break;
+        case State::Class:
+        case State::Id:
+        case State::Length1:
+        case State::Length2:
+            m_chkA += byte;
+            m_chkB += m_chkA;
+            m_scan++;
+            if (m_state == State::Class) {
+                m_msgID = static_cast<std::uint16_t>(byte) << 8;
+                m_state = State::Id;
+            } else if (m_state == State::Id) {
+                m_msgID |= byte;
+                m_state = State::Length1;
+            } else if (m_state == State::Length1) {
+                m_length = byte;
+                m_state = State::Length2;
+            } else {
+                m_length |= static_cast<std::size_t>(byte) << 8;
+                if (m_length + header_size + checksum_size > capacity()) {
+                    m_statistics.oversizedFrames++;
+                    resync();
+                    break;
+                }
+                m_state = (m_length > 0) ? State::Payload : State::ChecksumA;
+            }
+            break;
+        case State::Payload: {
+            const std::size_t end { std::min(m_tail + header_size + m_length, m_head) };
+            for (; m_scan < end; m_scan++) {
+                m_chkA += at(m_scan);
+                m_chkB += m_chkA;
+            }
+            if (m_scan == m_tail + header_size + m_length) {
+                m_state = State::ChecksumA;
+            }
+            break;
+        }
+        case State::ChecksumA:
+            if (byte != m_chkA) {
+                m_statistics.checksumErrors++;
+                resync();
+                break;
+            }
+            m_scan++;
+            m_state = State::ChecksumB;
+            break;
+        case State::ChecksumB:
+            if (byte != m_chkB) {
+                m_statistics.checksumErrors++;
+                resync();
+                break;
+            }
+            m_scan++;
+            frame.msgID = m_msgID;
+            frame.payload = view(m_tail + header_size, m_length);
+            m_tail = m_scan;
+            m_state = State::Sync1;
+            m_statistics.frames++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void UbxFramer::reset()
+{
+    m_head = m_tail = m_scan = 0;
+    m_state = State::Sync1;
+}
+
+void UbxFramer::resync()
+{
+    // the sync chars were part of the payload of something else, continue searching right after them
+    m_statistics.resyncs++;
+    m_statistics.discardedBytes++;
+    m_tail++;
+    m_scan = m_tail;
+    m_state = State::Sync1;
+}
+
+std::string_view UbxFramer::view(std::size_t start, std::size_t length)
+{
+    const std::size_t offset { start & m_mask };
+    if (offset + length <= capacity()) {
+        return std::string_view { m_buffer.data() + offset, length };
+    }
+    // the frame wraps around the end of the ring buffer
+    m_scratch.resize(length);
+    const std::size_t first { capacity() - offset };
+    std::memcpy(m_scratch.data(), m_buffer.data() + offset, first);
+    std::memcpy(m_scratch.data() + first, m_buffer.data(), length - first);
+    return std::string_view { m_scratch.data(), length };
+}
+
+} // namespace MuonPi
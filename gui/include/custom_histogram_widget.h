@@ -11,6 +11,7 @@
 
 class QwtPlotHistogram;
 class Histogram;
+struct HistogramDeltaStruct;
 
 class CustomHistogram : public QwtPlot, public Histogram {
     Q_OBJECT
@@ -48,6 +49,7 @@ public slots:
     QwtPlotHistogram* getHistogramPlot() { return fBarChart; }
 
     void setData(const Histogram& hist);
+    void setData(const HistogramDeltaStruct& delta);
 
 private slots:
     void popUpMenu(const QPoint& pos);
@@ -6,6 +6,7 @@
 #include <QWidget>
 
 class Histogram;
+struct HistogramDeltaStruct;
 
 namespace Ui {
 class histogramDataForm;
@@ -15,12 +16,14 @@ class histogramDataForm : public QWidget {
     Q_OBJECT
 signals:
     void histogramCleared(QString histogramName);
+    void histogramRequested(QString histogramName);
 
 public:
     explicit histogramDataForm(QWidget* parent = 0);
     ~histogramDataForm();
 public slots:
-    void onHistogramReceived(const Histogram& h);
+    void onHistogramReceived(const Histogram& h, quint32 version = 0);
+    void onHistogramDeltaReceived(const HistogramDeltaStruct& delta);
     void onUiEnabledStateChange(bool connected);
 
 private slots:
@@ -29,8 +32,11 @@ private slots:
     void on_tableWidget_cellClicked(int row, int column);
 
 private:
+    void updateHistoLabels(const Histogram& h);
+
     Ui::histogramDataForm* ui;
     QMap<QString, Histogram> fHistoMap;
+    QMap<QString, quint32> fHistoVersions; // 0: unversioned or full histogram requested
     QString fCurrentHisto = "";
 };
 
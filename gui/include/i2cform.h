@@ -23,7 +23,7 @@ signals:
     void scanI2cBusRequest();
 
 public slots:
-    void onI2cStatsReceived(quint32 bytesRead, quint32 bytesWritten, const QVector<I2cDeviceEntry>& deviceList);
+    void onI2cStatsReceived(quint32 bytesRead, quint32 bytesWritten, quint32 syscalls, const QVector<I2cDeviceEntry>& deviceList);
     void onUiEnabledStateChange(bool connected);
 
 private slots:
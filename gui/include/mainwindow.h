@@ -24,6 +24,7 @@ struct GnssMonHwStruct;
 struct GnssMonHw2Struct;
 struct LogInfoStruct;
 struct UbxTimeMarkStruct;
+struct HistogramDeltaStruct;
 
 enum class TCP_MSG_KEY : quint16;
 
@@ -54,7 +55,7 @@ signals:
     void preampSwitchReceived(uint8_t channel, bool state);
     void gainSwitchReceived(bool state);
     void temperatureReceived(float temp);
-    void i2cStatsReceived(quint32 bytesRead, quint32 bytesWritten, const QVector<I2cDeviceEntry>& deviceList);
+    void i2cStatsReceived(quint32 bytesRead, quint32 bytesWritten, quint32 syscalls, const QVector<I2cDeviceEntry>& deviceList);
     void spiStatsReceived(bool spiPresent);
     void calibReceived(bool valid, bool eepromValid, quint64 id, const QVector<CalibStruct>& calibList);
     void satsReceived(const QVector<GnssSatellite>& satList);
@@ -72,7 +73,8 @@ signals:
     void gpsFixReceived(quint8 val);
     void ubxUptimeReceived(quint32 val);
     void gpsTP5Received(const UbxTimePulseStruct& tp);
-    void histogramReceived(const Histogram& h);
+    void histogramReceived(const Histogram& h, quint32 version);
+    void histogramDeltaReceived(const HistogramDeltaStruct& delta);
     void triggerSelectionReceived(GPIO_PIN signal);
     void timepulseReceived();
     void adcModeReceived(quint8 mode);
@@ -92,6 +94,7 @@ public slots:
     void makeConnection(QString ipAddress, quint16 port);
     void onTriggerSelectionChanged(GPIO_PIN signal);
     void onHistogramCleared(QString histogramName);
+    void onHistogramRequested(QString histogramName);
     void onAdcModeChanged(quint8 mode);
     void onRateScanStart(uint8_t ch);
     void gpioInhibit(bool inhibit);
@@ -2,6 +2,7 @@
 #include <QMenu>
 #include <histogram.h>
 #include <limits>
+#include <muondetector_structs.h>
 #include <numeric>
 #include <qtextstream.h>
 #include <qpen.h>
@@ -54,16 +55,16 @@ void CustomHistogram::initialize()
 
 void CustomHistogram::setData(const Histogram& hist)
 {
-    fName = hist.getName();
-    fUnit = hist.getUnit();
-    fNrBins = hist.getNrBins();
-    fMin = hist.getMin();
-    fMax = hist.getMax();
-    fUnderflow = hist.getUnderflow();
-    fOverflow = hist.getOverflow();
-    fHistogramMap.clear();
-    for (int i = 0; i < fNrBins; i++)
-        fHistogramMap[i] = hist.getBinContent(i);
+    Histogram::operator=(hist);
+    update();
+}
+
+void CustomHistogram::setData(const HistogramDeltaStruct& delta)
+{
+    for (const auto& bin : delta.bins)
+        setBinContent(bin.first, bin.second);
+    setUnderflow(delta.underflow);
+    setOverflow(delta.overflow);
     update();
 }
 
@@ -151,7 +152,7 @@ void CustomHistogram::exportToFile()
             QTextStream out(&file);
 
             for (int i = 0; i < fNrBins; i++) {
-                out << QString::number(bin2Value(i), 'g', dbl::max_digits10) << "  " << fHistogramMap[i] << "\n";
+                out << QString::number(bin2Value(i), 'g', dbl::max_digits10) << "  " << fBins[i] << "\n";
             }
         }
     }
@@ -161,7 +162,7 @@ void CustomHistogram::update()
 {
     if (!isEnabled())
         return;
-    if (fHistogramMap.empty() || fNrBins <= 1) {
+    if (getEntries() <= 0. || fNrBins <= 1) {
         fBarChart->detach();
         QwtPlot::replot();
         return;
@@ -172,10 +173,10 @@ void CustomHistogram::update()
     double xBinSize = rangeX / (fNrBins - 1);
     double max = 0;
     for (int i = 0; i < fNrBins; i++) {
-        if (fHistogramMap[i] > max)
-            max = fHistogramMap[i];
+        if (fBins[i] > max)
+            max = fBins[i];
         double xval = bin2Value(i);
-        QwtIntervalSample interval(fHistogramMap[i] + 1e-12, xval - xBinSize / 2., xval + xBinSize / 2.);
+        QwtIntervalSample interval(fBins[i] + 1e-12, xval - xBinSize / 2., xval + xBinSize / 2.);
         intervals.push_back(interval);
     }
     if (intervals.size() && fBarChart != nullptr)
@@ -1,6 +1,7 @@
 #include "histogramdataform.h"
 #include "ui_histogramdataform.h"
 #include <histogram.h>
+#include <muondetector_structs.h>
 
 histogramDataForm::histogramDataForm(QWidget* parent)
     : QWidget(parent)
@@ -17,14 +18,47 @@ histogramDataForm::~histogramDataForm()
     delete ui;
 }
 
-void histogramDataForm::onHistogramReceived(const Histogram& h)
+void histogramDataForm::onHistogramReceived(const Histogram& h, quint32 version)
 {
     QString name = QString::fromStdString(h.getName());
     fHistoMap[name] = h;
+    fHistoVersions[name] = version;
     updateHistoTable();
     ui->nrHistosLabel->setText(QString::number(fHistoMap.size()));
 }
 
+void histogramDataForm::onHistogramDeltaReceived(const HistogramDeltaStruct& delta)
+{
+    auto it = fHistoMap.find(delta.name);
+    auto versionIt = fHistoVersions.find(delta.name);
+    if (it == fHistoMap.end() || versionIt == fHistoVersions.end() || *versionIt == 0 || *versionIt != delta.baseVersion) {
+        // out of sync, ask for the full histogram once
+        if (versionIt == fHistoVersions.end() || *versionIt != 0) {
+            fHistoVersions[delta.name] = 0;
+            emit histogramRequested(delta.name);
+        }
+        return;
+    }
+    for (const auto& bin : delta.bins)
+        it->setBinContent(bin.first, bin.second);
+    it->setUnderflow(delta.underflow);
+    it->setOverflow(delta.overflow);
+    *versionIt = delta.version;
+    if (fCurrentHisto == delta.name) {
+        ui->histoWidget->setData(delta);
+        updateHistoLabels(*it);
+    }
+    for (int i = 0; i < ui->tableWidget->rowCount(); i++) {
+        QTableWidgetItem* item = ui->tableWidget->item(i, 0);
+        if (item != nullptr && item->text() == delta.name) {
+            QTableWidgetItem* entriesItem = new QTableWidgetItem(QString::number(it->getEntries()));
+            entriesItem->setSizeHint(QSize(100, 24));
+            ui->tableWidget->setItem(i, 1, entriesItem);
+            break;
+        }
+    }
+}
+
 void histogramDataForm::updateHistoTable()
 {
     ui->tableWidget->setRowCount(fHistoMap.size());
@@ -57,18 +91,23 @@ void histogramDataForm::on_tableWidget_cellClicked(int row, int /*column*/)
         ui->histoWidget->setData(*it);
         ui->histoWidget->setAxisTitle(QwtPlot::xBottom, QString::fromStdString(it->getUnit()));
         ui->histoWidget->rescalePlot();
-        ui->histoNameLabel->setText(QString::fromStdString(it->getName()));
-        ui->nrBinsLabel->setText(QString::number(it->getNrBins()));
-        ui->nrEntriesLabel->setText(QString::number(it->getEntries()));
-        ui->minLabel->setText(QString::number(it->getMin()));
-        ui->maxLabel->setText(QString::number(it->getMax()));
-        ui->underflowLabel->setText(QString::number(it->getUnderflow()));
-        ui->overflowLabel->setText(QString::number(it->getOverflow()));
-        ui->meanLabel->setText(QString::number(it->getMean()) + QString::fromStdString(it->getUnit()));
-        ui->rmsLabel->setText(QString::number(it->getRMS(), 'g', 4) + QString::fromStdString(it->getUnit()));
+        updateHistoLabels(*it);
     }
 }
 
+void histogramDataForm::updateHistoLabels(const Histogram& h)
+{
+    ui->histoNameLabel->setText(QString::fromStdString(h.getName()));
+    ui->nrBinsLabel->setText(QString::number(h.getNrBins()));
+    ui->nrEntriesLabel->setText(QString::number(h.getEntries()));
+    ui->minLabel->setText(QString::number(h.getMin()));
+    ui->maxLabel->setText(QString::number(h.getMax()));
+    ui->underflowLabel->setText(QString::number(h.getUnderflow()));
+    ui->overflowLabel->setText(QString::number(h.getOverflow()));
+    ui->meanLabel->setText(QString::number(h.getMean()) + QString::fromStdString(h.getUnit()));
+    ui->rmsLabel->setText(QString::number(h.getRMS(), 'g', 4) + QString::fromStdString(h.getUnit()));
+}
+
 void histogramDataForm::onUiEnabledStateChange(bool connected)
 {
     if (!connected) {
@@ -85,6 +124,7 @@ void histogramDataForm::onUiEnabledStateChange(bool connected)
         ui->rmsLabel->setText("N/A");
         ui->nrHistosLabel->setText(QString::number(0));
         fHistoMap.clear();
+        fHistoVersions.clear();
         fCurrentHisto = "";
     }
     this->setEnabled(connected);
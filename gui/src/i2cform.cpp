@@ -14,11 +14,12 @@ I2cForm::~I2cForm()
     delete ui;
 }
 
-void I2cForm::onI2cStatsReceived(quint32 bytesRead, quint32 bytesWritten, const QVector<I2cDeviceEntry>& deviceList)
+void I2cForm::onI2cStatsReceived(quint32 bytesRead, quint32 bytesWritten, quint32 syscalls, const QVector<I2cDeviceEntry>& deviceList)
 {
     ui->nrDevicesLabel->setText("Nr. of devices: " + QString::number(deviceList.size()));
     ui->bytesReadLabel->setText("total bytes read: " + QString::number(bytesRead));
     ui->bytesWrittenLabel->setText("total bytes written: " + QString::number(bytesWritten));
+    ui->syscallsLabel->setText("total bus syscalls: " + QString::number(syscalls));
 
     ui->devicesTableWidget->setRowCount(deviceList.size());
     for (int i = 0; i < deviceList.size(); i++) {
@@ -66,6 +67,16 @@ void I2cForm::onI2cStatsReceived(quint32 bytesRead, quint32 bytesWritten, const
         newItem3->setSizeHint(QSize(140, 24));
         newItem3->setTextAlignment(Qt::AlignCenter);
         ui->devicesTableWidget->setItem(i, 2, newItem3);
+
+        QTableWidgetItem* newItem4 = new QTableWidgetItem(QString::number(deviceList[i].nrSyscalls));
+        newItem4->setSizeHint(QSize(100, 24));
+        newItem4->setTextAlignment(Qt::AlignCenter);
+        ui->devicesTableWidget->setItem(i, 3, newItem4);
+
+        QTableWidgetItem* newItem5 = new QTableWidgetItem(QString::number(deviceList[i].lastTransactionTime) + " us");
+        newItem5->setSizeHint(QSize(120, 24));
+        newItem5->setTextAlignment(Qt::AlignCenter);
+        ui->devicesTableWidget->setItem(i, 4, newItem5);
     }
 }
 
@@ -75,6 +86,7 @@ void I2cForm::onUiEnabledStateChange(bool connected)
         ui->nrDevicesLabel->setText("Nr. of devices: ");
         ui->bytesReadLabel->setText("total bytes read: ");
         ui->bytesWrittenLabel->setText("total bytes written: ");
+        ui->syscallsLabel->setText("total bus syscalls: ");
         ui->devicesTableWidget->setRowCount(0);
     }
     this->setEnabled(connected);
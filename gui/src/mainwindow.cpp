@@ -190,7 +190,9 @@ MainWindow::MainWindow(QWidget* parent)
     histogramDataForm* histoTab = new histogramDataForm(this);
     connect(this, &MainWindow::setUiEnabledStates, histoTab, &histogramDataForm::onUiEnabledStateChange);
     connect(this, &MainWindow::histogramReceived, histoTab, &histogramDataForm::onHistogramReceived);
+    connect(this, &MainWindow::histogramDeltaReceived, histoTab, &histogramDataForm::onHistogramDeltaReceived);
     connect(histoTab, &histogramDataForm::histogramCleared, this, &MainWindow::onHistogramCleared);
+    connect(histoTab, &histogramDataForm::histogramRequested, this, &MainWindow::onHistogramRequested);
     ui->tabWidget->addTab(histoTab, "Statistics");
 
     ParameterMonitorForm* paramTab = new ParameterMonitorForm(this);
@@ -287,7 +289,7 @@ void MainWindow::makeConnection(QString ipAddress, quint16 port)
 void MainWindow::onTriggerSelectionChanged(GPIO_PIN signal)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_EVENTTRIGGER);
-    *(tcpMessage.dStream) << signal;
+    tcpMessage.stream() << signal;
     emit sendTcpMessage(tcpMessage);
     sendRequest(TCP_MSG_KEY::MSG_EVENTTRIGGER_REQUEST);
 }
@@ -366,20 +368,35 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
     TCP_MSG_KEY msgID = static_cast<TCP_MSG_KEY>(tcpMessage.getMsgID());
     if (msgID == TCP_MSG_KEY::MSG_GPIO_EVENT) {
         unsigned int gpioPin;
-        *(tcpMessage.dStream) >> gpioPin;
+        tcpMessage.stream() >> gpioPin;
         receivedGpioRisingEdge((GPIO_PIN)gpioPin);
         return;
     }
+    if (msgID == TCP_MSG_KEY::MSG_GPIO_EVENT_BATCH) {
+        quint16 nrEvents { 0 };
+        tcpMessage.stream() >> nrEvents;
+        // the indicators only need to be triggered once per signal and batch
+        QVector<bool> signalSeen(UNDEFINED_PIN + 1, false);
+        for (quint16 i = 0; i < nrEvents; i++) {
+            GpioEventStruct evt;
+            tcpMessage.stream() >> evt;
+            if (!signalSeen[evt.signal]) {
+                signalSeen[evt.signal] = true;
+                receivedGpioRisingEdge(static_cast<GPIO_PIN>(evt.signal));
+            }
+        }
+        return;
+    }
     if (msgID == TCP_MSG_KEY::MSG_UBX_MSG_RATE) {
         QMap<uint16_t, int> msgRateCfgs;
-        *(tcpMessage.dStream) >> msgRateCfgs;
+        tcpMessage.stream() >> msgRateCfgs;
         emit addUbxMsgRates(msgRateCfgs);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_THRESHOLD) {
         quint8 channel;
         float threshold;
-        *(tcpMessage.dStream) >> channel >> threshold;
+        tcpMessage.stream() >> channel >> threshold;
         if (threshold > maxThreshVoltage) {
             sendSetThresh(channel, maxThreshVoltage);
             return;
@@ -392,12 +409,12 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_BIAS_VOLTAGE) {
-        *(tcpMessage.dStream) >> biasDacVoltage;
+        tcpMessage.stream() >> biasDacVoltage;
         updateUiProperties();
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_BIAS_SWITCH) {
-        *(tcpMessage.dStream) >> biasON;
+        tcpMessage.stream() >> biasON;
         emit biasSwitchReceived(biasON);
         updateUiProperties();
         return;
@@ -405,34 +422,34 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
     if (msgID == TCP_MSG_KEY::MSG_PREAMP_SWITCH) {
         quint8 channel;
         bool state;
-        *(tcpMessage.dStream) >> channel >> state;
+        tcpMessage.stream() >> channel >> state;
         emit preampSwitchReceived(channel, state);
         updateUiProperties();
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_GAIN_SWITCH) {
         bool gainSwitch;
-        *(tcpMessage.dStream) >> gainSwitch;
+        tcpMessage.stream() >> gainSwitch;
         emit gainSwitchReceived(gainSwitch);
         updateUiProperties();
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_PCA_SWITCH) {
-        *(tcpMessage.dStream) >> pcaPortMask;
+        tcpMessage.stream() >> pcaPortMask;
         emit inputSwitchReceived(pcaPortMask);
         updateUiProperties();
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_EVENTTRIGGER) {
         unsigned int signal;
-        *(tcpMessage.dStream) >> signal;
+        tcpMessage.stream() >> signal;
         emit triggerSelectionReceived((GPIO_PIN)signal);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_GPIO_RATE) {
         quint8 whichRate;
         QVector<QPointF> rate;
-        *(tcpMessage.dStream) >> whichRate >> rate;
+        tcpMessage.stream() >> whichRate >> rate;
         float rateYValue;
         if (!rate.empty()) {
             rateYValue = rate.at(rate.size() - 1).y();
@@ -455,14 +472,14 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_GEO_POS) {
         GeodeticPos pos;
-        *(tcpMessage.dStream) >> pos.iTOW >> pos.lon >> pos.lat
+        tcpMessage.stream() >> pos.iTOW >> pos.lon >> pos.lat
             >> pos.height >> pos.hMSL >> pos.hAcc >> pos.vAcc;
         emit geodeticPos(pos);
     }
     if (msgID == TCP_MSG_KEY::MSG_ADC_SAMPLE) {
         quint8 channel;
         float value;
-        *(tcpMessage.dStream) >> channel >> value;
+        tcpMessage.stream() >> channel >> value;
         emit adcSampleReceived(channel, value);
         updateUiProperties();
         return;
@@ -470,10 +487,10 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
     if (msgID == TCP_MSG_KEY::MSG_ADC_TRACE) {
         quint16 size;
         QVector<float> sampleBuffer;
-        *(tcpMessage.dStream) >> size;
+        tcpMessage.stream() >> size;
         for (int i = 0; i < size; i++) {
             float value;
-            *(tcpMessage.dStream) >> value;
+            tcpMessage.stream() >> value;
             sampleBuffer.push_back(value);
         }
         emit adcTraceReceived(sampleBuffer);
@@ -482,14 +499,14 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
     if (msgID == TCP_MSG_KEY::MSG_DAC_READBACK) {
         quint8 channel;
         float value;
-        *(tcpMessage.dStream) >> channel >> value;
+        tcpMessage.stream() >> channel >> value;
         emit dacReadbackReceived(channel, value);
         updateUiProperties();
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_TEMPERATURE) {
         float value;
-        *(tcpMessage.dStream) >> value;
+        tcpMessage.stream() >> value;
         emit temperatureReceived(value);
         updateUiProperties();
         return;
@@ -498,26 +515,34 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
         quint8 nrDevices = 0;
         quint32 bytesRead = 0;
         quint32 bytesWritten = 0;
-        *(tcpMessage.dStream) >> nrDevices >> bytesRead >> bytesWritten;
+        quint32 syscalls = 0;
+        tcpMessage.stream() >> nrDevices >> bytesRead >> bytesWritten;
 
         QVector<I2cDeviceEntry> deviceList;
         for (uint8_t i = 0; i < nrDevices; i++) {
             uint8_t addr = 0;
             QString title = "none";
             uint8_t status = 0;
-            *(tcpMessage.dStream) >> addr >> title >> status;
+            tcpMessage.stream() >> addr >> title >> status;
             I2cDeviceEntry entry;
             entry.address = addr;
             entry.name = title;
             entry.status = status;
             deviceList.push_back(entry);
         }
-        emit i2cStatsReceived(bytesRead, bytesWritten, deviceList);
+        // older daemons do not send the transfer statistics
+        if (!tcpMessage.stream().atEnd()) {
+            tcpMessage.stream() >> syscalls;
+            for (auto& entry : deviceList) {
+                tcpMessage.stream() >> entry.nrBytesRead >> entry.nrBytesWritten >> entry.nrIoErrors >> entry.nrSyscalls >> entry.lastTransactionTime;
+            }
+        }
+        emit i2cStatsReceived(bytesRead, bytesWritten, syscalls, deviceList);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_SPI_STATS) {
         bool spiPresent;
-        *(tcpMessage.dStream) >> spiPresent;
+        tcpMessage.stream() >> spiPresent;
         emit spiStatsReceived(spiPresent);
     }
     if (msgID == TCP_MSG_KEY::MSG_CALIB_SET) {
@@ -525,12 +550,12 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
         quint64 id = 0;
         bool valid = false;
         bool eepromValid = 0;
-        *(tcpMessage.dStream) >> valid >> eepromValid >> id >> nrPars;
+        tcpMessage.stream() >> valid >> eepromValid >> id >> nrPars;
 
         QVector<CalibStruct> calibList;
         for (uint8_t i = 0; i < nrPars; i++) {
             CalibStruct item;
-            *(tcpMessage.dStream) >> item;
+            tcpMessage.stream() >> item;
             calibList.push_back(item);
         }
         emit calibReceived(valid, eepromValid, id, calibList);
@@ -538,12 +563,12 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_GNSS_SATS) {
         int nrSats = 0;
-        *(tcpMessage.dStream) >> nrSats;
+        tcpMessage.stream() >> nrSats;
 
         QVector<GnssSatellite> satList;
         for (uint8_t i = 0; i < nrSats; i++) {
             GnssSatellite sat;
-            *(tcpMessage.dStream) >> sat;
+            tcpMessage.stream() >> sat;
             satList.push_back(sat);
         }
         emit satsReceived(satList);
@@ -553,12 +578,12 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
         int numTrkCh = 0;
         int nrConfigs = 0;
 
-        *(tcpMessage.dStream) >> numTrkCh >> nrConfigs;
+        tcpMessage.stream() >> numTrkCh >> nrConfigs;
 
         QVector<GnssConfigStruct> configList;
         for (int i = 0; i < nrConfigs; i++) {
             GnssConfigStruct config;
-            *(tcpMessage.dStream) >> config.gnssId >> config.resTrkCh >> config.maxTrkCh >> config.flags;
+            tcpMessage.stream() >> config.gnssId >> config.resTrkCh >> config.maxTrkCh >> config.flags;
             configList.push_back(config);
         }
         emit gnssConfigsReceived(numTrkCh, configList);
@@ -566,70 +591,70 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_TIME_ACCURACY) {
         quint32 acc = 0;
-        *(tcpMessage.dStream) >> acc;
+        tcpMessage.stream() >> acc;
         emit timeAccReceived(acc);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_FREQ_ACCURACY) {
         quint32 acc = 0;
-        *(tcpMessage.dStream) >> acc;
+        tcpMessage.stream() >> acc;
         emit freqAccReceived(acc);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_EVENTCOUNTER) {
         quint32 cnt = 0;
-        *(tcpMessage.dStream) >> cnt;
+        tcpMessage.stream() >> cnt;
         emit intCounterReceived(cnt);
         ui->eventCounter->setText(QString::number(cnt));
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_UPTIME) {
         quint32 val = 0;
-        *(tcpMessage.dStream) >> val;
+        tcpMessage.stream() >> val;
         emit ubxUptimeReceived(val);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_TXBUF) {
         quint8 val = 0;
-        *(tcpMessage.dStream) >> val;
+        tcpMessage.stream() >> val;
         emit txBufReceived(val);
-        if (!tcpMessage.dStream->atEnd()) {
-            *(tcpMessage.dStream) >> val;
+        if (!tcpMessage.stream().atEnd()) {
+            tcpMessage.stream() >> val;
             emit txBufPeakReceived(val);
         }
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_RXBUF) {
         quint8 val = 0;
-        *(tcpMessage.dStream) >> val;
+        tcpMessage.stream() >> val;
         emit rxBufReceived(val);
-        if (!tcpMessage.dStream->atEnd()) {
-            *(tcpMessage.dStream) >> val;
+        if (!tcpMessage.stream().atEnd()) {
+            tcpMessage.stream() >> val;
             emit rxBufPeakReceived(val);
         }
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_TXBUF_PEAK) {
         quint8 val = 0;
-        *(tcpMessage.dStream) >> val;
+        tcpMessage.stream() >> val;
         emit txBufPeakReceived(val);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_RXBUF_PEAK) {
         quint8 val = 0;
-        *(tcpMessage.dStream) >> val;
+        tcpMessage.stream() >> val;
         emit rxBufPeakReceived(val);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_MONHW) {
         GnssMonHwStruct hw;
-        *(tcpMessage.dStream) >> hw;
+        tcpMessage.stream() >> hw;
         emit gpsMonHWReceived(hw);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_MONHW2) {
         GnssMonHw2Struct hw2;
-        *(tcpMessage.dStream) >> hw2;
+        tcpMessage.stream() >> hw2;
         emit gpsMonHW2Received(hw2);
         return;
     }
@@ -637,70 +662,91 @@ void MainWindow::receivedTcpMessage(TcpMessage tcpMessage)
         QString sw = "";
         QString hw = "";
         QString pv = "";
-        *(tcpMessage.dStream) >> sw >> hw >> pv;
+        tcpMessage.stream() >> sw >> hw >> pv;
         emit gpsVersionReceived(sw, hw, pv);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_FIXSTATUS) {
         quint8 val = 0;
-        *(tcpMessage.dStream) >> val;
+        tcpMessage.stream() >> val;
         emit gpsFixReceived(val);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_CFG_TP5) {
         UbxTimePulseStruct tp;
-        *(tcpMessage.dStream) >> tp;
+        tcpMessage.stream() >> tp;
         emit gpsTP5Received(tp);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_HISTOGRAM) {
         Histogram h;
-        *(tcpMessage.dStream) >> h;
-        emit histogramReceived(h);
+        quint32 version = 0;
+        tcpMessage.stream() >> h;
+        // daemons supporting incremental updates append the histogram version
+        if (!tcpMessage.stream().atEnd()) {
+            tcpMessage.stream() >> version;
+        }
+        emit histogramReceived(h, version);
+        return;
+    }
+    if (msgID == TCP_MSG_KEY::MSG_HISTOGRAM_DELTA) {
+        HistogramDeltaStruct delta;
+        tcpMessage.stream() >> delta;
+        emit histogramDeltaReceived(delta);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_ADC_MODE) {
         quint8 mode;
-        *(tcpMessage.dStream) >> mode;
+        tcpMessage.stream() >> mode;
         emit adcModeReceived(mode);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_LOG_INFO) {
         LogInfoStruct lis;
-        *(tcpMessage.dStream) >> lis;
+        tcpMessage.stream() >> lis;
         emit logInfoReceived(lis);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_UBX_TIMEMARK) {
         UbxTimeMarkStruct tm;
-        *(tcpMessage.dStream) >> tm;
+        tcpMessage.stream() >> tm;
         emit timeMarkReceived(tm);
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_MQTT_STATUS) {
         bool connected = false;
-        *(tcpMessage.dStream) >> connected;
+        tcpMessage.stream() >> connected;
         emit mqttStatusChanged(connected);
         return;
     }
+    if (msgID == TCP_MSG_KEY::MSG_CONNECTION_STATUS) {
+        TcpConnectionStatusStruct status {};
+        tcpMessage.stream() >> status;
+        ui->ipStatusLabel->setToolTip(QString("daemon send queue: %1 messages, %2 bytes\ndropped low priority messages: %3 (%4 bytes)")
+                                          .arg(status.queuedMessages)
+                                          .arg(status.queuedBytes)
+                                          .arg(status.droppedMessages)
+                                          .arg(status.droppedBytes));
+        return;
+    }
     if (msgID == TCP_MSG_KEY::MSG_POLARITY_SWITCH) {
         bool pol1;
         bool pol2;
-        *(tcpMessage.dStream) >> pol1 >> pol2;
+        tcpMessage.stream() >> pol1 >> pol2;
         emit polaritySwitchReceived(pol1, pol2);
         updateUiProperties();
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_GPIO_INHIBIT) {
         bool inhibit;
-        *(tcpMessage.dStream) >> inhibit;
+        tcpMessage.stream() >> inhibit;
         emit gpioInhibitReceived(inhibit);
         updateUiProperties();
         return;
     }
     if (msgID == TCP_MSG_KEY::MSG_MQTT_INHIBIT) {
         bool inhibit;
-        *(tcpMessage.dStream) >> inhibit;
+        tcpMessage.stream() >> inhibit;
         emit mqttInhibitReceived(inhibit);
         updateUiProperties();
         return;
@@ -722,14 +768,14 @@ void MainWindow::sendRequest(TCP_MSG_KEY requestSig)
 void MainWindow::sendRequest(quint16 requestSig, quint8 par)
 {
     TcpMessage tcpMessage(requestSig);
-    *(tcpMessage.dStream) << par;
+    tcpMessage.stream() << par;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::sendRequest(TCP_MSG_KEY requestSig, quint8 par)
 {
     TcpMessage tcpMessage(requestSig);
-    *(tcpMessage.dStream) << par;
+    tcpMessage.stream() << par;
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -742,7 +788,7 @@ void MainWindow::sendRequestUbxMsgRates()
 void MainWindow::sendSetBiasVoltage(float voltage)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_BIAS_VOLTAGE);
-    *(tcpMessage.dStream) << voltage;
+    tcpMessage.stream() << voltage;
     emit sendTcpMessage(tcpMessage);
     emit sendRequest(TCP_MSG_KEY::MSG_BIAS_VOLTAGE_REQUEST);
 }
@@ -750,35 +796,35 @@ void MainWindow::sendSetBiasVoltage(float voltage)
 void MainWindow::sendSetBiasStatus(bool status)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_BIAS_SWITCH);
-    *(tcpMessage.dStream) << status;
+    tcpMessage.stream() << status;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::sendGainSwitch(bool status)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_GAIN_SWITCH);
-    *(tcpMessage.dStream) << status;
+    tcpMessage.stream() << status;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::sendPreamp1Switch(bool status)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_PREAMP_SWITCH);
-    *(tcpMessage.dStream) << (quint8)0 << status;
+    tcpMessage.stream() << (quint8)0 << status;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::sendPreamp2Switch(bool status)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_PREAMP_SWITCH);
-    *(tcpMessage.dStream) << (quint8)1 << status;
+    tcpMessage.stream() << (quint8)1 << status;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::sendSetThresh(uint8_t channel, float value)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_THRESHOLD);
-    *(tcpMessage.dStream) << channel << value;
+    tcpMessage.stream() << channel << value;
     emit sendTcpMessage(tcpMessage);
     emit sendRequest(TCP_MSG_KEY::MSG_THRESHOLD_REQUEST, channel);
 }
@@ -786,7 +832,7 @@ void MainWindow::sendSetThresh(uint8_t channel, float value)
 void MainWindow::sendSetUbxMsgRateChanges(QMap<uint16_t, int> changes)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_MSG_RATE);
-    *(tcpMessage.dStream) << changes;
+    tcpMessage.stream() << changes;
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -799,21 +845,28 @@ void MainWindow::onSendUbxReset()
 void MainWindow::onHistogramCleared(QString histogramName)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_HISTOGRAM_CLEAR);
-    *(tcpMessage.dStream) << histogramName;
+    tcpMessage.stream() << histogramName;
+    emit sendTcpMessage(tcpMessage);
+}
+
+void MainWindow::onHistogramRequested(QString histogramName)
+{
+    TcpMessage tcpMessage(TCP_MSG_KEY::MSG_HISTOGRAM_REQUEST);
+    tcpMessage.stream() << histogramName;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::onAdcModeChanged(quint8 mode)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_ADC_MODE);
-    *(tcpMessage.dStream) << mode;
+    tcpMessage.stream() << mode;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::onRateScanStart(uint8_t ch)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_RATE_SCAN);
-    *(tcpMessage.dStream) << (quint8)ch;
+    tcpMessage.stream() << (quint8)ch;
     emit sendTcpMessage(tcpMessage);
 }
 
@@ -821,9 +874,9 @@ void MainWindow::onSetGnssConfigs(const QVector<GnssConfigStruct>& configList)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_GNSS_CONFIG);
     int N = configList.size();
-    *(tcpMessage.dStream) << (int)N;
+    tcpMessage.stream() << (int)N;
     for (int i = 0; i < N; i++) {
-        *(tcpMessage.dStream) << configList[i].gnssId << configList[i].resTrkCh
+        tcpMessage.stream() << configList[i].gnssId << configList[i].resTrkCh
                               << configList[i].maxTrkCh << configList[i].flags;
     }
     emit sendTcpMessage(tcpMessage);
@@ -832,27 +885,27 @@ void MainWindow::onSetGnssConfigs(const QVector<GnssConfigStruct>& configList)
 void MainWindow::onSetTP5Config(const UbxTimePulseStruct& tp)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_UBX_CFG_TP5);
-    *(tcpMessage.dStream) << tp;
+    tcpMessage.stream() << tp;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::sendRequestGpioRates()
 {
     TcpMessage xorRateRequest(TCP_MSG_KEY::MSG_GPIO_RATE_REQUEST);
-    *(xorRateRequest.dStream) << (quint16)5 << (quint8)0;
+    xorRateRequest.stream() << (quint16)5 << (quint8)0;
     emit sendTcpMessage(xorRateRequest);
     TcpMessage andRateRequest(TCP_MSG_KEY::MSG_GPIO_RATE_REQUEST);
-    *(andRateRequest.dStream) << (quint16)5 << (quint8)1;
+    andRateRequest.stream() << (quint16)5 << (quint8)1;
     emit sendTcpMessage(andRateRequest);
 }
 
 void MainWindow::sendRequestGpioRateBuffer()
 {
     TcpMessage xorRateRequest(TCP_MSG_KEY::MSG_GPIO_RATE_REQUEST);
-    *(xorRateRequest.dStream) << (quint16)0 << (quint8)0;
+    xorRateRequest.stream() << (quint16)0 << (quint8)0;
     emit sendTcpMessage(xorRateRequest);
     TcpMessage andRateRequest(TCP_MSG_KEY::MSG_GPIO_RATE_REQUEST);
-    *(andRateRequest.dStream) << (quint16)0 << (quint8)1;
+    andRateRequest.stream() << (quint16)0 << (quint8)1;
     emit sendTcpMessage(andRateRequest);
 }
 
@@ -963,6 +1016,10 @@ void MainWindow::connected()
     connectedToDemon = true;
     saveSettings(addresses);
     uiSetConnectedState();
+    // the gui displays all data streams of the daemon
+    TcpMessage subscription(TCP_MSG_KEY::MSG_SUBSCRIPTION);
+    subscription.stream() << static_cast<quint32>(TcpMessageGroup::ALL);
+    emit sendTcpMessage(subscription);
     sendValueUpdateRequests();
     sendRequest(TCP_MSG_KEY::MSG_PREAMP_SWITCH_REQUEST, 0);
     sendRequest(TCP_MSG_KEY::MSG_PREAMP_SWITCH_REQUEST, 1);
@@ -1093,7 +1150,7 @@ void MainWindow::on_biasPowerButton_clicked()
 void MainWindow::sendInputSwitch(uint8_t id)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_PCA_SWITCH);
-    *(tcpMessage.dStream) << (quint8)id;
+    tcpMessage.stream() << (quint8)id;
     emit sendTcpMessage(tcpMessage);
     sendRequest(TCP_MSG_KEY::MSG_PCA_SWITCH_REQUEST);
 }
@@ -1134,9 +1191,9 @@ void MainWindow::onCalibUpdated(const QVector<CalibStruct>& items)
 
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_CALIB_SET);
     if (items.size()) {
-        *(tcpMessage.dStream) << (quint8)items.size();
+        tcpMessage.stream() << (quint8)items.size();
         for (int i = 0; i < items.size(); i++) {
-            *(tcpMessage.dStream) << items[i];
+            tcpMessage.stream() << items[i];
         }
         emit sendTcpMessage(tcpMessage);
     }
@@ -1199,20 +1256,20 @@ void MainWindow::on_biasVoltageDoubleSpinBox_valueChanged(double arg1)
 void MainWindow::gpioInhibit(bool inhibit)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_GPIO_INHIBIT);
-    *(tcpMessage.dStream) << inhibit;
+    tcpMessage.stream() << inhibit;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::mqttInhibit(bool inhibit)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_MQTT_INHIBIT);
-    *(tcpMessage.dStream) << inhibit;
+    tcpMessage.stream() << inhibit;
     emit sendTcpMessage(tcpMessage);
 }
 
 void MainWindow::onPolarityChanged(bool pol1, bool pol2)
 {
     TcpMessage tcpMessage(TCP_MSG_KEY::MSG_POLARITY_SWITCH);
-    *(tcpMessage.dStream) << pol1 << pol2;
+    tcpMessage.stream() << pol1 << pol2;
     emit sendTcpMessage(tcpMessage);
 }
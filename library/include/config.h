@@ -3,6 +3,7 @@
 
 #include "version.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -32,10 +33,33 @@ namespace MQTT {
     constexpr int keepalive_interval { 45 };
     constexpr const char* data_topic { "muonpi/data/" };
     constexpr const char* log_topic { "muonpi/log/" };
+    namespace Batch {
+        constexpr int max_events { 32 }; // events per data message, 1 sends every event separately
+        constexpr int max_latency { 2000 }; // in ms, a started batch is sent at the latest after this time
+    }
+    namespace Journal {
+        constexpr const char* file { "/var/muondetector/mqtt_journal" };
+        constexpr std::int64_t max_size { 67108864 }; // in bytes, further batches are dropped
+        constexpr std::int64_t compact_size { 1048576 }; // in bytes, consumed records at the start of the file are removed above this size
+        constexpr int replay_interval { 100 }; // in ms
+        constexpr int replay_batches { 10 }; // batches published per replay interval
+    }
+}
+namespace Tcp {
+    constexpr std::size_t high_water_mark { 1048576 }; // in bytes, above this backlog low priority messages are dropped
+    constexpr std::size_t socket_buffer_size { 65536 }; // in bytes, handed to the socket at once, the rest waits in the outbound queue
+    constexpr int status_interval { 5000 }; // in ms, interval of the connection status messages
+    constexpr std::uint32_t max_frame_size { 67108864 }; // in bytes, larger frames are considered a protocol error
+    constexpr int close_timeout { 2000 }; // in ms, time for the pending data to reach the peer when closing a connection
 }
 namespace Log {
     constexpr int interval { 1 };
     constexpr int max_geohash_length { 6 };
+    constexpr bool min_max { false }; // numeric averaged parameters are also logged with their minimum and maximum as <name>Min/<name>Max
+}
+namespace Storage {
+    constexpr std::size_t event_buffer_size { 65536 }; // in bytes, binary event records are collected before writing
+    constexpr int sync_interval { 60000 }; // in ms, interval for flushing the event buffer to the storage medium
 }
 namespace Upload {
     constexpr int reminder { 5 };
@@ -47,10 +71,32 @@ namespace Hardware {
     namespace OLED {
         constexpr int update_interval { 2000 };
     }
+    namespace I2C {
+        constexpr int latency_bins { 250 };
+        constexpr double latency_max { 50. }; // in ms, upper edge of the transaction latency histograms
+    }
+    namespace Ublox {
+        constexpr std::size_t stream_buffer_size { 65536 }; // in bytes, must be a power of two
+        constexpr std::size_t max_commands_in_flight { 8 }; // number of sent messages waiting for an ACK/NAK at the same time
+        namespace Capture {
+            constexpr std::size_t block_size { 65536 }; // in bytes, the writer thread writes as soon as this much is buffered
+            constexpr int flush_interval { 1000 }; // in ms, buffered data is written at the latest after this time
+            constexpr std::size_t max_buffered { 4194304 }; // in bytes, further chunks are dropped while the writer is behind
+        }
+        namespace Replay {
+            constexpr std::size_t batch { 64 }; // chunks processed per event loop iteration when replaying as fast as possible
+        }
+    }
     namespace ADC {
         constexpr int buffer_size { 50 };
         constexpr int pretrigger { 10 };
         constexpr int deadtime { 8 };
+        constexpr unsigned int trace_rate { 7 }; // data rate setting of the continuous conversions for traces, 860 SPS
+        namespace ReadyInterrupt {
+            constexpr bool enabled { true }; // wait for the ALERT/RDY pin instead of polling the config register
+            constexpr int timeout_margin { 2000 }; // in us, added to twice the nominal conversion time
+            constexpr unsigned int max_timeouts { 10 }; // consecutive timeouts after which the interrupt is not used anymore
+        }
     }
     namespace DAC {
         namespace Voltage {
@@ -58,11 +104,32 @@ namespace Hardware {
             constexpr float threshold[2] { 0.1, 1.0 };
         }
     }
+    namespace GPIO {
+        constexpr std::size_t event_buffer_size { 4096 };
+        constexpr std::size_t event_drain_batch { 256 };
+        constexpr bool legacy_event_signals { false }; // compatibility path, emit signal() and eventInterval() per event
+        namespace EventBatch {
+            constexpr int flush_window { 100 }; // in ms, 0 disables batching
+            constexpr int max_events { 512 };
+            // upper limit, so that a batch always fits into a frame with a plain 16bit length (17 bytes per event
+            // plus message id and event count) and stays readable by GUI versions without extended frames
+            constexpr int max_events_limit { 3854 };
+        }
+        namespace Rate {
+            // averaging windows of the event rate counters in s
+            constexpr std::size_t short_window { 1 };
+            constexpr std::size_t default_window { 60 };
+            constexpr std::size_t long_window { 3600 };
+        }
+    }
     namespace GPIO::Clock::Measurement {
         constexpr int interval { 100 };
         constexpr int buffer_size { 500 };
+        constexpr std::size_t min_samples { 10 }; // samples needed before the model is used and outliers are rejected
+        constexpr double outlier_threshold { 5.0 }; // in standard deviations of the residuals
+        constexpr double outlier_floor { 10000. }; // in ns, residuals below this are never rejected
+        constexpr std::size_t max_consecutive_outliers { 10 }; // more rejected samples in a row are taken as a clock step
     }
-    constexpr int trace_sampling_interval { 5 };
     constexpr int monitor_interval { 5000 };
     namespace RateScan {
         constexpr int iterations { 10 };
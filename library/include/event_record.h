@@ -0,0 +1,145 @@
+#ifndef EVENT_RECORD_H
+#define EVENT_RECORD_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace MuonPi {
+
+/**
+ * @brief Binary record of one time mark event as stored in the local data files
+ * A data file starts with a 16 byte file header (magic "MUONPIEV", format version, record size, reserved),
+ * followed by fixed size records. All fields are little-endian, independent of the host byte order.
+ * Record layout (24 bytes):
+ *  0  int64   rising edge, ns since the unix epoch
+ *  8  int64   falling edge, ns since the unix epoch
+ * 16  uint32  time accuracy estimate, ns
+ * 20  uint16  event counter of the gnss receiver
+ * 22  uint8   flags, see EventRecord::Flags
+ * 23  uint8   time base (0=receiver, 1=gnss, 2=utc)
+ */
+struct EventRecord {
+    enum Flags : std::uint8_t {
+        VALID = 0x01,
+        UTC_AVAILABLE = 0x02,
+        RISING_VALID = 0x04,
+        FALLING_VALID = 0x08
+    };
+
+    static constexpr std::size_t size { 24 };
+    static constexpr std::size_t file_header_size { 16 };
+    static constexpr std::uint16_t format_version { 1 };
+    static constexpr std::array<char, 8> magic { { 'M', 'U', 'O', 'N', 'P', 'I', 'E', 'V' } };
+    // first line of the text conversion, names the columns written by toText()
+    static constexpr const char* text_header { "#unix_timestamp_rising(s)  unix_timestamp_trailing(s)  time_accuracy(ns)  counter  valid  timebase(0=gps,2=utc)  utc_available" };
+
+    std::int64_t rising_ns { 0 };
+    std::int64_t falling_ns { 0 };
+    std::uint32_t accuracy_ns { 0 };
+    std::uint16_t counter { 0 };
+    std::uint8_t flags { 0 };
+    std::uint8_t timeBase { 0 };
+
+    void serialize(char* out) const;
+    [[nodiscard]] static EventRecord deserialize(const char* in);
+    static void serializeFileHeader(char* out);
+    /**
+     * @brief checkFileHeader
+     * @return the format version of the file, 0 if the header is not an event record header
+     */
+    [[nodiscard]] static std::uint16_t checkFileHeader(const char* in);
+    /**
+     * @brief toText Format the record in the columns of the former text data files:
+     * rising falling accuracy counter valid timebase utc_available
+     */
+    [[nodiscard]] std::string toText() const;
+};
+
+namespace detail {
+    template <typename T>
+    inline void putLE(char* out, T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            out[i] = static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xff);
+        }
+    }
+
+    template <typename T>
+    [[nodiscard]] inline T getLE(const char* in)
+    {
+        std::uint64_t value { 0 };
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(in[i])) << (8 * i);
+        }
+        return static_cast<T>(value);
+    }
+} // namespace detail
+
+inline void EventRecord::serialize(char* out) const
+{
+    detail::putLE(out, rising_ns);
+    detail::putLE(out + 8, falling_ns);
+    detail::putLE(out + 16, accuracy_ns);
+    detail::putLE(out + 20, counter);
+    out[22] = static_cast<char>(flags);
+    out[23] = static_cast<char>(timeBase);
+}
+
+inline EventRecord EventRecord::deserialize(const char* in)
+{
+    EventRecord record {};
+    record.rising_ns = detail::getLE<std::int64_t>(in);
+    record.falling_ns = detail::getLE<std::int64_t>(in + 8);
+    record.accuracy_ns = detail::getLE<std::uint32_t>(in + 16);
+    record.counter = detail::getLE<std::uint16_t>(in + 20);
+    record.flags = static_cast<std::uint8_t>(in[22]);
+    record.timeBase = static_cast<std::uint8_t>(in[23]);
+    return record;
+}
+
+inline void EventRecord::serializeFileHeader(char* out)
+{
+    std::memcpy(out, magic.data(), magic.size());
+    detail::putLE(out + 8, format_version);
+    detail::putLE(out + 10, static_cast<std::uint16_t>(size));
+    detail::putLE(out + 12, std::uint32_t { 0 });
+}
+
+inline std::uint16_t EventRecord::checkFileHeader(const char* in)
+{
+    if (std::memcmp(in, magic.data(), magic.size()) != 0) {
+        return 0;
+    }
+    return detail::getLE<std::uint16_t>(in + 8);
+}
+
+inline std::string EventRecord::toText() const
+{
+    // floor division, so that timestamps before the epoch keep a positive ns part
+    auto split = [](std::int64_t ns, long long& sec, long& nsec) {
+        sec = ns / 1000000000LL;
+        nsec = static_cast<long>(ns % 1000000000LL);
+        if (nsec < 0) {
+            sec -= 1;
+            nsec += 1000000000L;
+        }
+    };
+    long long risingSec, fallingSec;
+    long risingNsec, fallingNsec;
+    split(rising_ns, risingSec, risingNsec);
+    split(falling_ns, fallingSec, fallingNsec);
+    char line[128];
+    std::snprintf(line, sizeof(line), "%lld.%09ld %lld.%09ld %u %u %d %d %d",
+        risingSec, risingNsec, fallingSec, fallingNsec,
+        static_cast<unsigned int>(accuracy_ns), static_cast<unsigned int>(counter),
+        (flags & VALID) ? 1 : 0, static_cast<int>(timeBase), (flags & UTC_AVAILABLE) ? 1 : 0);
+    return std::string { line };
+}
+
+} // namespace MuonPi
+
+#endif // EVENT_RECORD_H
@@ -5,8 +5,8 @@
 
 #include <QDataStream>
 //#include <cmath>
-#include <map>
 #include <string>
+#include <vector>
 
 class Histogram {
 public:
@@ -30,14 +30,24 @@ public:
     void fill(double x, double mult = 1.);
     void setBinContent(int bin, double value);
     double getBinContent(int bin) const;
-    double getMean();
-    double getRMS();
+    double getMean() const;
+    double getRMS() const;
     double getUnderflow() const;
     double getOverflow() const;
-    double getEntries();
+    void setUnderflow(double value);
+    void setOverflow(double value);
+    double getEntries() const;
     void rescale(double center, double width);
     void rescale(double center);
 
+    // change tracking since the last call of clearChanges(), used to transfer only the changed bins
+    // a histogram counts as completely changed after construction, clear() and any change of the binning or unit
+    bool hasChanges() const { return fCompletelyChanged || fFlowChanged || !fChangedBins.empty(); }
+    bool isCompletelyChanged() const { return fCompletelyChanged; }
+    // the bins whose content changed, in the order of their first change; empty if completely changed
+    const std::vector<int>& getChangedBins() const { return fChangedBins; }
+    void clearChanges();
+
     friend QDataStream& operator<<(QDataStream& out, const Histogram& h);
     friend QDataStream& operator>>(QDataStream& in, Histogram& h);
 
@@ -47,6 +57,10 @@ public:
 protected:
     int value2Bin(double value) const;
     double bin2Value(int bin) const;
+    void addToBin(int bin, double value);
+    void updateOccupiedRange(int bin);
+    void markChanged(int bin);
+    void markCompletelyChanged();
 
     std::string fName = "defaultHisto";
     std::string fUnit = "A.U.";
@@ -55,7 +69,18 @@ protected:
     double fMax = 1.0;
     double fOverflow = 0;
     double fUnderflow = 0;
-    std::map<int, double> fHistogramMap;
+    std::vector<double> fBins = std::vector<double>(fNrBins, 0.);
+    // running moments of the in-range contents in units of bin indices,
+    // so they stay valid if min/max are changed without clearing
+    double fContentSum = 0.;
+    double fBinSum = 0.;
+    double fBinSquareSum = 0.;
+    int fLowestOccupiedBin = -1;
+    int fHighestOccupiedBin = -1;
+    std::vector<int> fChangedBins {};
+    std::vector<bool> fBinChanged = std::vector<bool>(fNrBins, false);
+    bool fFlowChanged = false;
+    bool fCompletelyChanged = true;
 };
 
 #endif // HISTOGRAM_H
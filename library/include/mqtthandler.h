@@ -3,15 +3,27 @@
 
 #include "muondetector_shared_global.h"
 #include "config.h"
+#include "mqttjournal.h"
 
+#include <QByteArray>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QTimer>
 #include <QPointer>
+#include <memory>
 #include <string>
 #include <mosquitto.h>
 
 namespace MuonPi {
 
+struct MqttOptions {
+    std::string host { Config::MQTT::host };
+    int port { Config::MQTT::port };
+    int batch_size { Config::MQTT::Batch::max_events };
+    int batch_latency { Config::MQTT::Batch::max_latency };
+    QString journal_file { Config::MQTT::Journal::file };
+};
+
 class MUONDETECTORSHARED MqttHandler : public QObject
 {
     Q_OBJECT
@@ -25,7 +37,7 @@ public:
         Error
     };
 
-    MqttHandler(const QString& station_id, const int verbosity=0);
+    MqttHandler(const QString& station_id, const int verbosity=0, MqttOptions options = {});
     ~MqttHandler() override;
 
     //using QObject::QObject;
@@ -44,6 +56,15 @@ signals:
 
     void giving_up();
 
+    /**
+     * @brief queueStatus State of the outbound data queue
+     * @param batchedEvents events in the batch which is not yet sent
+     * @param journalBatches batches waiting in the journal
+     * @param journalBytes size of the waiting batches
+     * @param replayRate batches per second replayed from the journal since the last status
+     * @param droppedBatches batches lost because the journal was full or not available
+     */
+    void queueStatus(quint32 batchedEvents, quint32 journalBatches, qint64 journalBytes, double replayRate, quint32 droppedBatches);
 
 public slots:
     void start(const QString& username, const QString& password);
@@ -52,6 +73,7 @@ public slots:
     void sendData(const QString &message);
     void sendLog(const QString &message);
     void onRequestConnectionStatus();
+    void onRequestQueueStatus();
 
     void timer_restart(int timeout);
     void timer_start(int timeout);
@@ -59,7 +81,17 @@ public slots:
 
 private:
     [[nodiscard]] auto connected() -> bool;
-    [[nodiscard]] auto publish(const std::string& topic, const std::string& content) -> bool;
+    [[nodiscard]] auto publish(const std::string& topic, const QByteArray& content) -> bool;
+
+    /**
+     * @brief flush_batch Publish the collected events as one newline-delimited message
+     * While the journal holds older batches, new batches are appended to it, so that the order is kept.
+     */
+    void flush_batch();
+    /**
+     * @brief replay_journal Publish a limited number of journaled batches, called periodically while connected
+     */
+    void replay_journal();
 
     void initialise(const std::string& client_id);
 
@@ -109,6 +141,15 @@ private:
     std::string m_log_topic { Config::MQTT::log_topic };
     int m_verbose { 0 };
 
+    MqttOptions m_options {};
+    QByteArray m_batch {};
+    int m_batch_events { 0 };
+    QTimer m_batch_timer { this };
+    std::unique_ptr<MqttJournal> m_journal {};
+    QTimer m_replay_timer { this };
+    quint64 m_replayed_batches { 0 };
+    QElapsedTimer m_replay_rate_timer {};
+
 
     friend void wrapper_callback_connected(mosquitto* mqtt, void* object, int result);
     friend void wrapper_callback_disconnected(mosquitto* mqtt, void* object, int result);
@@ -0,0 +1,68 @@
+#ifndef MQTTJOURNAL_H
+#define MQTTJOURNAL_H
+
+#include "muondetector_shared_global.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <cstddef>
+
+namespace MuonPi {
+
+/**
+ * @brief On-disk queue of mqtt payloads which could not be published
+ * The file starts with a 16 byte header: magic "MUONPIMQ" and the file offset of the oldest unsent record
+ * (uint64, little-endian). It is followed by records of a payload length (uint32, little-endian) and the payload.
+ * Records are appended at the end and consumed in order. The stored offset is updated after each consumed
+ * record, so that a restarted daemon continues the replay where it stopped. Once all records are consumed,
+ * the file is truncated to the header. During a longer replay, the consumed records are removed by writing the
+ * unsent ones to a new file, which replaces the journal atomically, as soon as the consumed part exceeds
+ * Config::MQTT::Journal::compact_size and is larger than the unsent part.
+ */
+class MUONDETECTORSHARED MqttJournal {
+public:
+    MqttJournal(const QString& fileName, qint64 maxSize);
+
+    /**
+     * @brief append Store a payload at the end of the journal
+     * @return false if the journal is not available or full, the payload is counted as dropped
+     */
+    bool append(const QByteArray& payload);
+    /**
+     * @brief front Read the oldest unsent payload
+     * @return false if the journal is empty or the record could not be read
+     */
+    bool front(QByteArray& payload);
+    /**
+     * @brief pop Remove the oldest unsent payload, after it was published
+     */
+    void pop();
+
+    [[nodiscard]] bool isOpen() const { return m_file.isOpen(); }
+    [[nodiscard]] bool empty() const { return m_pendingRecords == 0; }
+    [[nodiscard]] std::size_t pendingRecords() const { return m_pendingRecords; }
+    [[nodiscard]] qint64 pendingBytes() const;
+    [[nodiscard]] std::size_t droppedRecords() const { return m_droppedRecords; }
+
+private:
+    static constexpr qint64 header_size { 16 };
+    static constexpr qint64 length_size { 4 };
+
+    bool open();
+    void reset();
+    bool compact();
+    void writeReadOffset();
+
+    QFile m_file;
+    qint64 m_maxSize { 0 };
+    qint64 m_readOffset { header_size };
+    qint64 m_writeOffset { header_size };
+    std::size_t m_pendingRecords { 0 };
+    std::size_t m_droppedRecords { 0 };
+};
+
+} // namespace MuonPi
+
+#endif // MQTTJOURNAL_H
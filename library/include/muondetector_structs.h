@@ -7,7 +7,9 @@
 #include <QDataStream>
 #include <QList>
 #include <QMap>
+#include <QPair>
 #include <QString>
+#include <QVector>
 #include <iomanip>
 #include <iostream>
 #include <string>
@@ -215,10 +217,11 @@ struct I2cDeviceEntry {
     quint8 address;
     QString name;
     quint8 status;
-    quint32 nrBytesWritten;
-    quint32 nrBytesRead;
-    quint32 nrIoErrors;
-    quint32 lastTransactionTime; // in us
+    quint32 nrBytesWritten = 0;
+    quint32 nrBytesRead = 0;
+    quint32 nrIoErrors = 0;
+    quint32 nrSyscalls = 0;
+    quint32 lastTransactionTime = 0; // in us
 };
 
 struct LogInfoStruct {
@@ -230,6 +233,37 @@ struct LogInfoStruct {
     qint32 logAge;
 };
 
+struct GpioEventStruct {
+    quint64 tick = 0; // pigpio tick in us, extended to 64bit with the tick overflow counter
+    qint64 utc_ns = 0; // system time of the event in ns since the unix epoch, 0 if the gpio clock model is not valid yet
+    quint8 signal = 0; // the GPIO_PIN signal the event was registered on
+};
+
+/**
+ * @brief Incremental update of a histogram
+ * carries only the bins which changed between baseVersion and version,
+ * a receiver which does not hold baseVersion has to request a full histogram
+ */
+struct HistogramDeltaStruct {
+    QString name {};
+    quint32 baseVersion = 0;
+    quint32 version = 0;
+    double underflow = 0.;
+    double overflow = 0.;
+    QVector<QPair<qint32, double>> bins {}; // bin index and new content
+};
+
+/**
+ * @brief State of the outbound queue of a tcp connection, as seen by the sending side
+ */
+struct TcpConnectionStatusStruct {
+    quint32 queuedMessages = 0;
+    quint64 queuedBytes = 0; // including the data already handed to the socket but not yet written
+    quint64 droppedMessages = 0; // low priority messages discarded since the connection was established
+    quint64 droppedBytes = 0;
+    quint64 highWaterMark = 0;
+};
+
 struct OledItem {
     QString name;
     QString displayString;
@@ -344,12 +378,20 @@ inline QDataStream& operator<<(QDataStream& out, const UbxTimePulseStruct& tp)
 
 inline QDataStream& operator>>(QDataStream& in, Histogram& h)
 {
-    h.clear();
     QString name, unit;
-    in >> name >> h.fMin >> h.fMax >> h.fUnderflow >> h.fOverflow >> h.fNrBins;
+    double min, max, underflow, overflow;
+    int nrBins;
+    in >> name >> min >> max >> underflow >> overflow >> nrBins;
+    h.setNrBins(nrBins);
     h.setName(name.toStdString());
+    h.fMin = min;
+    h.fMax = max;
+    h.fUnderflow = underflow;
+    h.fOverflow = overflow;
     for (int i = 0; i < h.fNrBins; i++) {
-        in >> h.fHistogramMap[i];
+        double content;
+        in >> content;
+        h.setBinContent(i, content);
     }
     in >> unit;
     h.setUnit(unit.toStdString());
@@ -426,4 +468,40 @@ inline QDataStream& operator<<(QDataStream& out, const UbxTimeMarkStruct& tm)
     return out;
 }
 
+inline QDataStream& operator>>(QDataStream& in, GpioEventStruct& evt)
+{
+    in >> evt.tick >> evt.utc_ns >> evt.signal;
+    return in;
+}
+
+inline QDataStream& operator<<(QDataStream& out, const GpioEventStruct& evt)
+{
+    out << evt.tick << evt.utc_ns << evt.signal;
+    return out;
+}
+
+inline QDataStream& operator>>(QDataStream& in, HistogramDeltaStruct& delta)
+{
+    in >> delta.name >> delta.baseVersion >> delta.version >> delta.underflow >> delta.overflow >> delta.bins;
+    return in;
+}
+
+inline QDataStream& operator<<(QDataStream& out, const HistogramDeltaStruct& delta)
+{
+    out << delta.name << delta.baseVersion << delta.version << delta.underflow << delta.overflow << delta.bins;
+    return out;
+}
+
+inline QDataStream& operator>>(QDataStream& in, TcpConnectionStatusStruct& status)
+{
+    in >> status.queuedMessages >> status.queuedBytes >> status.droppedMessages >> status.droppedBytes >> status.highWaterMark;
+    return in;
+}
+
+inline QDataStream& operator<<(QDataStream& out, const TcpConnectionStatusStruct& status)
+{
+    out << status.queuedMessages << status.queuedBytes << status.droppedMessages << status.droppedBytes << status.highWaterMark;
+    return out;
+}
+
 #endif // MUONDETECTOR_STRUCTS_H
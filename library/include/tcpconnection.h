@@ -4,10 +4,12 @@
 #include "muondetector_shared_global.h"
 #include "tcpmessage.h"
 
+#include <QElapsedTimer>
 #include <QFile>
 #include <QPointer>
 #include <QTcpSocket>
 #include <QTimer>
+#include <deque>
 #include <time.h>
 #include <vector>
 
@@ -20,13 +22,17 @@ public:
     TcpConnection(int socketDescriptor, int verbose = 0, int timeout = 15000,
         int pingInterval = 5000, QObject* parent = 0);
     ~TcpConnection();
-    void delay(int millisecondsWait);
     const QString& getPeerAddress() const { return peerAddress; }
     quint16 getPeerPort() const { return peerPort; }
     QTcpSocket* getTcpSocket() { return tcpSocket; }
     uint32_t getNrBytesRead() const { return bytesRead; }
     uint32_t getNrBytesWritten() const { return bytesWritten; }
     time_t firstConnectionTime() const { return firstConnection; }
+    /**
+     * @brief isLowPriority Messages which may be dropped when the peer does not keep up
+     * These are either superseded by later messages (histograms, adc traces) or only used for indicators (gpio events).
+     */
+    static bool isLowPriority(quint16 msgID);
 
 signals:
     void madeConnection(QString remotePeerAddress, quint16 remotePeerPort, QString localAddress, quint16 localPort);
@@ -46,15 +52,35 @@ public slots:
     void onReadyRead();
     bool sendTcpMessage(TcpMessage tcpMessage);
 
+private slots:
+    void onBytesWritten(qint64 bytes);
+    void onStatusTimer();
+    void finishClose();
+
 private:
-    bool writeBlock(const QByteArray& block);
+    struct OutboundFrame {
+        QByteArray header; // the length field
+        QByteArray data; // msgID and payload, shared with the TcpMessage
+        [[nodiscard]] qint64 size() const { return header.size() + data.size(); }
+    };
+    /**
+     * @brief writeFrame Queue a frame for sending, never blocks
+     * The frame is handed to the socket as long as its write buffer is below Config::Tcp::socket_buffer_size,
+     * otherwise it waits in the outbound queue until the socket reports written bytes.
+     * @param lowPriority if set, the frame is dropped when the backlog exceeds Config::Tcp::high_water_mark
+     * @return false if the frame was dropped or the connection is not usable
+     */
+    bool writeFrame(OutboundFrame frame, bool lowPriority = false);
+    void drainWriteQueue();
+    void startStatusTimer(bool reportStatus);
+    qint64 backlog() const;
+    bool checkWriteStall();
     int timeout;
     int verbose;
     int pingInterval;
     int m_socketDescriptor;
-    quint16 blockSize = 0;
+    quint32 m_frameSize { 0 }; // size of the frame being received, 0 while waiting for the length field
     QString peerAddress, localAddress;
-    QDataStream* in = nullptr;
     QTcpSocket* tcpSocket = nullptr;
     QString hostName;
     quint16 port;
@@ -64,5 +90,14 @@ private:
     time_t lastConnection;
     time_t firstConnection;
     uint32_t bytesRead = 0, bytesWritten = 0;
+    std::deque<OutboundFrame> m_writeQueue {};
+    qint64 m_queuedBytes { 0 };
+    quint64 m_droppedMessages { 0 };
+    quint64 m_droppedBytes { 0 };
+    QElapsedTimer m_writeProgress {};
+    QPointer<QTimer> m_statusTimer {};
+    bool m_reportStatus { false };
+    bool m_closing { false }; // the quit message was queued, no further messages are accepted
+    bool m_closed { false };
 };
 #endif // TCPCONNECTION_H
@@ -6,33 +6,55 @@
 #include <QByteArray>
 #include <QDataStream>
 
+#include <optional>
+
 enum class TCP_MSG_KEY : quint16;
 
-// how is a message coded in TcpMessage?
-// in the data QByteArray:
-// at pos 0: length of message (quint16) -> length of QByteArray - length of this number (sizeof(quint16))
-// at pos 1: tcpMsgID (quint16), shows what kind of message it is
+// how is a message coded on the wire?
+// length of the frame (quint16), the number of bytes following the length field
+// if the length equals TcpMessage::extended_length, the real length follows as quint32
+// tcpMsgID (quint16), shows what kind of message it is
+// payload, written with QDataStream
+//
+// the data QByteArray of a TcpMessage holds the frame without the length field (msgID and payload),
+// the length is only prepended when the message is written to the socket.
 
 class MUONDETECTORSHARED TcpMessage {
 public:
+    static constexpr int header_size { sizeof(quint16) }; // the msgID at the start of the data
+    static constexpr quint16 extended_length { 0xffff };
+
     TcpMessage(quint16 tcpMsgID = 0);
     TcpMessage(TCP_MSG_KEY tcpMsgID);
-    TcpMessage(QByteArray& rawdata);
-    TcpMessage(const TcpMessage& tcpMessage);
+    /**
+     * @brief TcpMessage Wrap a received frame (msgID and payload), the data is shared, not copied
+     */
+    explicit TcpMessage(const QByteArray& frame);
+    TcpMessage(const TcpMessage& other);
+    TcpMessage(TcpMessage&& other) noexcept;
+    TcpMessage& operator=(const TcpMessage& other);
+    TcpMessage& operator=(TcpMessage&& other) noexcept;
     ~TcpMessage();
 
-    void setMsgID(quint16 tcpMsgID);
-    void setData(QByteArray& data);
+    /**
+     * @brief stream Access the payload
+     * The stream is created on first use, so copying a message (e.g. on each queued signal) is only a
+     * reference count increment of the data. It starts after the msgID for received messages and at the
+     * end of the data for messages being composed. The stream position is not carried over to copies.
+     */
+    QDataStream& stream();
     const QByteArray& getData() const;
     quint16 getMsgID() const;
-    quint16 getByteCount() const;
-
-    QDataStream* dStream = nullptr;
+    /**
+     * @brief frameHeader The length field to send in front of getData()
+     */
+    QByteArray frameHeader() const;
 
 private:
     QByteArray m_data {};
     quint16 m_msgID {};
-    quint16 m_byteCount {};
+    bool m_received { false };
+    std::optional<QDataStream> m_stream {};
 };
 
 #endif // TCPMESSAGE_H
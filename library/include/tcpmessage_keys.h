@@ -76,7 +76,47 @@ enum class TCP_MSG_KEY : quint16 { MSG_PING = 2,
     MSG_UBX_TIMEMARK = 349,
     MSG_POLARITY_SWITCH = 353,
     MSG_POLARITY_SWITCH_REQUEST = 359,
-    MSG_MQTT_INHIBIT = 367
+    MSG_MQTT_INHIBIT = 367,
+    MSG_GPIO_EVENT_BATCH = 373,
+    MSG_HISTOGRAM_DELTA = 379,
+    MSG_HISTOGRAM_REQUEST = 383,
+    MSG_CONNECTION_STATUS = 389,
+    MSG_SUBSCRIPTION = 397
 };
 
+/**
+ * @brief Subscription groups of the high volume messages sent by the daemon
+ * A client receives the messages of a group only after subscribing to it with MSG_SUBSCRIPTION (quint32 group mask).
+ * Clients which never send a subscription receive all groups. Messages outside of these groups are always sent.
+ */
+namespace TcpMessageGroup {
+enum : quint32 {
+    NONE = 0x00,
+    GPIO_EVENTS = 0x01,
+    ADC = 0x02,
+    HISTOGRAMS = 0x04,
+    TIMEMARKS = 0x08,
+    ALL = 0xffffffff
+};
+
+inline quint32 of(quint16 msgID)
+{
+    switch (static_cast<TCP_MSG_KEY>(msgID)) {
+    case TCP_MSG_KEY::MSG_GPIO_EVENT:
+    case TCP_MSG_KEY::MSG_GPIO_EVENT_BATCH:
+        return GPIO_EVENTS;
+    case TCP_MSG_KEY::MSG_ADC_SAMPLE:
+    case TCP_MSG_KEY::MSG_ADC_TRACE:
+        return ADC;
+    case TCP_MSG_KEY::MSG_HISTOGRAM:
+    case TCP_MSG_KEY::MSG_HISTOGRAM_DELTA:
+        return HISTOGRAMS;
+    case TCP_MSG_KEY::MSG_UBX_TIMEMARK:
+        return TIMEMARKS;
+    default:
+        return NONE;
+    }
+}
+} // namespace TcpMessageGroup
+
 #endif // TCPMESSAGE_KEYS_H
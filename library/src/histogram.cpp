@@ -1,6 +1,6 @@
 //#include <QDataStream>
+#include <algorithm>
 #include <cmath>
-#include <map>
 #include <string>
 
 #include "histogram.h"
@@ -10,18 +10,25 @@ Histogram::Histogram(const std::string& name, int nrBins, double min, double max
     , fNrBins(nrBins)
     , fMin(min)
     , fMax(max)
+    , fBins(std::max(nrBins, 0), 0.)
+    , fBinChanged(std::max(nrBins, 0), false)
 {
 }
 
 Histogram::~Histogram()
 {
-    fHistogramMap.clear();
 }
 
+// bins with less content are treated as empty when determining the occupied range
+static constexpr double occupancyThreshold { 1e-3 };
+
 void Histogram::clear()
 {
-    fHistogramMap.clear();
+    std::fill(fBins.begin(), fBins.end(), 0.);
     fUnderflow = fOverflow = 0.;
+    fContentSum = fBinSum = fBinSquareSum = 0.;
+    fLowestOccupiedBin = fHighestOccupiedBin = -1;
+    markCompletelyChanged();
 }
 
 void Histogram::setName(const std::string& name)
@@ -31,12 +38,17 @@ void Histogram::setName(const std::string& name)
 
 void Histogram::setUnit(const std::string& unit)
 {
+    if (unit != fUnit)
+        markCompletelyChanged();
     fUnit = unit;
 }
 
 void Histogram::setNrBins(int bins)
 {
     fNrBins = bins;
+    fBins.assign(std::max(bins, 0), 0.);
+    fChangedBins.clear();
+    fBinChanged.assign(fBins.size(), false);
     clear();
 }
 
@@ -47,6 +59,8 @@ int Histogram::getNrBins() const
 
 void Histogram::setMin(double val)
 {
+    if (val != fMin)
+        markCompletelyChanged();
     fMin = val;
 }
 
@@ -57,6 +71,8 @@ double Histogram::getMin() const
 
 void Histogram::setMax(double val)
 {
+    if (val != fMax)
+        markCompletelyChanged();
     fMax = val;
 }
 
@@ -82,26 +98,12 @@ double Histogram::getBinCenter(int bin) const
 
 int Histogram::getLowestOccupiedBin() const
 {
-    if (fHistogramMap.empty())
-        return -1;
-    auto it = fHistogramMap.begin();
-    while (it != fHistogramMap.end() && it->second < 1e-3)
-        ++it;
-    if (it == fHistogramMap.end())
-        return -1;
-    return it->first;
+    return fLowestOccupiedBin;
 }
 
 int Histogram::getHighestOccupiedBin() const
 {
-    if (fHistogramMap.empty())
-        return -1;
-    auto it = --fHistogramMap.end();
-    while (it != fHistogramMap.begin() && it->second < 1e-3)
-        --it;
-    if (it == fHistogramMap.begin())
-        return 0;
-    return it->first;
+    return fHighestOccupiedBin;
 }
 
 void Histogram::fill(double x, double mult)
@@ -109,59 +111,43 @@ void Histogram::fill(double x, double mult)
     int bin = value2Bin(x);
     if (bin < 0) {
         fUnderflow += mult;
+        fFlowChanged = true;
     } else if (bin >= fNrBins) {
         fOverflow += mult;
+        fFlowChanged = true;
     } else
-        fHistogramMap[bin] += mult;
+        addToBin(bin, mult);
 }
 
 void Histogram::setBinContent(int bin, double value)
 {
     if (bin >= 0 && bin < fNrBins)
-        fHistogramMap[bin] = value;
+        addToBin(bin, value - fBins[bin]);
 }
 
 double Histogram::getBinContent(int bin) const
 {
-    if (bin >= 0 && bin < fNrBins) {
-        try {
-            auto it = fHistogramMap.find(bin);
-            if (it != fHistogramMap.end())
-                return fHistogramMap.at(bin);
-            else
-                return double();
-        } catch (...) {
-            return double();
-        }
-    } else
+    if (bin >= 0 && bin < fNrBins)
+        return fBins[bin];
+    else
         return double();
 }
 
-double Histogram::getMean()
+double Histogram::getMean() const
 {
-    double sum = 0., entries = 0.;
-    for (const auto& entry : fHistogramMap) {
-        entries += entry.second;
-        sum += bin2Value(entry.first) * entry.second;
-    }
-    if (entries > 0.)
-        return sum / entries;
+    if (fContentSum > 0.)
+        return bin2Value(0) + (bin2Value(1) - bin2Value(0)) * fBinSum / fContentSum;
     else
         return 0.;
 }
 
-double Histogram::getRMS()
+double Histogram::getRMS() const
 {
-    double mean = getMean();
-    double sum = 0., entries = 0.;
-    for (const auto& entry : fHistogramMap) {
-        entries += entry.second;
-        double dx = bin2Value(entry.first) - mean;
-        sum += dx * dx * entry.second;
-    }
-    if (entries > 1.)
-        return sqrt(sum / (entries - 1.));
-    else
+    if (fContentSum > 1.) {
+        const double binWidth = bin2Value(1) - bin2Value(0);
+        const double variance = (fBinSquareSum - fBinSum * fBinSum / fContentSum) / (fContentSum - 1.);
+        return std::fabs(binWidth) * std::sqrt(std::max(variance, 0.));
+    } else
         return 0.;
 }
 
@@ -175,13 +161,79 @@ double Histogram::getOverflow() const
     return fOverflow;
 }
 
-double Histogram::getEntries()
+void Histogram::setUnderflow(double value)
+{
+    fUnderflow = value;
+    fFlowChanged = true;
+}
+
+void Histogram::setOverflow(double value)
+{
+    fOverflow = value;
+    fFlowChanged = true;
+}
+
+double Histogram::getEntries() const
 {
-    double sum = fUnderflow + fOverflow;
-    for (const auto& entry : fHistogramMap) {
-        sum += entry.second;
+    return fUnderflow + fOverflow + fContentSum;
+}
+
+void Histogram::addToBin(int bin, double value)
+{
+    fBins[bin] += value;
+    fContentSum += value;
+    fBinSum += value * bin;
+    fBinSquareSum += value * bin * bin;
+    updateOccupiedRange(bin);
+    markChanged(bin);
+}
+
+void Histogram::markChanged(int bin)
+{
+    if (fCompletelyChanged || fBinChanged[bin])
+        return;
+    fBinChanged[bin] = true;
+    fChangedBins.push_back(bin);
+}
+
+void Histogram::markCompletelyChanged()
+{
+    if (fCompletelyChanged)
+        return;
+    for (int bin : fChangedBins)
+        fBinChanged[bin] = false;
+    fChangedBins.clear();
+    fCompletelyChanged = true;
+}
+
+void Histogram::clearChanges()
+{
+    for (int bin : fChangedBins)
+        fBinChanged[bin] = false;
+    fChangedBins.clear();
+    fFlowChanged = false;
+    fCompletelyChanged = false;
+}
+
+void Histogram::updateOccupiedRange(int bin)
+{
+    if (fBins[bin] >= occupancyThreshold) {
+        if (fLowestOccupiedBin < 0 || bin < fLowestOccupiedBin)
+            fLowestOccupiedBin = bin;
+        if (bin > fHighestOccupiedBin)
+            fHighestOccupiedBin = bin;
+        return;
+    }
+    // a bin at the border of the occupied range was emptied, search for the new borders
+    if (bin == fLowestOccupiedBin) {
+        while (fLowestOccupiedBin <= fHighestOccupiedBin && fBins[fLowestOccupiedBin] < occupancyThreshold)
+            fLowestOccupiedBin++;
+        if (fLowestOccupiedBin > fHighestOccupiedBin)
+            fLowestOccupiedBin = fHighestOccupiedBin = -1;
+    } else if (bin == fHighestOccupiedBin) {
+        while (fHighestOccupiedBin >= fLowestOccupiedBin && fBins[fHighestOccupiedBin] < occupancyThreshold)
+            fHighestOccupiedBin--;
     }
-    return sum;
 }
 
 int Histogram::value2Bin(double value) const
@@ -93,17 +93,29 @@ void MqttHandler::set_status(Status status)
     m_status = status;
 }
 
-MqttHandler::MqttHandler(const QString& station_id, const int verbosity)
+MqttHandler::MqttHandler(const QString& station_id, const int verbosity, MqttOptions options)
     : m_station_id { station_id.toStdString() }
     , m_verbose { verbosity }
+    , m_options { std::move(options) }
+    , m_journal { std::make_unique<MqttJournal>(m_options.journal_file, Config::MQTT::Journal::max_size) }
 {
     m_reconnect_timer.setInterval(Config::MQTT::timeout);
     connect(&m_reconnect_timer, &QTimer::timeout, this, [this](){mqttConnect();});
+
+    m_options.batch_size = std::max(m_options.batch_size, 1);
+    // reserving marks the capacity as fixed, so it survives the resize(0) after each batch
+    m_batch.reserve(m_options.batch_size * 128);
+    m_batch_timer.setSingleShot(true);
+    connect(&m_batch_timer, &QTimer::timeout, this, [this](){flush_batch();});
+    m_replay_timer.setInterval(Config::MQTT::Journal::replay_interval);
+    connect(&m_replay_timer, &QTimer::timeout, this, [this](){replay_journal();});
 }
 
 
 MqttHandler::~MqttHandler()
 {
+    // a pending batch goes to the journal, if it can not be sent any more
+    flush_batch();
     mqttDisconnect();
     cleanup();
 }
@@ -135,6 +147,10 @@ void MqttHandler::start(const QString& username, const QString& password){
 
 
     mqttConnect();
+
+    if (!m_journal->empty()) {
+        m_replay_timer.start();
+    }
 }
 
 void MqttHandler::mqttConnect(){
@@ -161,7 +177,7 @@ void MqttHandler::mqttConnect(){
         qWarning() << "Error when setting username and password: " + QString{ strerror(result) };
         return;
     }
-    result = mosquitto_connect(m_mqtt, Config::MQTT::host, Config::MQTT::port, 60);
+    result = mosquitto_connect(m_mqtt, m_options.host.c_str(), m_options.port, 60);
     if (result == MOSQ_ERR_SUCCESS) {
         return;
     }
@@ -285,22 +301,68 @@ void MqttHandler::unsubscribe(const QString& topic)
 }
 
 void MqttHandler::sendData(const QString &message){
-    if (!publish(m_data_topic, message.toStdString())) {
-        qWarning() << "Couldn't publish data";
+    if (m_batch_events > 0) {
+        m_batch.append('\n');
+    }
+    m_batch.append(message.toUtf8());
+    m_batch_events++;
+    if (m_batch_events >= m_options.batch_size) {
+        flush_batch();
+        return;
+    }
+    if (!m_batch_timer.isActive()) {
+        m_batch_timer.start(m_options.batch_latency);
+    }
+}
+
+void MqttHandler::flush_batch(){
+    m_batch_timer.stop();
+    if (m_batch_events == 0) {
+        return;
+    }
+    if (!m_journal->empty() || !publish(m_data_topic, m_batch)) {
+        if (m_journal->append(m_batch)) {
+            if (!m_replay_timer.isActive()) {
+                m_replay_timer.start();
+            }
+        } else {
+            qWarning() << "Couldn't publish data, dropped" << m_batch_events << "events";
+        }
+    }
+    // resize keeps the allocated capacity for the next batch
+    m_batch.resize(0);
+    m_batch_events = 0;
+}
+
+void MqttHandler::replay_journal(){
+    if (m_journal->empty()) {
+        m_replay_timer.stop();
+        return;
+    }
+    if (!connected()) {
+        return;
+    }
+    QByteArray payload {};
+    for (int i = 0; i < Config::MQTT::Journal::replay_batches && m_journal->front(payload); i++) {
+        if (!publish(m_data_topic, payload)) {
+            return;
+        }
+        m_journal->pop();
+        m_replayed_batches++;
     }
 }
 
 void MqttHandler::sendLog(const QString &message){
-    if (!publish(m_log_topic, message.toStdString())) {
+    if (!publish(m_log_topic, message.toUtf8())) {
         qWarning() << "Couldn't publish log";
     }
 }
 
-auto MqttHandler::publish(const std::string& topic, const std::string& content) -> bool {
+auto MqttHandler::publish(const std::string& topic, const QByteArray& content) -> bool {
     if (!connected()) {
         return false;
     }
-    auto result { mosquitto_publish(m_mqtt, nullptr, topic.c_str(), static_cast<int>(content.size()), reinterpret_cast<const void*>(content.c_str()), 1, false) };
+    auto result { mosquitto_publish(m_mqtt, nullptr, topic.c_str(), content.size(), reinterpret_cast<const void*>(content.constData()), 1, false) };
 
     if (result == MOSQ_ERR_SUCCESS) {
         return true;
@@ -312,4 +374,19 @@ auto MqttHandler::publish(const std::string& topic, const std::string& content)
 void MqttHandler::onRequestConnectionStatus(){
     emit mqttConnectionStatus(m_status == Status::Connected);
 }
+
+void MqttHandler::onRequestQueueStatus(){
+    double replayRate { 0. };
+    if (m_replay_rate_timer.isValid()) {
+        const qint64 elapsed { m_replay_rate_timer.restart() };
+        if (elapsed > 0) {
+            replayRate = 1000. * m_replayed_batches / elapsed;
+        }
+    } else {
+        m_replay_rate_timer.start();
+    }
+    m_replayed_batches = 0;
+    emit queueStatus(static_cast<quint32>(m_batch_events), static_cast<quint32>(m_journal->pendingRecords()),
+        m_journal->pendingBytes(), replayRate, static_cast<quint32>(m_journal->droppedRecords()));
+}
 } // namespace MuonPi
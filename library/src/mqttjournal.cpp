@@ -0,0 +1,203 @@
+#include "mqttjournal.h"
+#include "config.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+namespace MuonPi {
+
+static constexpr char journal_magic[8] { 'M', 'U', 'O', 'N', 'P', 'I', 'M', 'Q' };
+
+MqttJournal::MqttJournal(const QString& fileName, qint64 maxSize)
+    : m_file { fileName }
+    , m_maxSize { maxSize }
+{
+    open();
+}
+
+bool MqttJournal::open()
+{
+    QDir().mkpath(QFileInfo(m_file.fileName()).absolutePath());
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "could not open mqtt journal" << m_file.fileName() << ":" << m_file.errorString();
+        return false;
+    }
+    char header[header_size];
+    if (m_file.size() < header_size || m_file.read(header, header_size) != header_size
+        || std::memcmp(header, journal_magic, sizeof(journal_magic)) != 0) {
+        reset();
+        return true;
+    }
+    const qint64 fileSize { m_file.size() };
+    m_readOffset = static_cast<qint64>(qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(header + sizeof(journal_magic))));
+    if (m_readOffset < header_size || m_readOffset > fileSize) {
+        reset();
+        return true;
+    }
+    // count the unsent records, a record cut off during an append (power loss) is discarded
+    qint64 offset { m_readOffset };
+    char length[length_size];
+    while (offset + length_size <= fileSize) {
+        m_file.seek(offset);
+        if (m_file.read(length, length_size) != length_size) {
+            break;
+        }
+        const qint64 next { offset + length_size + qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(length)) };
+        if (next > fileSize) {
+            break;
+        }
+        offset = next;
+        m_pendingRecords++;
+    }
+    if (m_pendingRecords == 0) {
+        reset();
+        return true;
+    }
+    if (offset != fileSize) {
+        m_file.resize(offset);
+    }
+    m_writeOffset = offset;
+    qInfo() << "mqtt journal contains" << m_pendingRecords << "unsent messages";
+    return true;
+}
+
+void MqttJournal::reset()
+{
+    m_file.resize(0);
+    m_file.seek(0);
+    m_file.write(journal_magic, sizeof(journal_magic));
+    m_readOffset = header_size;
+    m_writeOffset = header_size;
+    m_pendingRecords = 0;
+    writeReadOffset();
+}
+
+void MqttJournal::writeReadOffset()
+{
+    char offset[sizeof(quint64)];
+    qToLittleEndian(static_cast<quint64>(m_readOffset), reinterpret_cast<uchar*>(offset));
+    m_file.seek(sizeof(journal_magic));
+    m_file.write(offset, sizeof(offset));
+    m_file.flush();
+}
+
+bool MqttJournal::compact()
+{
+    QSaveFile compacted { m_file.fileName() };
+    if (!compacted.open(QIODevice::WriteOnly)) {
+        qWarning() << "could not compact mqtt journal:" << compacted.errorString();
+        return false;
+    }
+    char header[header_size];
+    std::memcpy(header, journal_magic, sizeof(journal_magic));
+    qToLittleEndian(static_cast<quint64>(header_size), reinterpret_cast<uchar*>(header + sizeof(journal_magic)));
+    compacted.write(header, header_size);
+    m_file.seek(m_readOffset);
+    qint64 remaining { pendingBytes() };
+    while (remaining > 0) {
+        const QByteArray chunk { m_file.read(std::min<qint64>(remaining, 65536)) };
+        if (chunk.isEmpty() || compacted.write(chunk) != chunk.size()) {
+            qWarning() << "could not compact mqtt journal:" << compacted.errorString();
+            compacted.cancelWriting();
+            return false;
+        }
+        remaining -= chunk.size();
+    }
+    // the new file replaces the journal only if it was written completely
+    if (!compacted.commit()) {
+        qWarning() << "could not compact mqtt journal:" << compacted.errorString();
+        return false;
+    }
+    m_file.close();
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "could not reopen mqtt journal" << m_file.fileName() << ":" << m_file.errorString();
+        return false;
+    }
+    m_writeOffset = header_size + pendingBytes();
+    m_readOffset = header_size;
+    return true;
+}
+
+bool MqttJournal::append(const QByteArray& payload)
+{
+    if (isOpen() && m_writeOffset + length_size + payload.size() > m_maxSize && m_readOffset > header_size) {
+        compact();
+    }
+    if (!isOpen() || m_writeOffset + length_size + payload.size() > m_maxSize) {
+        m_droppedRecords++;
+        return false;
+    }
+    char length[length_size];
+    qToLittleEndian(static_cast<quint32>(payload.size()), reinterpret_cast<uchar*>(length));
+    m_file.seek(m_writeOffset);
+    if (m_file.write(length, length_size) != length_size || m_file.write(payload) != payload.size()) {
+        qWarning() << "could not write to mqtt journal:" << m_file.errorString();
+        // drop the partial record, it would be discarded on the next start anyway
+        m_file.resize(m_writeOffset);
+        m_droppedRecords++;
+        return false;
+    }
+    m_file.flush();
+    m_writeOffset += length_size + payload.size();
+    m_pendingRecords++;
+    return true;
+}
+
+bool MqttJournal::front(QByteArray& payload)
+{
+    if (empty() || !isOpen()) {
+        return false;
+    }
+    char length[length_size];
+    m_file.seek(m_readOffset);
+    if (m_file.read(length, length_size) != length_size) {
+        qWarning() << "could not read from mqtt journal:" << m_file.errorString() << ", discarding it";
+        reset();
+        return false;
+    }
+    const qint64 size { qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(length)) };
+    payload = m_file.read(size);
+    if (payload.size() != size) {
+        qWarning() << "could not read from mqtt journal:" << m_file.errorString() << ", discarding it";
+        reset();
+        return false;
+    }
+    return true;
+}
+
+void MqttJournal::pop()
+{
+    if (empty() || !isOpen()) {
+        return;
+    }
+    char length[length_size];
+    m_file.seek(m_readOffset);
+    if (m_file.read(length, length_size) != length_size) {
+        reset();
+        return;
+    }
+    m_readOffset += length_size + qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(length));
+    m_pendingRecords--;
+    if (m_pendingRecords == 0) {
+        reset();
+        return;
+    }
+    const qint64 consumed { m_readOffset - header_size };
+    if (consumed > Config::MQTT::Journal::compact_size && consumed > pendingBytes() && compact()) {
+        return;
+    }
+    writeReadOffset();
+}
+
+qint64 MqttJournal::pendingBytes() const
+{
+    return m_writeOffset - m_readOffset;
+}
+
+} // namespace MuonPi
@@ -1,8 +1,10 @@
 #include "tcpconnection.h"
+#include "config.h"
+#include "muondetector_structs.h"
 #include "tcpmessage_keys.h"
 
-#include <QDataStream>
 #include <QThread>
+#include <QtEndian>
 #include <QtNetwork>
 #include <iostream>
 #if defined(Q_OS_UNIX)
@@ -32,10 +34,6 @@ TcpConnection::TcpConnection(int socketDescriptor, int newVerbose, int newTimeou
 
 TcpConnection::~TcpConnection()
 {
-    if (in != nullptr) {
-        delete in;
-        in = nullptr;
-    }
     if (!t.isNull()) {
         t.clear();
     }
@@ -51,16 +49,13 @@ void TcpConnection::makeConnection()
     }
 #endif
     tcpSocket = new QTcpSocket(this);
-    in = new QDataStream();
-    in->setVersion(QDataStream::Qt_4_0);
-    in->setDevice(tcpSocket);
     connect(tcpSocket, &QTcpSocket::readyRead, this, &TcpConnection::onReadyRead);
     tcpSocket->connectToHost(hostName, port);
     firstConnection = time(NULL);
     lastConnection = firstConnection;
     if (!tcpSocket->waitForConnected(timeout)) {
         emit error(tcpSocket->error(), tcpSocket->errorString());
-        this->thread()->quit();
+        finishClose();
         return;
     }
     emit connected();
@@ -77,6 +72,8 @@ void TcpConnection::makeConnection()
     peerPort = tcpSocket->peerPort();
     localPort = tcpSocket->localPort();
     bytesRead = bytesWritten = 0;
+    connect(tcpSocket, &QTcpSocket::bytesWritten, this, &TcpConnection::onBytesWritten);
+    startStatusTimer(false);
 }
 
 void TcpConnection::receiveConnection()
@@ -90,7 +87,7 @@ void TcpConnection::receiveConnection()
     tcpSocket = new QTcpSocket(this);
     if (!tcpSocket->setSocketDescriptor(m_socketDescriptor)) {
         emit error(tcpSocket->error(), tcpSocket->errorString());
-        this->thread()->quit();
+        finishClose();
         return;
     }
     peerAddress = tcpSocket->peerAddress().toString();
@@ -105,14 +102,14 @@ void TcpConnection::receiveConnection()
     peerPort = tcpSocket->peerPort();
     localPort = tcpSocket->localPort();
     lastConnection = time(NULL);
-    in = new QDataStream();
-    in->setVersion(QDataStream::Qt_4_0);
-    in->setDevice(tcpSocket);
     connect(tcpSocket, &QTcpSocket::readyRead, this, &TcpConnection::onReadyRead);
     firstConnection = time(NULL);
     lastConnection = firstConnection;
     emit madeConnection(peerAddress, peerPort, localAddress, localPort);
     bytesRead = bytesWritten = 0;
+    connect(tcpSocket, &QTcpSocket::bytesWritten, this, &TcpConnection::onBytesWritten);
+    // only the accepting side (the daemon) reports its queue state to the peer
+    startStatusTimer(true);
 }
 
 void TcpConnection::closeConnection(QString closedAddress)
@@ -126,99 +123,213 @@ void TcpConnection::closeConnection(QString closedAddress)
 
 void TcpConnection::closeThisConnection()
 {
+    if (m_closing || m_closed) {
+        return;
+    }
+    if (!tcpSocket || tcpSocket->state() != QTcpSocket::ConnectedState) {
+        finishClose();
+        return;
+    }
     TcpMessage quitMessage(TCP_MSG_KEY::MSG_QUIT_CONNECTION);
-    *(quitMessage.dStream) << localAddress;
+    quitMessage.stream() << localAddress;
     sendTcpMessage(quitMessage);
+    m_closing = true;
+    // the connection is finished once the queued data including the quit message was written and the socket closed,
+    // or after the close timeout if the peer does not take the data
+    connect(tcpSocket, &QTcpSocket::disconnected, this, &TcpConnection::finishClose);
+    QTimer::singleShot(MuonPi::Config::Tcp::close_timeout, this, &TcpConnection::finishClose);
+    if (m_writeQueue.empty()) {
+        tcpSocket->disconnectFromHost();
+    }
+}
+
+void TcpConnection::finishClose()
+{
+    if (m_closed) {
+        return;
+    }
+    m_closed = true;
+    if (tcpSocket && tcpSocket->state() != QTcpSocket::UnconnectedState) {
+        tcpSocket->abort();
+    }
+    m_writeQueue.clear();
+    m_queuedBytes = 0;
     emit finished();
-    return;
 }
 
 void TcpConnection::onReadyRead()
 {
     // this function gets called when tcpSocket emits readyRead signal
-    if (!in) {
-        emit toConsole("input stream not yet initialized");
+    if (!tcpSocket) {
         return;
     }
-    while (tcpSocket->bytesAvailable() != 0) {
-        if (blockSize == 0) {
-            if (tcpSocket->bytesAvailable() < (int)(sizeof(quint16))) {
+    for (;;) {
+        if (m_frameSize == 0) {
+            // the length field is only consumed once it is complete
+            char header[sizeof(quint16) + sizeof(quint32)];
+            const qint64 available { tcpSocket->bytesAvailable() };
+            qint64 headerSize { sizeof(quint16) };
+            if (available < headerSize) {
+                return;
+            }
+            tcpSocket->peek(header, headerSize);
+            quint32 frameSize { qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(header)) };
+            if (frameSize == TcpMessage::extended_length) {
+                headerSize += sizeof(quint32);
+                if (available < headerSize) {
+                    return;
+                }
+                tcpSocket->peek(header, headerSize);
+                frameSize = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(header + sizeof(quint16)));
+            }
+            if (frameSize < static_cast<quint32>(TcpMessage::header_size) || frameSize > MuonPi::Config::Tcp::max_frame_size) {
+                emit toConsole(QString("invalid tcp frame size %1 from %2, closing connection").arg(frameSize).arg(peerAddress));
+                finishClose();
                 return;
             }
-            *in >> blockSize;
+            tcpSocket->read(header, headerSize);
+            m_frameSize = frameSize;
         }
-        if (tcpSocket->bytesAvailable() < blockSize) {
+        if (tcpSocket->bytesAvailable() < m_frameSize) {
             return;
         }
-        QByteArray block;
-        char* data;
-        data = (char*)malloc(blockSize);
-        if (data == NULL) {
-            qDebug() << "critical error: memory allocation of " << blockSize << " bytes failed. Memory full?";
-            exit(1);
-        }
-        in->readRawData(data, blockSize);
-        QDataStream str(&block, QIODevice::ReadWrite);
-        str << blockSize;
-        str.writeRawData(data, blockSize);
-        bytesRead += blockSize;
-        blockSize = 0;
+        // the frame is copied once out of the socket buffer and then shared by all copies of the message
+        const QByteArray frame { tcpSocket->read(m_frameSize) };
+        bytesRead += m_frameSize;
+        m_frameSize = 0;
         if (verbose > 4) {
-            qDebug() << block;
+            qDebug() << frame;
         }
-
-        TcpMessage tcpMessage(block);
-        emit receivedTcpMessage(tcpMessage);
+        emit receivedTcpMessage(TcpMessage { frame });
     }
 }
 
 bool TcpConnection::sendTcpMessage(TcpMessage tcpMessage)
 {
-    QByteArray block;
-    block = tcpMessage.getData();
-    QDataStream stream(&block, QIODevice::ReadWrite);
-    stream.device()->seek(0);
-    stream << (quint16)(block.size() - (int)sizeof(quint16)); // size of payload
     if (verbose > 4) {
-        qDebug() << block;
+        qDebug() << tcpMessage.getData();
     }
-    return writeBlock(block);
+    return writeFrame(OutboundFrame { tcpMessage.frameHeader(), tcpMessage.getData() }, isLowPriority(tcpMessage.getMsgID()));
+}
+
+bool TcpConnection::isLowPriority(quint16 msgID)
+{
+    // the high volume streams a client can subscribe to
+    return TcpMessageGroup::of(msgID) != TcpMessageGroup::NONE;
 }
 
-bool TcpConnection::writeBlock(const QByteArray& block)
+qint64 TcpConnection::backlog() const
 {
+    return m_queuedBytes + ((tcpSocket) ? tcpSocket->bytesToWrite() : 0);
+}
+
+bool TcpConnection::writeFrame(OutboundFrame frame, bool lowPriority)
+{
+    if (m_closing || m_closed) {
+        return false;
+    }
     if (!tcpSocket) {
         emit toConsole("in client => tcpConnection:\ntcpSocket not instantiated");
         return false;
     }
-    tcpSocket->write(block);
-    bytesWritten += block.size();
-    for (int i = 0; i < 3; i++) {
-        if (tcpSocket->state() != QTcpSocket::UnconnectedState) {
-            if (!tcpSocket->waitForBytesWritten(timeout)) {
-                quint32 connectionDuration = (quint32)(time(NULL) - firstConnection);
-                quint32 timeoutTime = (quint32)time(NULL);
-                emit connectionTimeout(peerAddress, peerPort, localAddress, localPort, timeoutTime, connectionDuration);
-                this->deleteLater();
-                return false;
-            }
-            return true;
-        } else {
-            delay(100);
+    if (tcpSocket->state() == QTcpSocket::UnconnectedState) {
+        if (verbose > 1) {
+            emit toConsole("tcp unconnected state on write, closing connection");
+        }
+        finishClose();
+        return false;
+    }
+    if (checkWriteStall()) {
+        return false;
+    }
+    const qint64 pending { backlog() };
+    if (lowPriority && pending >= static_cast<qint64>(MuonPi::Config::Tcp::high_water_mark)) {
+        // histograms recover through the version check of the receiver, gpio events are only indicators
+        m_droppedMessages++;
+        m_droppedBytes += frame.size();
+        return false;
+    }
+    if (pending == 0) {
+        m_writeProgress.restart();
+    }
+    m_queuedBytes += frame.size();
+    m_writeQueue.push_back(std::move(frame));
+    drainWriteQueue();
+    return true;
+}
+
+void TcpConnection::drainWriteQueue()
+{
+    while (!m_writeQueue.empty() && tcpSocket->bytesToWrite() < static_cast<qint64>(MuonPi::Config::Tcp::socket_buffer_size)) {
+        const OutboundFrame& frame { m_writeQueue.front() };
+        if (tcpSocket->write(frame.header) != frame.header.size() || tcpSocket->write(frame.data) != frame.data.size()) {
+            // the frame may be written partially, the stream can not be continued
+            emit error(tcpSocket->error(), tcpSocket->errorString());
+            finishClose();
+            return;
         }
+        m_queuedBytes -= frame.size();
+        bytesWritten += frame.size();
+        m_writeQueue.pop_front();
+    }
+    if (m_closing && m_writeQueue.empty() && tcpSocket->state() == QTcpSocket::ConnectedState) {
+        tcpSocket->disconnectFromHost();
+    }
+}
+
+void TcpConnection::onBytesWritten(qint64)
+{
+    m_writeProgress.restart();
+    drainWriteQueue();
+}
+
+bool TcpConnection::checkWriteStall()
+{
+    // the peer did not take any data for longer than the timeout, while there is data waiting
+    if (!m_writeProgress.isValid() || backlog() == 0 || m_writeProgress.elapsed() < timeout) {
+        return false;
     }
-    if (verbose > 1) {
-        emit toConsole("tcp unconnected state before wait for bytes written, closing connection");
+    m_writeProgress.invalidate();
+    if (!m_statusTimer.isNull()) {
+        m_statusTimer->stop();
     }
-    this->thread()->quit();
-    return false;
+    quint32 connectionDuration = (quint32)(time(NULL) - firstConnection);
+    quint32 timeoutTime = (quint32)time(NULL);
+    emit connectionTimeout(peerAddress, peerPort, localAddress, localPort, timeoutTime, connectionDuration);
+    this->deleteLater();
+    return true;
+}
+
+void TcpConnection::startStatusTimer(bool reportStatus)
+{
+    m_reportStatus = reportStatus;
+    m_statusTimer = new QTimer(this);
+    connect(m_statusTimer, &QTimer::timeout, this, &TcpConnection::onStatusTimer);
+    m_statusTimer->start(MuonPi::Config::Tcp::status_interval);
 }
 
-void TcpConnection::delay(int millisecondsWait)
+void TcpConnection::onStatusTimer()
 {
-    QEventLoop loop;
-    QTimer delay;
-    delay.connect(&delay, &QTimer::timeout, &loop, &QEventLoop::quit);
-    delay.start(millisecondsWait);
-    loop.exec();
+    if (checkWriteStall()) {
+        return;
+    }
+    if (!m_reportStatus || !tcpSocket || tcpSocket->state() != QTcpSocket::ConnectedState) {
+        return;
+    }
+    TcpConnectionStatusStruct status {};
+    status.queuedMessages = static_cast<quint32>(m_writeQueue.size());
+    status.queuedBytes = static_cast<quint64>(backlog());
+    status.droppedMessages = m_droppedMessages;
+    status.droppedBytes = m_droppedBytes;
+    status.highWaterMark = MuonPi::Config::Tcp::high_water_mark;
+    if (verbose > 3 && m_droppedMessages > 0) {
+        emit toConsole(QString("tcp connection to %1: %2 messages queued (%3 bytes), %4 low priority messages dropped")
+                           .arg(peerAddress)
+                           .arg(status.queuedMessages)
+                           .arg(status.queuedBytes)
+                           .arg(status.droppedMessages));
+    }
+    TcpMessage statusMessage(TCP_MSG_KEY::MSG_CONNECTION_STATUS);
+    statusMessage.stream() << status;
+    sendTcpMessage(statusMessage);
 }
@@ -1,55 +1,76 @@
 #include "tcpmessage.h"
-#include "muondetector_structs.h"
 
-#include <QDebug>
+#include <QtEndian>
 
 TcpMessage::TcpMessage(quint16 tcpMsgID)
+    : m_data(header_size, Qt::Uninitialized)
+    , m_msgID { tcpMsgID }
 {
-    m_msgID = tcpMsgID;
-    dStream = new QDataStream(&m_data, QIODevice::ReadWrite);
-    m_byteCount = 0;
-    *dStream << static_cast<quint16>(0);
-    *dStream << tcpMsgID;
+    qToBigEndian(tcpMsgID, reinterpret_cast<uchar*>(m_data.data()));
 }
 
-TcpMessage::TcpMessage(QByteArray& rawdata)
-    : m_data { rawdata }
+TcpMessage::TcpMessage(TCP_MSG_KEY tcpMsgID)
+    : TcpMessage { static_cast<quint16>(tcpMsgID) }
 {
-    dStream = new QDataStream(&m_data, QIODevice::ReadWrite);
-    *dStream >> m_byteCount;
-    *dStream >> m_msgID;
 }
 
-TcpMessage::TcpMessage(TCP_MSG_KEY tcpMsgID)
-    : TcpMessage { static_cast<quint16>(tcpMsgID) }
+TcpMessage::TcpMessage(const QByteArray& frame)
+    : m_data { frame }
+    , m_received { true }
 {
+    if (m_data.size() >= header_size) {
+        m_msgID = qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(m_data.constData()));
+    }
 }
 
-TcpMessage::~TcpMessage()
+TcpMessage::TcpMessage(const TcpMessage& other)
+    : m_data { other.m_data }
+    , m_msgID { other.m_msgID }
+    , m_received { other.m_received }
 {
-    delete dStream;
-    dStream = nullptr;
 }
 
-TcpMessage::TcpMessage(const TcpMessage& tcpMessage)
+TcpMessage::TcpMessage(TcpMessage&& other) noexcept
+    : m_data { std::move(other.m_data) }
+    , m_msgID { other.m_msgID }
+    , m_received { other.m_received }
 {
-    m_msgID = tcpMessage.getMsgID();
-    m_data = tcpMessage.getData();
-    dStream = new QDataStream(&m_data, QIODevice::ReadWrite);
-    quint16 temp;
-    *dStream >> temp;
-    *dStream >> temp;
-    m_byteCount = tcpMessage.getByteCount();
+    // the stream of the other message points to its (now empty) data
+    other.m_stream.reset();
 }
 
-void TcpMessage::setData(QByteArray& rawData)
+TcpMessage& TcpMessage::operator=(const TcpMessage& other)
 {
-    m_data = rawData;
+    if (this != &other) {
+        m_stream.reset();
+        m_data = other.m_data;
+        m_msgID = other.m_msgID;
+        m_received = other.m_received;
+    }
+    return *this;
 }
 
-void TcpMessage::setMsgID(quint16 tcpMsgID)
+TcpMessage& TcpMessage::operator=(TcpMessage&& other) noexcept
+{
+    if (this != &other) {
+        m_stream.reset();
+        other.m_stream.reset();
+        m_data = std::move(other.m_data);
+        m_msgID = other.m_msgID;
+        m_received = other.m_received;
+    }
+    return *this;
+}
+
+TcpMessage::~TcpMessage() = default;
+
+QDataStream& TcpMessage::stream()
 {
-    m_msgID = tcpMsgID;
+    if (!m_stream) {
+        m_stream.emplace(&m_data, QIODevice::ReadWrite);
+        m_stream->device()->seek((m_received) ? header_size : m_data.size());
+    }
+    return *m_stream;
 }
 
 const QByteArray& TcpMessage::getData() const
@@ -62,7 +83,16 @@ quint16 TcpMessage::getMsgID() const
     return m_msgID;
 }
 
-quint16 TcpMessage::getByteCount() const
+QByteArray TcpMessage::frameHeader() const
 {
-    return m_byteCount;
+    const auto size { static_cast<quint32>(m_data.size()) };
+    if (size < extended_length) {
+        QByteArray header(sizeof(quint16), Qt::Uninitialized);
+        qToBigEndian(static_cast<quint16>(size), reinterpret_cast<uchar*>(header.data()));
+        return header;
+    }
+    QByteArray header(sizeof(quint16) + sizeof(quint32), Qt::Uninitialized);
+    qToBigEndian(extended_length, reinterpret_cast<uchar*>(header.data()));
+    qToBigEndian(size, reinterpret_cast<uchar*>(header.data() + sizeof(quint16)));
+    return header;
 }
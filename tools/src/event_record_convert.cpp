@@ -0,0 +1,69 @@
+// converts binary event record data files written by the muondetector-daemon
+// into the text columns of the former data file format
+#include <event_record.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static void usage(const char* name)
+{
+    std::cerr << "usage: " << name << " <data file> [<data file> ...]\n"
+              << "prints the event records of binary muondetector data files as text to stdout\n";
+}
+
+static bool convertFile(const char* fileName, std::ostream& out)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) {
+        std::cerr << "could not open " << fileName << "\n";
+        return false;
+    }
+    char header[MuonPi::EventRecord::file_header_size];
+    if (!in.read(header, sizeof(header))) {
+        std::cerr << fileName << ": file too short for a file header\n";
+        return false;
+    }
+    const std::uint16_t version { MuonPi::EventRecord::checkFileHeader(header) };
+    if (version == 0) {
+        std::cerr << fileName << ": not an event record file\n";
+        return false;
+    }
+    if (version > MuonPi::EventRecord::format_version) {
+        std::cerr << fileName << ": unsupported format version " << version << "\n";
+        return false;
+    }
+    std::size_t recordSize { static_cast<std::uint8_t>(header[10]) | (static_cast<std::size_t>(static_cast<std::uint8_t>(header[11])) << 8) };
+    if (recordSize < MuonPi::EventRecord::size) {
+        std::cerr << fileName << ": invalid record size " << recordSize << "\n";
+        return false;
+    }
+    std::vector<char> record(recordSize);
+    std::size_t count { 0 };
+    while (in.read(record.data(), recordSize)) {
+        out << MuonPi::EventRecord::deserialize(record.data()).toText() << "\n";
+        count++;
+    }
+    if (in.gcount() > 0) {
+        std::cerr << fileName << ": ignoring truncated record at the end of the file after " << count << " records\n";
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    std::ios::sync_with_stdio(false);
+    std::cout << MuonPi::EventRecord::text_header << "\n";
+    int result { 0 };
+    for (int i = 1; i < argc; i++) {
+        if (!convertFile(argv[i], std::cout)) {
+            result = 1;
+        }
+    }
+    return result;
+}